@@ -0,0 +1,80 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+/*
+ * Declaration of an arena allocator. Memory is carved sequentially from
+ * large blocks, so an allocation is a pointer bump and carries no
+ * per-allocation header. Allocations cannot be freed one by one; all
+ * memory of an arena is released together by arena_kill.
+ *
+ * An arena suits many small objects that share a lifetime, e.g. the
+ * keys and values of a table that is built once and killed as a whole.
+ * Memory given back to the arena's user is aligned for any type.
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first version.
+ *   2026-10-16: v1.1, added arena_memory_usage().
+ */
+
+// ==========PUBLIC DATA TYPES============
+// Arena type.
+typedef struct arena arena;
+
+// ==========DATA STRUCTURE INTERFACE==========
+
+/**
+ * arena_empty() - Create an empty arena.
+ *
+ * No block is allocated until the first allocation.
+ *
+ * Return: Pointer to a new arena, or NULL if not enough memory was
+ * available.
+ */
+arena *arena_empty(void);
+
+/**
+ * arena_alloc() - Allocate memory from an arena.
+ * @a: Arena to allocate from.
+ * @size: Number of bytes to allocate.
+ *
+ * The memory is not initialized. It stays valid until the arena is
+ * killed and must not be passed to free().
+ *
+ * Return: Pointer to the memory, or NULL if not enough memory was
+ * available.
+ */
+void *arena_alloc(arena *a, size_t size);
+
+/**
+ * arena_copy() - Copy memory into an arena.
+ * @a: Arena to allocate from.
+ * @src: Memory to copy.
+ * @size: Number of bytes to copy.
+ *
+ * Return: Pointer to the copy, or NULL if not enough memory was
+ * available.
+ */
+void *arena_copy(arena *a, const void *src, size_t size);
+
+/**
+ * arena_memory_usage() - Get the memory used by an arena.
+ * @a: Arena to inspect.
+ *
+ * Return: The number of bytes allocated by the arena, i.e. its blocks,
+ * including the space not handed out yet, and the arena itself.
+ */
+size_t arena_memory_usage(const arena *a);
+
+/**
+ * arena_kill() - Destroy an arena.
+ * @a: Arena to destroy.
+ *
+ * Release all memory allocated from the arena, and the arena itself.
+ *
+ * Returns: Nothing.
+ */
+void arena_kill(arena *a);
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef EPOCH_H
+#define EPOCH_H
+
+#include "util.h"
+
+/*
+ * Declaration of epoch-based memory reclamation for lock-free data
+ * structures.
+ *
+ * A reader that follows shared pointers does so inside a critical
+ * section, between epoch_enter and epoch_exit. A writer that unlinks
+ * an object from a shared structure passes it to epoch_retire instead
+ * of freeing it. The object is freed later, once every thread that was
+ * inside a critical section at the time of the unlink has left it, so
+ * a reader never sees freed memory.
+ *
+ * Each thread that uses a domain registers once and gets an
+ * epoch_thread handle, which only that thread may use. Critical
+ * sections may be nested. Entering and leaving a critical section is
+ * wait-free.
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first version.
+ */
+
+// ==========PUBLIC DATA TYPES============
+// Reclamation domain, shared by all threads of a data structure.
+typedef struct epoch_domain epoch_domain;
+
+// Per-thread handle of a domain.
+typedef struct epoch_thread epoch_thread;
+
+// ==========DATA STRUCTURE INTERFACE==========
+
+/**
+ * epoch_domain_empty() - Create a reclamation domain.
+ *
+ * Return: Pointer to a new domain, or NULL if not enough memory was
+ * available.
+ */
+epoch_domain *epoch_domain_empty(void);
+
+/**
+ * epoch_register() - Register the calling thread with a domain.
+ * @d: Domain to register with.
+ *
+ * Return: Handle for the calling thread, or NULL if not enough memory
+ * was available.
+ */
+epoch_thread *epoch_register(epoch_domain *d);
+
+/**
+ * epoch_unregister() - Unregister a thread from its domain.
+ * @th: Handle of the calling thread, not inside a critical section.
+ *
+ * Objects retired by the thread that cannot be freed yet are kept
+ * until the handle is reused by a later epoch_register or the domain
+ * is killed.
+ *
+ * Returns: Nothing.
+ */
+void epoch_unregister(epoch_thread *th);
+
+/**
+ * epoch_enter() - Enter a critical section.
+ * @th: Handle of the calling thread.
+ *
+ * No object that is reachable from a shared structure when the
+ * critical section is entered is freed before it is left.
+ *
+ * Returns: Nothing.
+ */
+void epoch_enter(epoch_thread *th);
+
+/**
+ * epoch_exit() - Leave a critical section.
+ * @th: Handle of the calling thread.
+ *
+ * Returns: Nothing.
+ */
+void epoch_exit(epoch_thread *th);
+
+/**
+ * epoch_retire() - Free an object when no reader can see it anymore.
+ * @th: Handle of the calling thread.
+ * @p: Object that has been unlinked from all shared structures.
+ * @free_func: Function to be called to free p.
+ *
+ * Returns: Nothing.
+ */
+void epoch_retire(epoch_thread *th, void *p, free_function free_func);
+
+/**
+ * epoch_domain_kill() - Destroy a reclamation domain.
+ * @d: Domain to destroy.
+ *
+ * Frees all retired objects and all thread handles. No thread may
+ * use the domain during or after the call.
+ *
+ * Returns: Nothing.
+ */
+void epoch_domain_kill(epoch_domain *d);
+
+#endif
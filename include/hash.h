@@ -0,0 +1,112 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "util.h"
+
+/*
+ * Declaration of built-in hash functions for common key types, to be
+ * registered as the hash_function of a hashed table, e.g.
+ *
+ *	table_empty_with_hash(key_cmp, hash_string, free, free);
+ *
+ * The hashes are well mixed: every bit of the result depends on every
+ * bit of the key. Keys are combined with 64x64->128-bit multiplies
+ * whose halves are folded together, in the style of wyhash. The values
+ * depend on the byte order of the machine and are not meant to be
+ * stored.
+ *
+ * Each hash function has a batch variant that hashes n keys at once.
+ * A batch avoids an indirect call per key, and the multiplies of
+ * different keys are independent, so they overlap in the pipeline. The
+ * hashed tables use the batch variant on their own for their batch
+ * operations when the registered function is one of the built-ins, see
+ * hash_batch_for().
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first version.
+ */
+
+// ==========PUBLIC DATA TYPES============
+// Type definition for a batch hash function: hashes[i] is set to the
+// hash of keys[i] for i in [0, n-1].
+typedef void hash_batch_function(void **keys, int n, uint64_t *hashes);
+
+// ==========HASH FUNCTIONS==========
+
+/**
+ * hash_int() - Hash an int via a pointer.
+ * @ip: Pointer to the int to be hashed.
+ *
+ * Return: The hash of the int value.
+ */
+uint64_t hash_int(const void *ip);
+
+/**
+ * hash_ptr() - Hash a pointer value.
+ * @p: The pointer to be hashed, which is not dereferenced.
+ *
+ * For keys that are compared by address.
+ *
+ * Return: The hash of the address.
+ */
+uint64_t hash_ptr(const void *p);
+
+/**
+ * hash_string() - Hash a NUL-terminated string.
+ * @s: Pointer to the string to be hashed.
+ *
+ * Return: The hash of the bytes of the string, as hash_bytes().
+ */
+uint64_t hash_string(const void *s);
+
+/**
+ * hash_bytes() - Hash a block of memory.
+ * @p: Pointer to the bytes to be hashed.
+ * @n: Number of bytes.
+ *
+ * Return: The hash of the n bytes.
+ */
+uint64_t hash_bytes(const void *p, size_t n);
+
+/**
+ * hash_int_batch() - Hash a number of ints via pointers.
+ * @keys: Array of n pointers to ints.
+ * @n: Number of keys.
+ * @hashes: Set to the hash_int() of each key.
+ *
+ * Returns: Nothing.
+ */
+void hash_int_batch(void **keys, int n, uint64_t *hashes);
+
+/**
+ * hash_ptr_batch() - Hash a number of pointer values.
+ * @keys: Array of n pointers, which are not dereferenced.
+ * @n: Number of keys.
+ * @hashes: Set to the hash_ptr() of each key.
+ *
+ * Returns: Nothing.
+ */
+void hash_ptr_batch(void **keys, int n, uint64_t *hashes);
+
+/**
+ * hash_string_batch() - Hash a number of NUL-terminated strings.
+ * @keys: Array of n strings.
+ * @n: Number of keys.
+ * @hashes: Set to the hash_string() of each key.
+ *
+ * Returns: Nothing.
+ */
+void hash_string_batch(void **keys, int n, uint64_t *hashes);
+
+/**
+ * hash_batch_for() - Get the batch variant of a hash function.
+ * @f: A hash function, or NULL.
+ *
+ * Return: The batch variant of f if f is one of the built-in hash
+ * functions, or NULL otherwise.
+ */
+hash_batch_function *hash_batch_for(hash_function *f);
+
+#endif
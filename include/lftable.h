@@ -0,0 +1,144 @@
+#ifndef LFTABLE_H
+#define LFTABLE_H
+
+#include <stdbool.h>
+#include "util.h"
+#include "epoch.h"
+
+/*
+ * Declaration of a lock-free table for read-dominated concurrent use.
+ * Lookups are wait-free, inserts and removes are lock-free. Replaced
+ * and removed values are passed to the value free_function only when
+ * no thread can still be reading them, using the epoch-based
+ * reclamation in epoch.h.
+ *
+ * Each thread that uses a table calls lftable_attach once to get an
+ * epoch_thread handle, and passes it to every operation. A value
+ * returned by lftable_lookup may be freed by another thread as soon
+ * as the lookup returns. To keep using it, call epoch_enter with the
+ * handle before the lookup and epoch_exit when done with the value.
+ *
+ * The capacity is fixed when the table is created and bounds the
+ * number of distinct keys that may ever be inserted, including keys
+ * that have been removed since. A key keeps its place in the table
+ * after it is removed, and that place is never given to another key,
+ * so removing and inserting the same key again does not use up
+ * capacity, but every new key does. The table thus suits a key set
+ * that is known up front, not churn, where new keys keep replacing
+ * removed ones; use shardtable.h for that. The first key pointer
+ * inserted for a key is kept until lftable_kill; when an equal key is
+ * inserted later, that key is free'd at once instead. Values must not
+ * be NULL.
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first version.
+ *   2026-10-16: v1.1, the bound on distinct keys is part of the
+ *               contract of lftable_empty and lftable_insert.
+ */
+
+// ==========PUBLIC DATA TYPES============
+// Lock-free table type.
+typedef struct lftable lftable;
+
+// ==========DATA STRUCTURE INTERFACE==========
+
+/**
+ * lftable_empty() - Create an empty lock-free table.
+ * @max_keys: Largest number of distinct keys that may ever be inserted,
+ *	      counting removed keys.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: A pointer to a function to be used to hash keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Return: Pointer to a new table, or NULL if not enough memory was
+ * available.
+ */
+lftable *lftable_empty(int max_keys,
+		       compare_function key_cmp_func,
+		       hash_function key_hash_func,
+		       free_function key_free_func,
+		       free_function value_free_func);
+
+/**
+ * lftable_attach() - Register the calling thread with a table.
+ * @t: Table that the thread will use.
+ *
+ * Return: Handle for the calling thread, or NULL if not enough memory
+ * was available.
+ */
+epoch_thread *lftable_attach(lftable *t);
+
+/**
+ * lftable_detach() - Unregister a thread from a table.
+ * @th: Handle returned by lftable_attach().
+ *
+ * Returns: Nothing.
+ */
+void lftable_detach(epoch_thread *th);
+
+/**
+ * lftable_insert() - Add a key/value pair to a table.
+ * @t: Table to manipulate.
+ * @th: Handle of the calling thread.
+ * @key: A pointer to the key value.
+ * @value: A pointer to the value value, not NULL.
+ *
+ * If the key is already in the table, its value is replaced and the
+ * old value is free'd when no reader can see it anymore.
+ *
+ * Return: True if the pair was inserted, false if the table is full,
+ * which cannot happen before max_keys distinct keys have been inserted
+ * since the table was created, whether or not they were removed again.
+ * A key that was inserted before can always be inserted again. The
+ * caller keeps the key and value if false is returned.
+ */
+bool lftable_insert(lftable *t, epoch_thread *th, void *key, void *value);
+
+/**
+ * lftable_lookup() - Look up a given key in a table.
+ * @t: Table to inspect.
+ * @th: Handle of the calling thread.
+ * @key: Key to look up.
+ *
+ * Return: The value corresponding to a given key, or NULL if the key
+ * is not found in the table.
+ */
+void *lftable_lookup(lftable *t, epoch_thread *th, const void *key);
+
+/**
+ * lftable_remove() - Remove a key/value pair in the table.
+ * @t: Table to manipulate.
+ * @th: Handle of the calling thread.
+ * @key: Key for which to remove pair.
+ *
+ * The value is free'd when no reader can see it anymore. Does nothing
+ * if key is not found in the table.
+ *
+ * Returns: Nothing.
+ */
+void lftable_remove(lftable *t, epoch_thread *th, const void *key);
+
+/**
+ * lftable_is_empty() - Check if a table is empty.
+ * @t: Table to check.
+ *
+ * Return: True if table contains no key/value pairs, false otherwise.
+ */
+bool lftable_is_empty(lftable *t);
+
+/**
+ * lftable_kill() - Destroy a table.
+ * @t: Table to destroy.
+ *
+ * Return all dynamic memory used by the table, its keys and values,
+ * and all thread handles. No thread may use the table during or after
+ * the call.
+ *
+ * Returns: Nothing.
+ */
+void lftable_kill(lftable *t);
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef PERFCOUNT_H
+#define PERFCOUNT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Declaration of hardware performance counters for benchmarks. The
+ * counters are read with the Linux perf_event_open system call and
+ * count the calling thread in user space only.
+ *
+ * Counters may be unavailable, e.g. on other systems, in containers
+ * and virtual machines without a PMU, or when
+ * /proc/sys/kernel/perf_event_paranoid forbids them. Each event is
+ * opened on its own, so the events that are available are counted
+ * even if others are not, and a set without any available event can
+ * still be started and stopped.
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first version.
+ */
+
+// ==========PUBLIC DATA TYPES============
+// Counter set type.
+typedef struct perfcount perfcount;
+
+// Counted events.
+typedef enum perfcount_event {
+	PERFCOUNT_CYCLES,	 // CPU cycles.
+	PERFCOUNT_INSTRUCTIONS,	 // Instructions retired.
+	PERFCOUNT_CACHE_MISSES,	 // Last level cache misses.
+	PERFCOUNT_BRANCH_MISSES, // Mispredicted branches.
+	PERFCOUNT_EVENTS,	 // Number of events.
+} perfcount_event;
+
+// ==========DATA STRUCTURE INTERFACE==========
+
+/**
+ * perfcount_empty() - Open a set of counters for the calling thread.
+ *
+ * Return: Pointer to a new counter set, or NULL if not enough memory
+ * was available. The set is returned even if no event is available.
+ */
+perfcount *perfcount_empty(void);
+
+/**
+ * perfcount_available() - Check if an event is counted.
+ * @p: Counter set to inspect.
+ * @event: Event to check.
+ *
+ * Return: True if the event could be opened, false otherwise.
+ */
+bool perfcount_available(const perfcount *p, perfcount_event event);
+
+/**
+ * perfcount_error() - Get the reason why events are unavailable.
+ * @p: Counter set to inspect.
+ *
+ * Return: The errno of the first event that could not be opened, or 0
+ * if all events are available.
+ */
+int perfcount_error(const perfcount *p);
+
+/**
+ * perfcount_event_name() - Get the name of an event.
+ * @event: Event to name.
+ *
+ * Return: A short name, e.g. "cycles".
+ */
+const char *perfcount_event_name(perfcount_event event);
+
+/**
+ * perfcount_start() - Reset the counters and start counting.
+ * @p: Counter set to start.
+ *
+ * Returns: Nothing.
+ */
+void perfcount_start(perfcount *p);
+
+/**
+ * perfcount_stop() - Stop counting and read the counters.
+ * @p: Counter set to stop.
+ * @counts: Set to the count of each event since perfcount_start(),
+ *	    indexed by perfcount_event. Counts are scaled up if the
+ *	    kernel multiplexed the event, and are 0 for unavailable
+ *	    events.
+ *
+ * Returns: Nothing.
+ */
+void perfcount_stop(perfcount *p, uint64_t counts[PERFCOUNT_EVENTS]);
+
+/**
+ * perfcount_kill() - Close a counter set.
+ * @p: Counter set to close.
+ *
+ * Returns: Nothing.
+ */
+void perfcount_kill(perfcount *p);
+
+#endif
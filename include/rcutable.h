@@ -0,0 +1,128 @@
+#ifndef RCUTABLE_H
+#define RCUTABLE_H
+
+#include <stdbool.h>
+#include "util.h"
+#include "epoch.h"
+
+/*
+ * Declaration of a read-copy-update table for one writer thread and
+ * any number of reader threads. Readers take no locks and write to no
+ * memory shared with other threads, so lookups scale with the number
+ * of readers. The writer publishes every change with a single pointer
+ * store, and replaced or removed pairs are free'd only when no reader
+ * can still see them, using the epoch-based reclamation in epoch.h.
+ *
+ * Each thread, readers and the writer alike, calls rcutable_attach
+ * once to get an epoch_thread handle and passes it to every
+ * operation. rcutable_insert and rcutable_remove must only be called
+ * from one thread at a time. A value returned by rcutable_lookup may
+ * be freed as soon as the lookup returns; to keep using it, call
+ * epoch_enter with the handle before the lookup and epoch_exit when
+ * done with the value.
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first version.
+ */
+
+// ==========PUBLIC DATA TYPES============
+// Read-copy-update table type.
+typedef struct rcutable rcutable;
+
+// ==========DATA STRUCTURE INTERFACE==========
+
+/**
+ * rcutable_empty() - Create an empty read-copy-update table.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: A pointer to a function to be used to hash keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Return: Pointer to a new table, or NULL if not enough memory was
+ * available.
+ */
+rcutable *rcutable_empty(compare_function key_cmp_func,
+			 hash_function key_hash_func,
+			 free_function key_free_func,
+			 free_function value_free_func);
+
+/**
+ * rcutable_attach() - Register the calling thread with a table.
+ * @t: Table that the thread will use.
+ *
+ * Return: Handle for the calling thread, or NULL if not enough memory
+ * was available.
+ */
+epoch_thread *rcutable_attach(rcutable *t);
+
+/**
+ * rcutable_detach() - Unregister a thread from a table.
+ * @th: Handle returned by rcutable_attach().
+ *
+ * Returns: Nothing.
+ */
+void rcutable_detach(epoch_thread *th);
+
+/**
+ * rcutable_insert() - Add a key/value pair to a table.
+ * @t: Table to manipulate.
+ * @th: Handle of the calling thread, which must be the only writer.
+ * @key: A pointer to the key value.
+ * @value: A pointer to the value value.
+ *
+ * If the key is already in the table, the old pair is replaced and
+ * free'd when no reader can see it anymore.
+ *
+ * Returns: Nothing.
+ */
+void rcutable_insert(rcutable *t, epoch_thread *th, void *key, void *value);
+
+/**
+ * rcutable_lookup() - Look up a given key in a table.
+ * @t: Table to inspect.
+ * @th: Handle of the calling thread.
+ * @key: Key to look up.
+ *
+ * Return: The value corresponding to a given key, or NULL if the key
+ * is not found in the table.
+ */
+void *rcutable_lookup(rcutable *t, epoch_thread *th, const void *key);
+
+/**
+ * rcutable_remove() - Remove a key/value pair in the table.
+ * @t: Table to manipulate.
+ * @th: Handle of the calling thread, which must be the only writer.
+ * @key: Key for which to remove pair.
+ *
+ * The pair is free'd when no reader can see it anymore. Does nothing
+ * if key is not found in the table.
+ *
+ * Returns: Nothing.
+ */
+void rcutable_remove(rcutable *t, epoch_thread *th, const void *key);
+
+/**
+ * rcutable_is_empty() - Check if a table is empty.
+ * @t: Table to check.
+ *
+ * May only be called by the writer.
+ *
+ * Return: True if table contains no key/value pairs, false otherwise.
+ */
+bool rcutable_is_empty(const rcutable *t);
+
+/**
+ * rcutable_kill() - Destroy a table.
+ * @t: Table to destroy.
+ *
+ * Return all dynamic memory used by the table, its keys and values,
+ * and all thread handles. No thread may use the table during or after
+ * the call.
+ *
+ * Returns: Nothing.
+ */
+void rcutable_kill(rcutable *t);
+
+#endif
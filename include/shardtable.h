@@ -0,0 +1,113 @@
+#ifndef SHARDTABLE_H
+#define SHARDTABLE_H
+
+#include <stdbool.h>
+#include "util.h"
+
+/*
+ * Declaration of a thread-safe table. The pairs are spread over a
+ * number of independent tables from table.h, called shards, and the
+ * shard of a key is chosen from its hash value. Each shard is guarded
+ * by its own read-write lock, so threads that use different shards
+ * never wait for each other and lookups in the same shard run in
+ * parallel.
+ *
+ * All functions may be called concurrently from any number of
+ * threads, except shardtable_kill. A value returned by
+ * shardtable_lookup stays owned by the table, so if another thread
+ * may remove or replace the pair while the value is used, the table
+ * should be created without a value free_function.
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first version.
+ *   2026-10-16: v1.1, shardtable_insert() reports a failed allocation.
+ */
+
+// ==========PUBLIC DATA TYPES============
+// Sharded table type.
+typedef struct shardtable shardtable;
+
+// ==========DATA STRUCTURE INTERFACE==========
+
+/**
+ * shardtable_empty() - Create an empty sharded table.
+ * @shards: Number of shards, rounded up to a power of two. A few times
+ *	    the number of threads is a good choice.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: A pointer to a function to be used to hash keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Keys that are equal according to key_cmp_func must have the same
+ * hash value.
+ *
+ * Return: Pointer to a new table, or NULL if not enough memory was
+ * available.
+ */
+shardtable *shardtable_empty(int shards,
+			     compare_function key_cmp_func,
+			     hash_function key_hash_func,
+			     free_function key_free_func,
+			     free_function value_free_func);
+
+/**
+ * shardtable_is_empty() - Check if a table is empty.
+ * @t: Table to check.
+ *
+ * The shards are checked one at a time, so the result may be out of
+ * date if other threads modify the table at the same time.
+ *
+ * Return: True if table contains no key/value pairs, false otherwise.
+ */
+bool shardtable_is_empty(shardtable *t);
+
+/**
+ * shardtable_insert() - Add a key/value pair to a table.
+ * @t: Table to manipulate.
+ * @key: A pointer to the key value.
+ * @value: A pointer to the value value.
+ *
+ * Insert the key/value pair into the table, as table_insert().
+ *
+ * Return: True if the pair was inserted, false if not enough memory was
+ * available, as table_insert().
+ */
+bool shardtable_insert(shardtable *t, void *key, void *value);
+
+/**
+ * shardtable_lookup() - Look up a given key in a table.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ *
+ * Return: The value corresponding to a given key, or NULL if the key
+ * is not found in the table.
+ */
+void *shardtable_lookup(shardtable *t, const void *key);
+
+/**
+ * shardtable_remove() - Remove a key/value pair in the table.
+ * @t: Table to manipulate.
+ * @key: Key for which to remove pair.
+ *
+ * Will call any free functions set for keys/values. Does nothing if
+ * key is not found in the table.
+ *
+ * Returns: Nothing.
+ */
+void shardtable_remove(shardtable *t, const void *key);
+
+/**
+ * shardtable_kill() - Destroy a table.
+ * @t: Table to destroy.
+ *
+ * Return all dynamic memory used by the table and its elements, as
+ * table_kill(). No other thread may use the table during or after
+ * the call.
+ *
+ * Returns: Nothing.
+ */
+void shardtable_kill(shardtable *t);
+
+#endif
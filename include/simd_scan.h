@@ -0,0 +1,44 @@
+#ifndef __SIMD_SCAN_H
+#define __SIMD_SCAN_H
+
+#include <stdint.h>
+
+/*
+ * Declaration of vectorized search functions for dense arrays of small
+ * integers, used by the table implementations to find candidate
+ * entries without calling a comparison function for every element.
+ *
+ * The functions pick the widest instruction set supported by the CPU
+ * at run time (AVX2 or SSE2 on x86) and fall back to a scalar loop on
+ * other platforms.
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first version.
+ *   2026-10-16: v1.1, added scan_i32().
+ */
+
+/**
+ * scan_u16() - Find the next occurrence of a value in an array.
+ * @a: array to search.
+ * @from: index to start searching at.
+ * @n: number of elements in the array.
+ * @v: value to search for.
+ *
+ * Returns: The smallest index i such that from <= i < n and a[i] == v,
+ * or n if there is no such index.
+ */
+int scan_u16(const uint16_t *a, int from, int n, uint16_t v);
+
+/**
+ * scan_i32() - Find the next occurrence of a value in an array.
+ * @a: array to search.
+ * @from: index to start searching at.
+ * @n: number of elements in the array.
+ * @v: value to search for.
+ *
+ * Returns: The smallest index i such that from <= i < n and a[i] == v,
+ * or n if there is no such index.
+ */
+int scan_i32(const int32_t *a, int from, int n, int32_t v);
+
+#endif
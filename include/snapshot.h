@@ -0,0 +1,132 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdbool.h>
+#include "util.h"
+
+/*
+ * Declaration of a binary snapshot of key/value pairs, the file format
+ * behind table_save() and table_load_mmap().
+ *
+ * The keys and values must be flat, i.e. hold no pointers, so that
+ * their bytes can be written as they are. A size function tells how
+ * many bytes a key or value has. A loaded snapshot is mapped read-only
+ * into memory, and its keys and values are pointers into the mapping,
+ * so nothing is copied or converted when a snapshot is loaded. Each
+ * key and value starts at an 8-byte boundary of the mapping.
+ *
+ * The file starts with a header holding a magic number, the format
+ * version, the number of pairs and a checksum of the rest of the
+ * file. An array with the file offset of each record follows, and then
+ * the records, sorted by key. The numbers are in the byte order of the
+ * machine that wrote the file, which must match when it is loaded.
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first version.
+ *   2026-10-16: v1.1, snapshot_save() syncs the directory.
+ */
+
+// ==========PUBLIC DATA TYPES============
+// Snapshot type.
+typedef struct snapshot snapshot;
+
+// ==========DATA STRUCTURE INTERFACE==========
+
+/**
+ * snapshot_save() - Write key/value pairs to a snapshot file.
+ * @path: Name of the file to write.
+ * @keys: Array of n keys, all different.
+ * @values: Array of n values, values[i] belongs to keys[i].
+ * @n: Number of pairs.
+ * @key_cmp_func: A pointer to a function used to sort the keys.
+ * @key_size_func: A pointer to a function that returns the number of
+ *		   bytes of a key.
+ * @value_size_func: A pointer to a function that returns the number of
+ *		     bytes of a value. It is not called for NULL values,
+ *		     which are loaded as NULL.
+ *
+ * The snapshot is written to a temporary file next to path, which then
+ * replaces path, so an existing snapshot is never left half written.
+ * The file and its directory are synced before the function returns,
+ * so a saved snapshot survives a crash.
+ *
+ * Return: True if the snapshot was written, false with errno set
+ * otherwise.
+ */
+bool snapshot_save(const char *path, void **keys, void **values, int n,
+		   compare_function *key_cmp_func,
+		   size_function *key_size_func,
+		   size_function *value_size_func);
+
+/**
+ * snapshot_load() - Map a snapshot file into memory.
+ * @path: Name of the file to load.
+ *
+ * The header, the checksum and the bounds of every record are checked.
+ *
+ * Return: Pointer to the mapped snapshot, or NULL with errno set if the
+ * file could not be mapped or is not a valid snapshot, in which case
+ * errno is EINVAL.
+ */
+snapshot *snapshot_load(const char *path);
+
+/**
+ * snapshot_size() - Get the number of pairs of a snapshot.
+ * @s: Snapshot to inspect.
+ *
+ * Return: The number of pairs.
+ */
+int snapshot_size(const snapshot *s);
+
+/**
+ * snapshot_key() - Get a key of a snapshot.
+ * @s: Snapshot to inspect.
+ * @i: Index of the pair, in key order.
+ *
+ * Return: A pointer to the key in the mapping.
+ */
+void *snapshot_key(const snapshot *s, int i);
+
+/**
+ * snapshot_value() - Get a value of a snapshot.
+ * @s: Snapshot to inspect.
+ * @i: Index of the pair, in key order.
+ *
+ * Return: A pointer to the value in the mapping, or NULL if the value
+ * was NULL when it was saved.
+ */
+void *snapshot_value(const snapshot *s, int i);
+
+/**
+ * snapshot_find() - Find a key in a snapshot by binary search.
+ * @s: Snapshot to search.
+ * @key: Key to find.
+ * @key_cmp_func: A pointer to a function that orders the keys as the
+ *		  function given to snapshot_save().
+ * @probes: Set to the number of keys compared.
+ *
+ * Return: The index of the key, or -1 if it is not in the snapshot.
+ */
+int snapshot_find(const snapshot *s, const void *key,
+		  compare_function *key_cmp_func, int *probes);
+
+/**
+ * snapshot_bytes() - Get the size of a snapshot.
+ * @s: Snapshot to inspect.
+ *
+ * Return: The number of bytes mapped, and the size of the structure
+ * describing the mapping.
+ */
+size_t snapshot_bytes(const snapshot *s);
+
+/**
+ * snapshot_kill() - Unmap a snapshot.
+ * @s: Snapshot to unmap.
+ *
+ * The keys and values of the snapshot must not be used afterwards.
+ *
+ * Returns: Nothing.
+ */
+void snapshot_kill(snapshot *s);
+
+#endif
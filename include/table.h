@@ -3,6 +3,8 @@
 
 #include <stdbool.h>
 #include "util.h"
+#include "arena.h"
+#include "threadpool.h"
 
 /*
  * Declaration of a generic table for the "Datastructures and
@@ -28,12 +30,91 @@
  *
  * Version information:
  *   2018-02-06: v1.0, first public version.
+ *   2026-10-16: v1.1, added table_empty_with_hash().
+ *   2026-10-16: v1.2, added table modes and table_insert_batch().
+ *   2026-10-16: v1.3, added self-organizing table modes.
+ *   2026-10-16: v1.4, added table_lookup_batch().
+ *   2026-10-16: v1.5, added table_from_arrays().
+ *   2026-10-16: v1.6, added table_arena().
+ *   2026-10-16: v1.7, added table_foreach() and table iterators.
+ *   2026-10-16: v1.8, added parallel build, lookup and kill.
+ *   2026-10-16: v1.9, added table_get_stats() and table_reset_stats().
+ *   2026-10-16: v1.10, added table_memory_usage() and
+ *		 table_memory_breakdown().
+ *   2026-10-16: v1.11, added table_save() and table_load_mmap().
+ *   2026-10-16: v1.12, table_insert() and table_insert_batch() report a
+ *		 failed allocation.
  */
 
 // ==========PUBLIC DATA TYPES============
 // Table type.
 typedef struct table table;
 
+// Storage modes, selected with table_set_mode(). An implementation
+// may support only some of them.
+typedef enum table_mode {
+	// Entries are kept in no particular order. Default mode.
+	TABLE_MODE_UNORDERED,
+	// Entries are kept sorted by key_cmp_func, so lookups can use
+	// binary search. Suited for read-heavy tables.
+	TABLE_MODE_SORTED,
+	// Self-organizing modes for skewed lookups. A key that is found
+	// by table_lookup() is moved towards the front of the table, so
+	// frequently used keys are found faster. Note that lookups then
+	// modify the table.
+	// Move the found key to the front.
+	TABLE_MODE_MOVE_TO_FRONT,
+	// Swap the found key with the key before it.
+	TABLE_MODE_TRANSPOSE,
+	// Count the lookups of each key and keep the keys ordered by
+	// decreasing count.
+	TABLE_MODE_COUNT,
+} table_mode;
+
+// Cursor over the key/value pairs of a table, see table_iter_begin().
+// The fields are private to the implementation.
+typedef struct table_iter {
+	const table *t;
+	int index;
+} table_iter;
+
+// Number of buckets of the probe length histogram in table_stats.
+#define TABLE_STATS_PROBE_BUCKETS 32
+
+// Operation counts of a table, see table_get_stats(). The probe length
+// of an operation is the number of entries or slots it examined while
+// searching for a key. Bucket 0 of probes counts the searches that
+// examined nothing, bucket b > 0 those that examined 2^(b-1) to 2^b-1.
+typedef struct table_stats {
+	uint64_t inserts;	// Inserts of a key that was not in the table.
+	uint64_t overwrites;	// Inserts that replaced the pair of a key.
+	uint64_t lookups;	// Keys looked up, batches included.
+	uint64_t hits;		// Lookups that found the key.
+	uint64_t misses;	// Lookups that did not find the key.
+	uint64_t removes;	// Pairs removed by table_remove().
+	uint64_t compares;	// Calls of the key compare function.
+	uint64_t allocations;	// Heap allocations made by the table.
+	uint64_t searches;	// Key searches in the probe histogram.
+	uint64_t probe_total;	// Sum of the probe lengths of the searches.
+	uint64_t probes[TABLE_STATS_PROBE_BUCKETS];
+} table_stats;
+
+// Memory used by a table, in bytes, see table_memory_breakdown().
+// The table counts the bytes it requests, not the overhead of the
+// allocator.
+typedef struct table_memory {
+	size_t pairs;		// Number of key/value pairs.
+	size_t table;		// The table structure itself.
+	size_t entries;		// Storage of the pairs in use.
+	size_t index;		// Search data kept beside the pairs in use.
+	size_t slack;		// Storage allocated for pairs not in use.
+	size_t arena;		// The table arena, see table_arena().
+	size_t mapped;		// Snapshot mapped by table_load_mmap().
+	size_t keys;		// Keys, as reported by the key size function.
+	size_t values;		// Values, as reported by the value size function.
+	size_t total;		// Sum of the above, except pairs.
+} table_memory;
+
 // ==========DATA STRUCTURE INTERFACE==========
 
 /**
@@ -44,12 +125,113 @@ typedef struct table table;
  * @value_free_func: A pointer to a function (or NULL) to be called to
  *		     de-allocate memory for values on remove/kill.
  *
- * Return: Pointer to a new table.
+ * Return: Pointer to a new table, or NULL if not enough memory was
+ * available.
  */
 table *table_empty(compare_function key_cmp_func,
 		   free_function key_free_func,
 		   free_function value_free_func);
 
+/**
+ * table_empty_with_hash() - Create an empty table with a key hash function.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: A pointer to a function (or NULL) to be used to hash keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Keys that are equal according to key_cmp_func must have the same
+ * hash value. Hashed implementations use key_hash_func to index the
+ * keys, other implementations may ignore it. A table created by
+ * table_empty() behaves as if key_hash_func was NULL.
+ *
+ * Return: Pointer to a new table, or NULL if not enough memory was
+ * available.
+ */
+table *table_empty_with_hash(compare_function key_cmp_func,
+			     hash_function key_hash_func,
+			     free_function key_free_func,
+			     free_function value_free_func);
+
+/**
+ * table_from_arrays() - Create a table from arrays of keys and values.
+ * @keys: Array of n keys.
+ * @values: Array of n values, values[i] belongs to keys[i].
+ * @n: Number of pairs.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * The result is the same as creating the table with table_empty() and
+ * inserting the pairs in array order, i.e. the last pair wins for
+ * duplicate keys and the replaced pairs are free'd, but the table is
+ * built in one pass instead of n inserts. The table takes ownership
+ * of all keys and values, unless NULL is returned.
+ *
+ * Return: Pointer to a new table, or NULL if not enough memory was
+ * available.
+ */
+table *table_from_arrays(void **keys, void **values, int n,
+			 compare_function key_cmp_func,
+			 free_function key_free_func,
+			 free_function value_free_func);
+
+/**
+ * table_from_arrays_with_hash() - Create a table from arrays of keys
+ * and values with a key hash function.
+ * @keys: Array of n keys.
+ * @values: Array of n values, values[i] belongs to keys[i].
+ * @n: Number of pairs.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: A pointer to a function (or NULL) to be used to hash keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * As table_from_arrays(), for a table created as by
+ * table_empty_with_hash().
+ *
+ * Return: Pointer to a new table, or NULL if not enough memory was
+ * available.
+ */
+table *table_from_arrays_with_hash(void **keys, void **values, int n,
+				   compare_function key_cmp_func,
+				   hash_function key_hash_func,
+				   free_function key_free_func,
+				   free_function value_free_func);
+
+/**
+ * table_from_arrays_parallel() - Create a table from arrays of keys and
+ * values using a thread pool.
+ * @keys: Array of n keys.
+ * @values: Array of n values, values[i] belongs to keys[i].
+ * @n: Number of pairs.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: A pointer to a function (or NULL) to be used to hash keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ * @pool: Thread pool to run the build on, or NULL.
+ *
+ * As table_from_arrays_with_hash(), with the work split over the
+ * threads of the pool. key_cmp_func and key_hash_func are called from
+ * several threads at the same time.
+ *
+ * Return: Pointer to a new table, or NULL if not enough memory was
+ * available.
+ */
+table *table_from_arrays_parallel(void **keys, void **values, int n,
+				  compare_function key_cmp_func,
+				  hash_function key_hash_func,
+				  free_function key_free_func,
+				  free_function value_free_func,
+				  threadpool *pool);
+
 /**
  * table_is_empty() - Check if a table is empty.
  * @t: Table to check.
@@ -69,9 +251,42 @@ bool table_is_empty(const table *t);
  * added value for a duplicate key. table_remove() will remove all
  * duplicates for a given key.
  *
- * Returns: Nothing.
+ * Return: True if the pair was inserted, false if not enough memory was
+ * available. The table is then unchanged, and the key and value still
+ * belong to the caller.
+ */
+bool table_insert(table *t, void *key, void *value);
+
+/**
+ * table_insert_batch() - Add a number of key/value pairs to a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n pointers to key values.
+ * @values: Array of n pointers to value values.
+ * @n: Number of pairs to insert.
+ *
+ * Equivalent to calling table_insert() for each pair in array order,
+ * so for duplicate keys the pair latest in the arrays wins. The
+ * implementation may build its layout for the whole batch at once,
+ * e.g. a sorted table appends the pairs and sorts them once.
+ *
+ * Return: True if the pairs were inserted, false if not enough memory
+ * was available. The table is then unchanged, and none of the keys and
+ * values have been taken over by it.
  */
-void table_insert(table *t, void *key, void *value);
+bool table_insert_batch(table *t, void **keys, void **values, int n);
+
+/**
+ * table_set_mode() - Change the storage mode of a table.
+ * @t: Table to manipulate.
+ * @mode: The new mode.
+ *
+ * The table keeps its contents. Switching a non-empty table to
+ * TABLE_MODE_SORTED sorts it.
+ *
+ * Return: True if the mode was changed, false if the implementation
+ * does not support the mode. The table is unchanged in that case.
+ */
+bool table_set_mode(table *t, table_mode mode);
 
 /**
  * table_lookup() - Look up a given key in a table.
@@ -84,6 +299,40 @@ void table_insert(table *t, void *key, void *value);
  */
 void *table_lookup(const table *t, const void *key);
 
+/**
+ * table_lookup_batch() - Look up a number of keys in a table.
+ * @t: Table to inspect.
+ * @keys: Array of n keys to look up.
+ * @n: Number of keys.
+ * @values: Array of n pointers to be filled with the results.
+ *
+ * Equivalent to setting values[i] = table_lookup(t, keys[i]) for each
+ * i in order, but the implementation may interleave the work for
+ * several keys and prefetch their data, so that the cache misses of
+ * different keys overlap.
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_batch(const table *t, void **keys, int n, void **values);
+
+/**
+ * table_lookup_batch_parallel() - Look up a number of keys in a table
+ * using a thread pool.
+ * @t: Table to inspect.
+ * @keys: Array of n keys to look up.
+ * @n: Number of keys.
+ * @values: Array of n pointers to be filled with the results.
+ * @pool: Thread pool to run the lookups on, or NULL.
+ *
+ * As table_lookup_batch(), with the keys split over the threads of the
+ * pool. The key functions are called from several threads at the same
+ * time, and the table must not be modified during the call.
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_batch_parallel(const table *t, void **keys, int n,
+				 void **values, threadpool *pool);
+
 /**
  * table_remove() - Remove a key/value pair in the table.
  * @t: Table to manipulate.
@@ -97,6 +346,21 @@ void *table_lookup(const table *t, const void *key);
  */
 void table_remove(table *t, const void *key);
 
+/**
+ * table_arena() - Get the memory arena owned by a table.
+ * @t: Table to inspect.
+ *
+ * The arena is created on the first call and is killed together with
+ * the table. Keys and values allocated from it need no free_function
+ * and are released in bulk by table_kill(), so a table that owns only
+ * arena memory should be created with NULL free functions. Memory of
+ * removed or replaced pairs is not reused until the table is killed.
+ *
+ * Return: The arena of the table, or NULL if not enough memory was
+ * available.
+ */
+arena *table_arena(table *t);
+
 /**
  * table_kill() - Destroy a table.
  * @t: Table to destroy.
@@ -104,12 +368,168 @@ void table_remove(table *t, const void *key);
  * Return all dynamic memory used by the table and its elements. If a
  * free_func was registered for keys and/or values at table creation,
  * it is called each element to free any user-allocated memory
- * occupied by the element values.
+ * occupied by the element values. The arena of the table is killed
+ * last, after the free functions have been called.
  *
  * Returns: Nothing.
  */
 void table_kill(table *t);
 
+/**
+ * table_kill_parallel() - Destroy a table using a thread pool.
+ * @t: Table to destroy.
+ * @pool: Thread pool to run the free functions on, or NULL.
+ *
+ * As table_kill(), with the calls of the free functions split over the
+ * threads of the pool. The free functions are called from several
+ * threads at the same time.
+ *
+ * Returns: Nothing.
+ */
+void table_kill_parallel(table *t, threadpool *pool);
+
+/**
+ * table_foreach() - Call a function for each key/value pair in a table.
+ * @t: Table to inspect.
+ * @inspect_func: Function called with the key and value of each pair.
+ *
+ * The pairs are visited in storage order, which depends on the
+ * implementation and the table mode. The key and value pointers are
+ * passed as stored, nothing is copied. The table must not be modified
+ * by inspect_func.
+ *
+ * Returns: Nothing.
+ */
+void table_foreach(const table *t, inspect_callback_pair inspect_func);
+
+/**
+ * table_iter_begin() - Start iterating over a table.
+ * @t: Table to iterate over.
+ * @it: Iterator to initialize.
+ *
+ * After this call, table_iter_next() returns the key/value pairs of
+ * the table in the same order as table_foreach(). The iterator needs
+ * no clean-up. It is invalidated by any insert, remove, or lookup in
+ * a self-organizing mode.
+ *
+ * Returns: Nothing.
+ */
+void table_iter_begin(const table *t, table_iter *it);
+
+/**
+ * table_iter_next() - Get the next key/value pair of an iteration.
+ * @it: Iterator started by table_iter_begin().
+ * @key: Set to the key of the next pair.
+ * @value: Set to the value of the next pair.
+ *
+ * Return: True if a pair was returned, false if all pairs have been
+ * visited. key and value are left unchanged in that case.
+ */
+bool table_iter_next(table_iter *it, void **key, void **value);
+
+/**
+ * table_save() - Write the pairs of a table to a snapshot file.
+ * @t: Table to save.
+ * @path: Name of the file to write.
+ * @key_size_func: A pointer to a function that returns the number of
+ *		   bytes of a key.
+ * @value_size_func: A pointer to a function that returns the number of
+ *		     bytes of a value. It is not called for NULL values.
+ *
+ * The keys and values must be flat, e.g. numbers, strings or structs
+ * without pointers, since their bytes are saved as they are. The pairs
+ * are saved sorted by key_cmp_func with a checksum, in the format of
+ * snapshot.h, so a snapshot saved by one table implementation can be
+ * loaded by another. The file is replaced only when it has been
+ * written completely.
+ *
+ * Return: True if the snapshot was saved, false with errno set
+ * otherwise.
+ */
+bool table_save(const table *t, const char *path,
+		size_function *key_size_func,
+		size_function *value_size_func);
+
+/**
+ * table_load_mmap() - Create a table from a snapshot file.
+ * @path: Name of a file written by table_save().
+ * @key_cmp_func: A pointer to a function to be used to compare keys,
+ *		  which must order the keys as the one of the saved table.
+ * @key_hash_func: A pointer to a function (or NULL) to be used to hash
+ *		   keys, see table_empty_with_hash().
+ *
+ * The file is mapped into memory and the keys and values of the table
+ * point into the mapping, so no pair is copied or converted. The
+ * mapping is read-only: the keys and values must not be written
+ * through, and are valid until the table is killed.
+ *
+ * The table has no free functions. Pairs inserted later are not freed
+ * by the table, so their keys and values are best allocated from the
+ * table arena. Implementations may serve lookups straight from the
+ * mapping until the first change of the table.
+ *
+ * Return: Pointer to a new table, or NULL with errno set if the file
+ * could not be loaded, EINVAL if it is not a valid snapshot.
+ */
+table *table_load_mmap(const char *path, compare_function key_cmp_func,
+		       hash_function key_hash_func);
+
+/**
+ * table_memory_usage() - Get the memory allocated by a table.
+ * @t: Table to inspect.
+ *
+ * Counts the memory of the table itself, of its arena and of a
+ * snapshot it has mapped, but not the keys and values it points to.
+ *
+ * Return: The number of bytes, as table_memory_breakdown() without
+ * size functions.
+ */
+size_t table_memory_usage(const table *t);
+
+/**
+ * table_memory_breakdown() - Get the memory used by a table, by part.
+ * @t: Table to inspect.
+ * @key_size_func: A pointer to a function (or NULL) that returns the
+ *		   bytes owned by a key.
+ * @value_size_func: A pointer to a function (or NULL) that returns the
+ *		     bytes owned by a value.
+ * @mem: Set to the memory used by each part of the table.
+ *
+ * The keys and values are only counted if a size function is given,
+ * which is then called once for each pair. Memory shared by several
+ * pairs, allocated from the table arena, or in a snapshot mapped by
+ * table_load_mmap() should not be reported by the size functions, or
+ * it is counted twice.
+ *
+ * Returns: Nothing.
+ */
+void table_memory_breakdown(const table *t, size_function *key_size_func,
+			    size_function *value_size_func,
+			    table_memory *mem);
+
+/**
+ * table_get_stats() - Get the operation counts of a table.
+ * @t: Table to inspect.
+ * @stats: Set to the counts since the table was created or
+ *	   table_reset_stats() was last called.
+ *
+ * The counts are only kept if the table implementation was compiled
+ * with TABLE_STATS defined. Otherwise the operations do no counting at
+ * all, and stats is set to zero. The counts may be read while no other
+ * thread uses the table.
+ *
+ * Return: True if the counts are kept, false otherwise.
+ */
+bool table_get_stats(const table *t, table_stats *stats);
+
+/**
+ * table_reset_stats() - Set the operation counts of a table to zero.
+ * @t: Table to manipulate.
+ *
+ * Returns: Nothing.
+ */
+void table_reset_stats(table *t);
+
 /**
  * table_print() - Print the given table.
  * @t: Table to print.
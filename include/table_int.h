@@ -0,0 +1,98 @@
+#ifndef TABLE_INT_H
+#define TABLE_INT_H
+
+#include <stdbool.h>
+#include "util.h"
+
+/*
+ * Declaration of a table with int keys. It behaves like the generic
+ * table in table.h, but the keys are stored by value in a contiguous
+ * array and are matched with vector compares, so no key memory is
+ * allocated and no compare function is called.
+ *
+ * The values are void pointers, as in table.h. After use, the function
+ * table_int_kill must be called to de-allocate the dynamic memory used
+ * by the table itself. The de-allocation of any dynamic memory
+ * allocated for the values is the responsibility of the user of the
+ * table, unless a free_function is registered in table_int_empty.
+ *
+ * Inserting a key that is already in the table replaces its value, so
+ * a key is present at most once.
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first version.
+ */
+
+// ==========PUBLIC DATA TYPES============
+// Table type.
+typedef struct table_int table_int;
+
+// ==========DATA STRUCTURE INTERFACE==========
+
+/**
+ * table_int_empty() - Create an empty table with int keys.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Return: Pointer to a new table, or NULL if not enough memory was
+ * available.
+ */
+table_int *table_int_empty(free_function value_free_func);
+
+/**
+ * table_int_is_empty() - Check if a table is empty.
+ * @t: Table to check.
+ *
+ * Return: True if table contains no key/value pairs, false otherwise.
+ */
+bool table_int_is_empty(const table_int *t);
+
+/**
+ * table_int_insert() - Add a key/value pair to a table.
+ * @t: Table to manipulate.
+ * @key: The key.
+ * @value: A pointer to the value value.
+ *
+ * Insert the key/value pair into the table. If the key is already in
+ * the table, its old value is replaced (and free'd if a free function
+ * was registered).
+ *
+ * Returns: Nothing.
+ */
+void table_int_insert(table_int *t, int key, void *value);
+
+/**
+ * table_int_lookup() - Look up a given key in a table.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ *
+ * Return: The value corresponding to a given key, or NULL if the key
+ * is not found in the table.
+ */
+void *table_int_lookup(const table_int *t, int key);
+
+/**
+ * table_int_remove() - Remove a key/value pair in the table.
+ * @t: Table to manipulate.
+ * @key: Key for which to remove pair.
+ *
+ * Will call any free function set for values. Does nothing if key is
+ * not found in the table.
+ *
+ * Returns: Nothing.
+ */
+void table_int_remove(table_int *t, int key);
+
+/**
+ * table_int_kill() - Destroy a table.
+ * @t: Table to destroy.
+ *
+ * Return all dynamic memory used by the table. If a free function was
+ * registered for values at table creation, it is called for each
+ * value.
+ *
+ * Returns: Nothing.
+ */
+void table_int_kill(table_int *t);
+
+#endif
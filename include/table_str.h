@@ -0,0 +1,106 @@
+#ifndef TABLE_STR_H
+#define TABLE_STR_H
+
+#include <stdbool.h>
+#include "util.h"
+
+/*
+ * Declaration of a table with string keys. It behaves like the generic
+ * table in table.h with strcmp as compare function and a string hash
+ * function, but the keys are copied into the table and hashed by it.
+ * A short key is stored inline in its hash slot, next to its length,
+ * so keys are matched or rejected without following a pointer or
+ * calling a compare function. Longer keys keep their length and first
+ * bytes inline, and their full copy is allocated on the heap.
+ *
+ * The values are void pointers, as in table.h. After use, the function
+ * table_str_kill must be called to de-allocate the dynamic memory used
+ * by the table itself, including the key copies. The de-allocation of
+ * any dynamic memory allocated for the values is the responsibility of
+ * the user of the table, unless a free_function is registered in
+ * table_str_empty.
+ *
+ * Inserting a key that is already in the table replaces its value, so
+ * a key is present at most once.
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first version.
+ */
+
+// Longest key, in bytes without the terminating '\0', that is stored
+// inline.
+#define TABLE_STR_INLINE 16
+
+// ==========PUBLIC DATA TYPES============
+// Table type.
+typedef struct table_str table_str;
+
+// ==========DATA STRUCTURE INTERFACE==========
+
+/**
+ * table_str_empty() - Create an empty table with string keys.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Return: Pointer to a new table, or NULL if not enough memory was
+ * available.
+ */
+table_str *table_str_empty(free_function value_free_func);
+
+/**
+ * table_str_is_empty() - Check if a table is empty.
+ * @t: Table to check.
+ *
+ * Return: True if table contains no key/value pairs, false otherwise.
+ */
+bool table_str_is_empty(const table_str *t);
+
+/**
+ * table_str_insert() - Add a key/value pair to a table.
+ * @t: Table to manipulate.
+ * @key: The key, a string that is copied by the table.
+ * @value: A pointer to the value value.
+ *
+ * Insert the key/value pair into the table. If the key is already in
+ * the table, its old value is replaced (and free'd if a free function
+ * was registered).
+ *
+ * Returns: Nothing.
+ */
+void table_str_insert(table_str *t, const char *key, void *value);
+
+/**
+ * table_str_lookup() - Look up a given key in a table.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ *
+ * Return: The value corresponding to a given key, or NULL if the key
+ * is not found in the table.
+ */
+void *table_str_lookup(const table_str *t, const char *key);
+
+/**
+ * table_str_remove() - Remove a key/value pair in the table.
+ * @t: Table to manipulate.
+ * @key: Key for which to remove pair.
+ *
+ * Will call any free function set for values. Does nothing if key is
+ * not found in the table.
+ *
+ * Returns: Nothing.
+ */
+void table_str_remove(table_str *t, const char *key);
+
+/**
+ * table_str_kill() - Destroy a table.
+ * @t: Table to destroy.
+ *
+ * Return all dynamic memory used by the table. If a free function was
+ * registered for values at table creation, it is called for each
+ * value.
+ *
+ * Returns: Nothing.
+ */
+void table_str_kill(table_str *t);
+
+#endif
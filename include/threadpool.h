@@ -0,0 +1,72 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+/*
+ * Declaration of a pool of worker threads for data-parallel loops.
+ *
+ * threadpool_run splits an index range into chunks that the workers
+ * and the calling thread take in turn, and returns when all chunks are
+ * done. A pool runs one loop at a time; calls from several threads are
+ * serialized.
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first version.
+ */
+
+// ==========PUBLIC DATA TYPES============
+// Thread pool type.
+typedef struct threadpool threadpool;
+
+// Type definition for the body of a parallel loop. The function is
+// called with the argument given to threadpool_run and a range
+// [begin, end) of the loop, from any thread of the pool.
+typedef void threadpool_task(void *arg, int begin, int end);
+
+// ==========DATA STRUCTURE INTERFACE==========
+
+/**
+ * threadpool_empty() - Create a thread pool.
+ * @threads: Number of threads that run a loop, including the calling
+ *	     thread, or 0 for one per online CPU.
+ *
+ * Return: Pointer to a new pool, or NULL if the threads could not be
+ * created.
+ */
+threadpool *threadpool_empty(int threads);
+
+/**
+ * threadpool_size() - Get the number of threads of a pool.
+ * @p: Pool to inspect.
+ *
+ * Return: The number of threads that run a loop, including the calling
+ * thread.
+ */
+int threadpool_size(const threadpool *p);
+
+/**
+ * threadpool_run() - Run a parallel loop.
+ * @p: Pool to run the loop on, or NULL to run it in the calling thread.
+ * @task: Body of the loop.
+ * @arg: Argument passed to task.
+ * @n: Number of iterations.
+ * @chunk: Smallest number of iterations given to a thread at a time.
+ *
+ * Calls task for disjoint ranges that together cover [0, n). The
+ * ranges may be processed in any order and at the same time.
+ *
+ * Returns: Nothing, when all ranges are done.
+ */
+void threadpool_run(threadpool *p, threadpool_task *task, void *arg,
+		    int n, int chunk);
+
+/**
+ * threadpool_kill() - Destroy a thread pool.
+ * @p: Pool to destroy.
+ *
+ * Stops and joins all worker threads.
+ *
+ * Returns: Nothing.
+ */
+void threadpool_kill(threadpool *p);
+
+#endif
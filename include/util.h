@@ -1,6 +1,9 @@
 #ifndef __UTIL_H
 #define __UTIL_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 /*
  * Utility function types for deallocating, printing and comparing
  * values stored by various data types.
@@ -13,6 +16,8 @@
  * Version information:
  *   2018-01-28: v1.0, first public version.
  *   2018-02-06: v1.1, updated explanation for the compare_function.
+ *   2026-10-16: v1.2, added the hash_function type.
+ *   2026-10-16: v1.3, added the size_function type.
  */
 
 // Type definition for de-allocator function, e.g. free().
@@ -35,4 +40,20 @@ typedef void (*inspect_callback_pair)(const void *, const void *);
 // value should be returned.
 typedef int compare_function(const void *,const void *);
 
+// Type definition for hash function, used by e.g. hashed tables.
+//
+// Hash functions must return the same value for any two arguments
+// that the corresponding compare_function considers equal. The
+// returned value does not need to be well mixed; implementations
+// scramble the bits before use.
+typedef uint64_t hash_function(const void *);
+
+// Type definition for size function, used by e.g. table memory
+// accounting.
+//
+// Size functions return the number of bytes of dynamic memory that
+// the argument owns, e.g. sizeof(int) for a malloc'd int, or the
+// length plus one for a malloc'd string.
+typedef size_t size_function(const void *);
+
 #endif
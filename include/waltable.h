@@ -0,0 +1,158 @@
+#ifndef WALTABLE_H
+#define WALTABLE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include "util.h"
+
+/*
+ * Declaration of a durable table. The pairs are kept in a table from
+ * table.h, and every insert and remove is also appended to a
+ * write-ahead log, so the table survives a crash. The keys and values
+ * must be flat, see table_save(), and are copied by the table.
+ *
+ * A durable table is stored in two files: a snapshot written by
+ * table_save() at path, and the log at path with ".wal" appended.
+ * Opening the table loads the snapshot and replays the log on top of
+ * it. A checkpoint saves the table as a new snapshot and drops the
+ * changes it holds from the log, so the log only holds the changes
+ * since the last checkpoint.
+ *
+ * Changes are numbered by log sequence numbers (LSNs). A change is
+ * applied to the table at once, but only buffered for the log until
+ * waltable_sync() writes and syncs the buffered records. A sync covers
+ * all changes made so far, by any thread, so threads that call
+ * waltable_sync() while another thread syncs share its fsync instead of
+ * each paying for their own (group commit). A single thread gets the
+ * same effect by syncing after a number of changes instead of after
+ * each.
+ *
+ * All functions may be called concurrently from any number of threads,
+ * except waltable_close. The table itself is guarded by one mutex;
+ * the writes and syncs of the log and the saving of a checkpoint run
+ * outside it.
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first version.
+ *   2026-10-16: v1.1, waltable_lookup() copies the value, and
+ *               checkpoints no longer hold up other threads while the
+ *               snapshot is saved.
+ */
+
+// ==========PUBLIC DATA TYPES============
+// Durable table type.
+typedef struct waltable waltable;
+
+// ==========DATA STRUCTURE INTERFACE==========
+
+/**
+ * waltable_open() - Open a durable table, creating it if needed.
+ * @path: Name of the snapshot file. The log is path with ".wal"
+ *	  appended. Neither file needs to exist.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: A pointer to a function (or NULL) to be used to hash
+ *		   keys.
+ * @key_size_func: A pointer to a function that returns the number of
+ *		   bytes of a key.
+ * @value_size_func: A pointer to a function that returns the number of
+ *		     bytes of a value. It is not called for NULL values.
+ * @checkpoint_bytes: Size of the log at which waltable_sync() makes a
+ *		      checkpoint, or 0 to only checkpoint when
+ *		      waltable_checkpoint() is called.
+ *
+ * The log is replayed in order, with each run of inserts added in one
+ * table_insert_batch() call. A record that was cut short by a crash,
+ * and anything after it, is dropped from the log.
+ *
+ * Return: Pointer to the table, or NULL with errno set if the files
+ * could not be read or the log could not be opened for writing.
+ */
+waltable *waltable_open(const char *path, compare_function key_cmp_func,
+			hash_function key_hash_func,
+			size_function key_size_func,
+			size_function value_size_func,
+			size_t checkpoint_bytes);
+
+/**
+ * waltable_insert() - Add a key/value pair to a durable table.
+ * @w: Table to manipulate.
+ * @key: A pointer to the key value, which is copied.
+ * @value: A pointer to the value value (or NULL), which is copied.
+ *
+ * Return: The LSN of the change, to be passed to waltable_sync(), or 0
+ * if not enough memory was available.
+ */
+uint64_t waltable_insert(waltable *w, const void *key, const void *value);
+
+/**
+ * waltable_remove() - Remove a key/value pair from a durable table.
+ * @w: Table to manipulate.
+ * @key: Key for which to remove pair.
+ *
+ * Return: The LSN of the change, to be passed to waltable_sync(), or 0
+ * if not enough memory was available.
+ */
+uint64_t waltable_remove(waltable *w, const void *key);
+
+/**
+ * waltable_lookup() - Look up a given key in a durable table.
+ * @w: Table to inspect.
+ * @key: Key to look up.
+ * @value: Buffer that the value is copied to.
+ * @size: Size of the buffer. At most size bytes of the value are
+ *	  copied.
+ *
+ * Return: The number of bytes of the value, as given by the value size
+ * function, or -1 if the key is not found in the table or its value is
+ * NULL.
+ */
+ssize_t waltable_lookup(waltable *w, const void *key, void *value,
+			size_t size);
+
+/**
+ * waltable_sync() - Make changes durable.
+ * @w: Table to sync.
+ * @lsn: LSN of the last change that must be durable.
+ *
+ * Returns at once if the change is already durable. Otherwise, if
+ * another thread is syncing, waits for it and then syncs the changes
+ * it did not cover, if any. If the log has grown to checkpoint_bytes
+ * and no checkpoint is being made, a checkpoint is made afterwards by
+ * the calling thread.
+ *
+ * Return: True if all changes up to lsn are durable, false with errno
+ * set if writing or syncing the log failed. After a failure the log
+ * cannot be written any more.
+ */
+bool waltable_sync(waltable *w, uint64_t lsn);
+
+/**
+ * waltable_checkpoint() - Save a durable table and empty its log.
+ * @w: Table to save.
+ *
+ * All changes are synced, the table is saved as a snapshot and
+ * reloaded from it, which also frees the memory of replaced and
+ * removed pairs, and then the log is replaced by one that holds only
+ * the changes made since the pairs were collected.
+ *
+ * Other threads are only held up while pointers to the pairs are
+ * collected, and while the changes they made during the save are
+ * replayed into the reloaded table and written to the new log. A
+ * checkpoint started while another is being made waits for it first.
+ *
+ * Return: True if the checkpoint was made, false with errno set
+ * otherwise. The table is unchanged by a failed checkpoint.
+ */
+bool waltable_checkpoint(waltable *w);
+
+/**
+ * waltable_close() - Sync and close a durable table.
+ * @w: Table to close.
+ *
+ * Return: True if all changes were synced, false with errno set
+ * otherwise. All memory of the table is freed in both cases.
+ */
+bool waltable_close(waltable *w);
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Declaration of a generator of key-value workloads in the style of
+ * YCSB. A workload is a stream of operations on integer keys, drawn
+ * from a profile that sets the share of reads, updates and churn, and
+ * whether the keys are Zipf-distributed or uniform.
+ *
+ * The table is assumed to hold the keys [0, keys-1] when the workload
+ * starts. Churn inserts new keys above the highest key and removes the
+ * oldest key, alternately, so the number of keys stays steady while
+ * the key range slides upwards. Reads and updates are drawn from the
+ * keys that are live at the time.
+ *
+ * The generator only produces operations. It knows nothing about
+ * tables, so the same stream can drive any table implementation.
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first version.
+ */
+
+// ==========PUBLIC DATA TYPES============
+// Workload generator type.
+typedef struct workload workload;
+
+// Type of an operation.
+typedef enum workload_op_type {
+	WORKLOAD_READ,   // Look up a live key.
+	WORKLOAD_UPDATE, // Replace the value of a live key.
+	WORKLOAD_INSERT, // Insert a new key.
+	WORKLOAD_REMOVE, // Remove a live key.
+} workload_op_type;
+
+// An operation of a workload.
+typedef struct workload_op {
+	workload_op_type type;
+	int key;
+} workload_op;
+
+// A workload profile. The shares are percentages of all operations and
+// add up to 100. Half of the churn operations are inserts and half are
+// removes.
+typedef struct workload_profile {
+	const char *name;
+	int read_percent;
+	int update_percent;
+	int churn_percent;
+	bool zipfian; // Zipf-distributed keys if true, otherwise uniform.
+} workload_profile;
+
+// ==========DATA STRUCTURE INTERFACE==========
+
+/**
+ * workload_profile_get() - Get a built-in workload profile.
+ * @i: Index of the profile, from 0.
+ *
+ * The built-in profiles are:
+ *   read-only:    100% reads (YCSB C),
+ *   read-mostly:  95% reads, 5% updates (YCSB B),
+ *   update-heavy: 50% reads, 50% updates (YCSB A),
+ *   churn:        50% reads, 25% inserts, 25% removes,
+ * all with Zipf-distributed keys, and
+ *   uniform:      95% reads, 5% updates with uniform keys.
+ *
+ * Return: The profile, or NULL if i is not less than the number of
+ * profiles.
+ */
+const workload_profile *workload_profile_get(int i);
+
+/**
+ * workload_profile_find() - Find a built-in workload profile by name.
+ * @name: Name of the profile.
+ *
+ * Return: The profile, or NULL if there is no profile with that name.
+ */
+const workload_profile *workload_profile_find(const char *name);
+
+/**
+ * workload_empty() - Create a workload generator.
+ * @profile: Profile of the workload.
+ * @keys: Number of keys in the table when the workload starts.
+ * @seed: Seed of the random number generator. Generators created with
+ *	  the same arguments produce the same operations.
+ *
+ * The Zipf distribution has the YCSB default skew of 0.99. The most
+ * popular keys are scattered over the key range rather than being the
+ * lowest keys.
+ *
+ * Return: Pointer to a new generator, or NULL if not enough memory was
+ * available.
+ */
+workload *workload_empty(const workload_profile *profile, int keys,
+			 uint64_t seed);
+
+/**
+ * workload_next() - Get the next operation of a workload.
+ * @w: Generator to use.
+ *
+ * Return: The next operation.
+ */
+workload_op workload_next(workload *w);
+
+/**
+ * workload_kill() - Destroy a workload generator.
+ * @w: Generator to destroy.
+ *
+ * Returns: Nothing.
+ */
+void workload_kill(workload *w);
+
+#endif
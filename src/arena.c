@@ -0,0 +1,170 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+
+/*
+ * Implementation of an arena allocator.
+ *
+ * The arena is a list of blocks. Allocations are carved from the head
+ * block until it is full, then a new block twice as large (up to
+ * MAX_BLOCK_SIZE) becomes the head. A request larger than a quarter of
+ * the block size gets a block of its own, which is linked behind the
+ * head so that the space left in the head is not wasted.
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first version.
+ *   2026-10-16: v1.1, added arena_memory_usage().
+ */
+
+// Size of the first block and the largest size blocks grow to.
+#define MIN_BLOCK_SIZE 4096
+#define MAX_BLOCK_SIZE (1 << 20)
+
+// Alignment of all allocations.
+#define ALIGNMENT _Alignof(max_align_t)
+
+// ===========INTERNAL DATA TYPES============
+
+struct arena_block {
+	struct arena_block *next;
+	size_t size; // Number of bytes in data.
+	_Alignas(max_align_t) unsigned char data[];
+};
+
+struct arena {
+	struct arena_block *head; // Block that allocations are carved from.
+	size_t used; // Number of bytes used in the head block.
+	size_t block_size; // Size of the next block.
+};
+
+// ===========INTERNAL FUNCTION IMPLEMENTATIONS============
+
+/*
+ * Allocate a block with room for size bytes.
+ */
+static struct arena_block *new_block(size_t size)
+{
+	struct arena_block *b = malloc(sizeof(*b) + size);
+	if (b != NULL) {
+		b->size = size;
+	}
+	return b;
+}
+
+// ===========DATA STRUCTURE INTERFACE IMPLEMENTATION============
+
+/**
+ * arena_empty() - Create an empty arena.
+ *
+ * Return: Pointer to a new arena, or NULL if not enough memory was
+ * available.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+arena *arena_empty(void)
+{
+	arena *a = calloc(1, sizeof(*a));
+	if (a != NULL) {
+		a->block_size = MIN_BLOCK_SIZE;
+	}
+	return a;
+}
+
+/**
+ * arena_alloc() - Allocate memory from an arena.
+ * @a: Arena to allocate from.
+ * @size: Number of bytes to allocate.
+ *
+ * Return: Pointer to the memory, or NULL if not enough memory was
+ * available.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+void *arena_alloc(arena *a, size_t size)
+{
+	size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+	if (a->head != NULL && a->head->size - a->used >= size) {
+		void *p = a->head->data + a->used;
+		a->used += size;
+		return p;
+	}
+	if (size > a->block_size / 4) {
+		// A block of its own, kept behind the head.
+		struct arena_block *b = new_block(size);
+		if (b == NULL) {
+			return NULL;
+		}
+		if (a->head != NULL) {
+			b->next = a->head->next;
+			a->head->next = b;
+		} else {
+			b->next = NULL;
+			a->head = b;
+			a->used = size;
+		}
+		return b->data;
+	}
+	struct arena_block *b = new_block(a->block_size);
+	if (b == NULL) {
+		return NULL;
+	}
+	b->next = a->head;
+	a->head = b;
+	a->used = size;
+	if (a->block_size < MAX_BLOCK_SIZE) {
+		a->block_size *= 2;
+	}
+	return b->data;
+}
+
+/**
+ * arena_copy() - Copy memory into an arena.
+ * @a: Arena to allocate from.
+ * @src: Memory to copy.
+ * @size: Number of bytes to copy.
+ *
+ * Return: Pointer to the copy, or NULL if not enough memory was
+ * available.
+ * Simplified asymptotic complexity analysis : O(size)
+ */
+void *arena_copy(arena *a, const void *src, size_t size)
+{
+	void *p = arena_alloc(a, size);
+	if (p != NULL) {
+		memcpy(p, src, size);
+	}
+	return p;
+}
+
+/**
+ * arena_memory_usage() - Get the memory used by an arena.
+ * @a: Arena to inspect.
+ *
+ * Return: The number of bytes allocated by the arena.
+ * Simplified asymptotic complexity analysis : O(number of blocks)
+ */
+size_t arena_memory_usage(const arena *a)
+{
+	size_t bytes = sizeof(*a);
+	for (const struct arena_block *b = a->head; b != NULL; b = b->next) {
+		bytes += sizeof(*b) + b->size;
+	}
+	return bytes;
+}
+
+/**
+ * arena_kill() - Destroy an arena.
+ * @a: Arena to destroy.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(number of blocks)
+ */
+void arena_kill(arena *a)
+{
+	struct arena_block *b = a->head;
+	while (b != NULL) {
+		struct arena_block *next = b->next;
+		free(b);
+		b = next;
+	}
+	free(a);
+}
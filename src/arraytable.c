@@ -1,30 +1,536 @@
 //Written by indexohan Eliasson <indexohane@cs.umu.se>.
 //May be used in the course Datastrukturer och Algoritmer (C) at Umeå University.
 //Usage exept those listed above requires permission by the author.
+//
+//This is the default implementation of table.h. Define TABLE_BACKEND_HASH
+//when compiling to use the hashed implementation in hashtable.c instead.
+#ifndef TABLE_BACKEND_HASH
+
+#include <errno.h>
 #include <stdlib.h>
 
 #include <stdio.h>
+#include <string.h>
 #include "table.h"
-#include "array_1d.h"
+#include "simd_scan.h"
+#include "snapshot.h"
+
+//Smallest number of entries allocated for a non-empty table.
+#define MIN_CAPACITY 4
 
+//Number of keys searched in lockstep by table_lookup_batch() in sorted
+//mode, and how many keys ahead the other modes prefetch.
+#define BATCH_GROUP 16
+#define PREFETCH_DISTANCE 4
 
-#define ARRAYSIZE 40000	//Needs to be the same as TABLESIZE in tabletest.c
+//Smallest number of entries or keys handed to a thread at a time by the
+//parallel operations. Smaller inputs are handled by the calling thread.
+#define PARALLEL_CHUNK 4096
 
+//Add n to an operation count of table t, see table_get_stats(). The
+//counts are added atomically, since lookups may run on several threads
+//at once. Without TABLE_STATS nothing is counted.
+#ifdef TABLE_STATS
+#define STAT_ADD(t, count, n) \
+	__atomic_fetch_add(&((table *)(t))->stats.count, (n), __ATOMIC_RELAXED)
+#else
+#define STAT_ADD(t, count, n) ((void)(t), (void)(n))
+#endif
+
+//The key/value pairs are stored by value in one contiguous buffer, so
+//a scan walks sequential memory and insert/remove allocate nothing
+//except when the buffer has to grow or shrink.
+typedef struct table_entry {
+	void *key;
+	void *value;
+} table_entry;
 
+//If the table has a hash function, a dense array of 16-bit key
+//fingerprints is kept next to the entries. A lookup scans the
+//fingerprints with vector compares and only calls the compare function
+//for entries whose fingerprint matches, which is about one call in
+//65536 for a missing key.
+//
+//In TABLE_MODE_COUNT a lookup count is kept for each entry as well.
+//The side arrays are indexed like the entries and move along with them.
+//
+//A table loaded by table_load_mmap() is mapped: it has no entry buffer
+//and reads its sorted pairs straight from the snapshot, until the first
+//change copies the key/value pointers into the buffer.
 typedef struct table {
-	array_1d *entries;
+	table_entry *entries;	//Entries [0, size-1] are in use.
+	uint16_t *fingerprints;	//Fingerprint of each entry, or NULL.
+	unsigned *counts;	//Lookup count of each entry, or NULL.
+	int size;		//Number of entries in use.
+	int capacity;		//Number of entries allocated.
+	table_mode mode;	//Order in which the entries are kept.
+	arena *arena;		//Arena for keys and values, or NULL.
+	snapshot *snapshot;	//Mapped by table_load_mmap(), or NULL.
+	bool mapped;		//True while the pairs are read from snapshot.
 	compare_function *key_cmp_func;
+	hash_function *key_hash_func;
 	free_function key_free_func;
 	free_function value_free_func;
-    int nextIndexAvailable;
+#ifdef TABLE_STATS
+	table_stats stats;	//Operation counts.
+#endif
 } table;
 
-typedef struct table_entry {
-	void *key;
-	void *value;
-} table_entry;
 
+/*
+ * Count a key search that examined the given number of entries.
+ */
+static void count_probes(const table *t, int probes)
+{
+#ifdef TABLE_STATS
+	int b = probes > 0 ? 32 - __builtin_clz(probes) : 0;
+	if (b >= TABLE_STATS_PROBE_BUCKETS) {
+		b = TABLE_STATS_PROBE_BUCKETS - 1;
+	}
+	STAT_ADD(t, probes[b], 1);
+	STAT_ADD(t, searches, 1);
+	STAT_ADD(t, probe_total, probes);
+#else
+	(void)t;
+	(void)probes;
+#endif
+}
+
+/*
+ * Count a lookup that found its key if hit is true.
+ */
+static void count_lookup(const table *t, bool hit)
+{
+	STAT_ADD(t, lookups, 1);
+	if (hit) {
+		STAT_ADD(t, hits, 1);
+	} else {
+		STAT_ADD(t, misses, 1);
+	}
+}
 
+/*
+ * Compare two keys with the compare function of the table.
+ */
+static int key_compare(const table *t, const void *key1, const void *key2)
+{
+	STAT_ADD(t, compares, 1);
+	return t->key_cmp_func(key1, key2);
+}
+
+/*
+ * Change the number of allocated entries. Returns false if not enough
+ * memory was available, the table is unchanged in that case.
+ */
+static bool set_capacity(table *t, int capacity)
+{
+	bool ok = true;
+	table_entry *entries = realloc(t->entries, capacity * sizeof(table_entry));
+	if (entries != NULL) {
+		t->entries = entries;
+		STAT_ADD(t, allocations, 1);
+	} else {
+		ok = false;
+	}
+	if (ok && t->key_hash_func != NULL) {
+		uint16_t *fingerprints = realloc(t->fingerprints,
+						 capacity * sizeof(uint16_t));
+		if (fingerprints != NULL) {
+			t->fingerprints = fingerprints;
+			STAT_ADD(t, allocations, 1);
+		} else {
+			ok = false;
+		}
+	}
+	if (ok && t->counts != NULL) {
+		unsigned *counts = realloc(t->counts, capacity * sizeof(unsigned));
+		if (counts != NULL) {
+			t->counts = counts;
+			STAT_ADD(t, allocations, 1);
+		} else {
+			ok = false;
+		}
+	}
+	//On failure every buffer still holds at least the smaller capacity.
+	if (ok || capacity < t->capacity) {
+		t->capacity = capacity;
+	}
+	return ok;
+}
+
+/*
+ * Return the fingerprint of a key, or 0 if the table has no hash
+ * function. The hash is scrambled and the top bits are used, so that
+ * weak hash functions such as the identity still give well spread
+ * fingerprints.
+ */
+static uint16_t key_fingerprint(const table *t, const void *key)
+{
+	if (t->key_hash_func == NULL) {
+		return 0;
+	}
+	return (uint16_t)((t->key_hash_func(key) * 0x9E3779B97F4A7C15ULL) >> 48);
+}
+
+/*
+ * Make sure there is room for n entries. The buffer at least doubles
+ * when it grows, so growth is amortized O(1) per entry.
+ */
+static bool reserve(table *t, int n)
+{
+	if (n <= t->capacity) {
+		return true;
+	}
+	int capacity = t->capacity < MIN_CAPACITY ? MIN_CAPACITY
+						  : 2 * t->capacity;
+	return set_capacity(t, capacity < n ? n : capacity);
+}
+
+/*
+ * Make sure there is room for one more entry.
+ */
+static bool grow(table *t)
+{
+	return reserve(t, t->size + 1);
+}
+
+/*
+ * Halve the buffer when less than a quarter of it is used, so memory
+ * follows the number of live entries. A failed shrink is harmless.
+ */
+static void shrink(table *t)
+{
+	if (t->capacity > MIN_CAPACITY && t->size < t->capacity / 4) {
+		set_capacity(t, t->capacity / 2);
+	}
+}
+
+/*
+ * Recompute the fingerprints of entries [from, size-1], after the
+ * entries have been rearranged in bulk.
+ */
+static void refresh_fingerprints(table *t, int from)
+{
+	if (t->fingerprints != NULL) {
+		for (int i = from; i < t->size; i++) {
+			t->fingerprints[i] = key_fingerprint(t, t->entries[i].key);
+		}
+	}
+}
+
+/*
+ * Return the index of the first entry in [lo, hi-1] whose key is not
+ * less than key, or hi if there is none. The entries must be sorted.
+ * The number of entries examined is added to *probes.
+ */
+static int lower_bound(const table *t, const void *key, int lo, int hi,
+		       int *probes)
+{
+	while (lo < hi) {
+		int mid = lo + (hi - lo) / 2;
+		(*probes)++;
+		if (key_compare(t, t->entries[mid].key, key) < 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+/*
+ * Merge the sorted runs src[0, half-1] and src[half, n-1] into dst.
+ */
+static void merge_entries(const table *t, const table_entry *src, int half,
+			  int n, table_entry *dst)
+{
+	int i = 0, j = half, k = 0;
+	while (i < half && j < n) {
+		//Take from the left run on ties to keep the sort stable.
+		if (key_compare(t, src[j].key, src[i].key) < 0) {
+			dst[k++] = src[j++];
+		} else {
+			dst[k++] = src[i++];
+		}
+	}
+	while (i < half) {
+		dst[k++] = src[i++];
+	}
+	while (j < n) {
+		dst[k++] = src[j++];
+	}
+}
+
+/*
+ * Sort n entries by key with a stable merge sort, so entries with equal
+ * keys keep their relative order. tmp must have room for n entries.
+ */
+static void sort_entries(const table *t, table_entry *a, int n,
+			 table_entry *tmp)
+{
+	if (n < 2) {
+		return;
+	}
+	int half = n / 2;
+	sort_entries(t, a, half, tmp);
+	sort_entries(t, a + half, n - half, tmp);
+	//Nothing to merge if the halves are already in order.
+	if (key_compare(t, a[half - 1].key, a[half].key) <= 0) {
+		return;
+	}
+	memcpy(tmp, a, n * sizeof(table_entry));
+	merge_entries(t, tmp, half, n, a);
+}
+
+/*
+ * Return the index of the entry with the given key and fingerprint, or
+ * -1 if the key is not in the table. A scan examines every entry up to
+ * the key or the end.
+ */
+static int find_index(const table *t, const void *key, uint16_t fp)
+{
+	int probes = 0;
+	int index = -1;
+	if (t->mode == TABLE_MODE_SORTED) {
+		int i = lower_bound(t, key, 0, t->size, &probes);
+		if (i < t->size) {
+			probes++;
+			if (key_compare(t, t->entries[i].key, key) == 0) {
+				index = i;
+			}
+		}
+	} else if (t->fingerprints != NULL) {
+		//Only compare keys of entries with a matching fingerprint.
+		for (int i = scan_u16(t->fingerprints, 0, t->size, fp);
+		     i < t->size;
+		     i = scan_u16(t->fingerprints, i + 1, t->size, fp)) {
+			if (key_compare(t, t->entries[i].key, key) == 0) {
+				index = i;
+				break;
+			}
+		}
+		probes = index >= 0 ? index + 1 : t->size;
+	} else {
+		for (int i = 0; i < t->size; i++) {
+			if (key_compare(t, t->entries[i].key, key) == 0) {
+				index = i;
+				break;
+			}
+		}
+		probes = index >= 0 ? index + 1 : t->size;
+	}
+	count_probes(t, probes);
+	return index;
+}
+
+/*
+ * Return entry i, read from the snapshot if the table is mapped.
+ */
+static table_entry entry_at(const table *t, int i)
+{
+	if (t->mapped) {
+		table_entry e = { snapshot_key(t->snapshot, i),
+				  snapshot_value(t->snapshot, i) };
+		return e;
+	}
+	return t->entries[i];
+}
+
+/*
+ * Look up a key in the snapshot of a mapped table.
+ */
+static void *lookup_mapped(const table *t, const void *key)
+{
+	int probes;
+	int index = snapshot_find(t->snapshot, key, t->key_cmp_func, &probes);
+	STAT_ADD(t, compares, probes);
+	count_probes(t, probes);
+	count_lookup(t, index >= 0);
+	return index >= 0 ? snapshot_value(t->snapshot, index) : NULL;
+}
+
+/*
+ * Copy the pairs of a mapped table into the entry buffer, so that the
+ * table can be changed. The keys and values still point into the
+ * snapshot. Returns false if not enough memory was available, the
+ * table is unchanged in that case.
+ */
+static bool materialize(table *t)
+{
+	if (!t->mapped) {
+		return true;
+	}
+	if (!reserve(t, t->size)) {
+		return false;
+	}
+	for (int i = 0; i < t->size; i++) {
+		t->entries[i] = entry_at(t, i);
+	}
+	t->mapped = false;
+	refresh_fingerprints(t, 0);
+	return true;
+}
+
+/*
+ * Call the registered free functions for the key and value of an entry.
+ */
+static void free_entry(const table *t, table_entry *e)
+{
+	if (t->key_free_func != NULL) {
+		t->key_free_func(e->key);
+	}
+	if (t->value_free_func != NULL) {
+		t->value_free_func(e->value);
+	}
+}
+
+/*
+ * Drop all but the last entry of each run of equal keys in n sorted
+ * entries, freeing the dropped ones. Returns the number of entries left.
+ */
+static int unique_last(const table *t, table_entry *a, int n)
+{
+	int k = 0;
+	for (int i = 0; i < n; i++) {
+		if (i + 1 < n && key_compare(t, a[i].key, a[i + 1].key) == 0) {
+			free_entry(t, &a[i]);
+		} else {
+			a[k++] = a[i];
+		}
+	}
+	return k;
+}
+
+/*
+ * Move n entries, with their fingerprints and counts, from index src to
+ * index dst. The ranges may overlap.
+ */
+static void move_entries(table *t, int dst, int src, int n)
+{
+	memmove(&t->entries[dst], &t->entries[src], n * sizeof(table_entry));
+	if (t->fingerprints != NULL) {
+		memmove(&t->fingerprints[dst], &t->fingerprints[src],
+			n * sizeof(uint16_t));
+	}
+	if (t->counts != NULL) {
+		memmove(&t->counts[dst], &t->counts[src], n * sizeof(unsigned));
+	}
+}
+
+/*
+ * Swap two entries with their fingerprints and counts.
+ */
+static void swap_entries(table *t, int i, int j)
+{
+	table_entry e = t->entries[i];
+	t->entries[i] = t->entries[j];
+	t->entries[j] = e;
+	if (t->fingerprints != NULL) {
+		uint16_t fp = t->fingerprints[i];
+		t->fingerprints[i] = t->fingerprints[j];
+		t->fingerprints[j] = fp;
+	}
+	if (t->counts != NULL) {
+		unsigned c = t->counts[i];
+		t->counts[i] = t->counts[j];
+		t->counts[j] = c;
+	}
+}
+
+/*
+ * Insert a new entry at a given index. In sorted mode the entries after
+ * it are shifted up, otherwise index must be size. There must be room
+ * for one more entry.
+ */
+static void insert_at(table *t, int index, void *key, void *value,
+		      uint16_t fp)
+{
+	move_entries(t, index + 1, index, t->size - index);
+	t->entries[index].key = key;
+	t->entries[index].value = value;
+	if (t->fingerprints != NULL) {
+		t->fingerprints[index] = fp;
+	}
+	if (t->counts != NULL) {
+		t->counts[index] = 0;
+	}
+	t->size++;
+	STAT_ADD(t, inserts, 1);
+}
+
+/*
+ * Remove the entry at a given index, without freeing it. In the
+ * unordered mode the last entry is moved into the hole, in the other
+ * modes the entries after it are shifted down to keep their order.
+ */
+static void remove_at(table *t, int index)
+{
+	t->size--;
+	if (t->mode == TABLE_MODE_UNORDERED) {
+		move_entries(t, index, t->size, 1);
+	} else {
+		move_entries(t, index, index + 1, t->size - index);
+	}
+	shrink(t);
+}
+
+/*
+ * Move the entry at index to position dst <= index, shifting the
+ * entries in between up by one.
+ */
+static void rotate_entry(table *t, int index, int dst)
+{
+	if (dst == index) {
+		return;
+	}
+	table_entry e = t->entries[index];
+	uint16_t fp = t->fingerprints != NULL ? t->fingerprints[index] : 0;
+	unsigned count = t->counts != NULL ? t->counts[index] : 0;
+	move_entries(t, dst + 1, dst, index - dst);
+	t->entries[dst] = e;
+	if (t->fingerprints != NULL) {
+		t->fingerprints[dst] = fp;
+	}
+	if (t->counts != NULL) {
+		t->counts[dst] = count;
+	}
+}
+
+/*
+ * Move an entry that was just found by a lookup towards the front, as
+ * dictated by the self-organizing mode of the table.
+ */
+static void reorganize(table *t, int index)
+{
+	switch (t->mode) {
+	case TABLE_MODE_MOVE_TO_FRONT:
+		rotate_entry(t, index, 0);
+		break;
+	case TABLE_MODE_TRANSPOSE:
+		if (index > 0) {
+			swap_entries(t, index, index - 1);
+		}
+		break;
+	case TABLE_MODE_COUNT: {
+		//The counts are non-increasing, so binary search for the
+		//first entry with a lower count and move the entry there.
+		unsigned count = ++t->counts[index];
+		int lo = 0, hi = index;
+		while (lo < hi) {
+			int mid = lo + (hi - lo) / 2;
+			if (t->counts[mid] < count) {
+				hi = mid;
+			} else {
+				lo = mid + 1;
+			}
+		}
+		rotate_entry(t, index, lo);
+		break;
+	}
+	default:
+		break;
+	}
+}
 
 /* Creates a table.
  *  compare_function - Pointer to a function that is called for comparing
@@ -39,15 +545,232 @@ table *table_empty(compare_function *key_cmp_func,
 		   free_function key_free_func,
 		   free_function value_free_func)
 {
-	//Creating pointer to table.
+	//Creating pointer to table. The entry buffer is allocated on the
+	//first insert.
 	table *t = calloc(sizeof (table),1);
-	//Creating array
-	t->entries = array_1d_create(free,0,ARRAYSIZE);
+	if (t == NULL) {
+		return NULL;
+	}
+	STAT_ADD(t, allocations, 1);
 	// Store the key compare function and key/value free functions.
 	t->key_cmp_func = key_cmp_func;
 	t->key_free_func = key_free_func;
 	t->value_free_func = value_free_func;
-	t->nextIndexAvailable = 0;
+	return t;
+}
+
+/* Creates a table. The hash function is used to keep a fingerprint of
+ * each key, which lets lookups skip the compare function for almost all
+ * non-matching entries. The table is still scanned linearly.
+ * Simplified asymptotic complexity analysis : O(1)
+ * */
+table *table_empty_with_hash(compare_function *key_cmp_func,
+			     hash_function *key_hash_func,
+			     free_function key_free_func,
+			     free_function value_free_func)
+{
+	table *t = table_empty(key_cmp_func, key_free_func, value_free_func);
+	if (t != NULL) {
+		t->key_hash_func = key_hash_func;
+	}
+	return t;
+}
+
+/* Creates a table from arrays of keys and values, see
+ * table_from_arrays_with_hash().
+ * Simplified asymptotic complexity analysis : O(n log n)
+ * */
+table *table_from_arrays(void **keys, void **values, int n,
+			 compare_function *key_cmp_func,
+			 free_function key_free_func,
+			 free_function value_free_func)
+{
+	return table_from_arrays_with_hash(keys, values, n, key_cmp_func, NULL,
+					   key_free_func, value_free_func);
+}
+
+/* Creates a table from arrays of keys and values. The pairs are copied
+ * into the entry buffer, which is allocated once, and stably sorted by
+ * key. Equal keys are then adjacent in insertion order, so one pass
+ * keeps the last pair of each key and frees the others. The table is
+ * in unordered mode, the entries just happen to be sorted.
+ * Simplified asymptotic complexity analysis : O(n log n)
+ * */
+table *table_from_arrays_with_hash(void **keys, void **values, int n,
+				   compare_function *key_cmp_func,
+				   hash_function *key_hash_func,
+				   free_function key_free_func,
+				   free_function value_free_func)
+{
+	table *t = table_empty_with_hash(key_cmp_func, key_hash_func,
+					 key_free_func, value_free_func);
+	if (t == NULL || n == 0) {
+		return t;
+	}
+	table_entry *tmp = malloc(n * sizeof(table_entry));
+	if (tmp == NULL || !reserve(t, n)) {
+		free(tmp);
+		table_kill(t);
+		return NULL;
+	}
+	STAT_ADD(t, allocations, 1);
+	for (int i = 0; i < n; i++) {
+		t->entries[i].key = keys[i];
+		t->entries[i].value = values[i];
+	}
+	sort_entries(t, t->entries, n, tmp);
+	free(tmp);
+	t->size = unique_last(t, t->entries, n);
+	STAT_ADD(t, inserts, t->size);
+	STAT_ADD(t, overwrites, n - t->size);
+	refresh_fingerprints(t, 0);
+	shrink(t);
+	return t;
+}
+
+//State shared by the threads of a parallel build. Each merge round
+//reads runs from src and writes the merged runs to dst, run r being
+//entries [bounds[r], bounds[r+1]-1].
+typedef struct build_job {
+	table *t;
+	void **keys;
+	void **values;
+	table_entry *src;
+	table_entry *dst;
+	const int *bounds;
+	int runs;
+	int width;		//Number of initial runs per input run.
+} build_job;
+
+/*
+ * Copy pairs [begin, end-1] of the input arrays to src.
+ */
+static void build_copy_task(void *arg, int begin, int end)
+{
+	build_job *job = arg;
+	for (int i = begin; i < end; i++) {
+		job->src[i].key = job->keys[i];
+		job->src[i].value = job->values[i];
+	}
+}
+
+/*
+ * Sort runs [begin, end-1] of src, using dst as scratch space.
+ */
+static void build_sort_task(void *arg, int begin, int end)
+{
+	build_job *job = arg;
+	for (int r = begin; r < end; r++) {
+		int lo = job->bounds[r];
+		sort_entries(job->t, job->src + lo, job->bounds[r + 1] - lo,
+			     job->dst + lo);
+	}
+}
+
+/*
+ * Merge pairs [begin, end-1] of runs from src into dst. A run without a
+ * partner is copied.
+ */
+static void build_merge_task(void *arg, int begin, int end)
+{
+	build_job *job = arg;
+	for (int p = begin; p < end; p++) {
+		int first = 2 * p * job->width;
+		int mid = first + job->width;
+		int last = mid + job->width;
+		mid = mid < job->runs ? mid : job->runs;
+		last = last < job->runs ? last : job->runs;
+		int lo = job->bounds[first];
+		merge_entries(job->t, job->src + lo, job->bounds[mid] - lo,
+			      job->bounds[last] - lo, job->dst + lo);
+	}
+}
+
+/*
+ * Compute the fingerprints of entries [begin, end-1].
+ */
+static void build_fingerprint_task(void *arg, int begin, int end)
+{
+	build_job *job = arg;
+	for (int i = begin; i < end; i++) {
+		job->t->fingerprints[i] =
+			key_fingerprint(job->t, job->t->entries[i].key);
+	}
+}
+
+/* Creates a table from arrays of keys and values using a thread pool.
+ * The pairs are split into one run per thread, the runs are sorted in
+ * parallel, and then merged pairwise in rounds, where the merges of a
+ * round run in parallel. The rounds alternate between the entry buffer
+ * and a scratch buffer, and the pairs are first copied to whichever
+ * buffer makes the last round end in the entry buffer. Removing the
+ * duplicates is a single serial pass, the fingerprints are computed in
+ * parallel again.
+ * Simplified asymptotic complexity analysis : O(n log n / threads + n)
+ * */
+table *table_from_arrays_parallel(void **keys, void **values, int n,
+				  compare_function *key_cmp_func,
+				  hash_function *key_hash_func,
+				  free_function key_free_func,
+				  free_function value_free_func,
+				  threadpool *pool)
+{
+	int runs = pool != NULL ? threadpool_size(pool) : 1;
+	if (runs > n / PARALLEL_CHUNK) {
+		runs = n / PARALLEL_CHUNK;
+	}
+	if (runs < 2) {
+		return table_from_arrays_with_hash(keys, values, n,
+						   key_cmp_func, key_hash_func,
+						   key_free_func,
+						   value_free_func);
+	}
+	table *t = table_empty_with_hash(key_cmp_func, key_hash_func,
+					 key_free_func, value_free_func);
+	if (t == NULL) {
+		return NULL;
+	}
+	table_entry *tmp = malloc(n * sizeof(table_entry));
+	int *bounds = malloc((runs + 1) * sizeof(int));
+	if (tmp == NULL || bounds == NULL || !reserve(t, n)) {
+		free(tmp);
+		free(bounds);
+		table_kill(t);
+		return NULL;
+	}
+	STAT_ADD(t, allocations, 2);
+	for (int r = 0; r <= runs; r++) {
+		bounds[r] = (int)((long long)n * r / runs);
+	}
+	int rounds = 0;
+	for (int w = 1; w < runs; w *= 2) {
+		rounds++;
+	}
+	build_job job = {
+		.t = t, .keys = keys, .values = values, .bounds = bounds,
+		.runs = runs,
+		.src = rounds % 2 == 0 ? t->entries : tmp,
+		.dst = rounds % 2 == 0 ? tmp : t->entries,
+	};
+	threadpool_run(pool, build_copy_task, &job, n, PARALLEL_CHUNK);
+	threadpool_run(pool, build_sort_task, &job, runs, 1);
+	for (job.width = 1; job.width < runs; job.width *= 2) {
+		int pairs = (runs + 2 * job.width - 1) / (2 * job.width);
+		threadpool_run(pool, build_merge_task, &job, pairs, 1);
+		table_entry *swap = job.src;
+		job.src = job.dst;
+		job.dst = swap;
+	}
+	free(tmp);
+	free(bounds);
+	t->size = unique_last(t, t->entries, n);
+	STAT_ADD(t, inserts, t->size);
+	STAT_ADD(t, overwrites, n - t->size);
+	if (t->fingerprints != NULL) {
+		threadpool_run(pool, build_fingerprint_task, &job, t->size,
+			       PARALLEL_CHUNK);
+	}
+	shrink(t);
 	return t;
 }
 
@@ -62,13 +785,7 @@ table *table_empty(compare_function *key_cmp_func,
  */
 bool table_is_empty(const table *t)
 {
-	//Pointer to the table.
-	table *tablePointer = (table*)t;
-	//Simple lookup if nextIndexAvailable equals 0.
-	if(tablePointer->nextIndexAvailable == 0){
-		return true;
-	}
-	return false;
+	return t->size == 0;
 }
 
 /**
@@ -82,69 +799,184 @@ bool table_is_empty(const table *t)
  * added value for a duplicate key. table_remove() will remove all
  * duplicates for a given key.
  *
- * Returns: Nothing.
+ * Return: True if the pair was inserted, false if not enough memory was
+ * available, in which case the table is unchanged.
  * Simplified asymptotic complexity analysis : O(n)
  */
-void table_insert(table *t, void *key, void *value)
+bool table_insert(table *t, void *key, void *value)
 {
-	//Pointer to the table.
-	table *tablePointer = (table*)t;
-	//Used as working pointer
-	table_entry *checkElement;
-	//Used to insert element.
-	table_entry *insertElement = malloc(sizeof(table_entry));
-
-	//Values who will be inserted.
-	insertElement->key = key;
-	insertElement->value = value;
-
-	//Exist to make sure we won't go to the wrong places.
-	bool inserted = false;
-
-	int index = 0;
 	/*
-	 * There are three different situations we insert values.
-	 * 1. Table is empty, just insert in array[0] slot.
-	 * 2. Table key exist and we want to overwrite, traverse through the array until we find the
-	 * right key and overwrite it.
-	 * 3. If key does not exist and array is not empty. Insert in next available slot.
+	 * There are two different situations we insert values.
+	 * 1. Table key exist and we want to overwrite, free the old pair
+	 * and overwrite the entry in place.
+	 * 2. If key does not exist, append the pair after the last entry,
+	 * or in sorted mode insert it at its position.
 	 */
-
-	//If table is empty
-	if(table_is_empty(tablePointer) == true){
-		//Insert first slot of the array.
-		array_1d_set_value(tablePointer->entries,insertElement,tablePointer->nextIndexAvailable);
-		checkElement = array_1d_inspect_value(tablePointer->entries, index);
-		inserted = true;					//Used to exit loop and function.
-		tablePointer->nextIndexAvailable++;	//Update inserted slots of array.
-	}
-
-	//Traverse through all values to see if key exist, then replace if it does.
-	while(array_1d_has_value(tablePointer->entries,index) && inserted == false){
-		//Look at current slot of array
-		checkElement = array_1d_inspect_value(tablePointer->entries, index);
-		if(tablePointer->key_cmp_func(checkElement->key, key) == 0){	//See if key match
-			//Remove whatever is there to avoid memory-leak.
-			if (t->key_free_func != NULL) {
-				t->key_free_func(checkElement->key);
+	if (!materialize(t)) {
+		return false;
+	}
+	uint16_t fp = key_fingerprint(t, key);
+	int index;
+	if (t->mode == TABLE_MODE_SORTED) {
+		int probes = 0;
+		index = lower_bound(t, key, 0, t->size, &probes);
+		bool found = false;
+		if (index < t->size) {
+			probes++;
+			found = key_compare(t, t->entries[index].key, key) == 0;
+		}
+		count_probes(t, probes);
+		if (!found) {
+			if (!grow(t)) {
+				return false;
 			}
-			if (t->value_free_func != NULL) {
-				t->value_free_func(checkElement->value);
+			insert_at(t, index, key, value, fp);
+			return true;
+		}
+	} else {
+		index = find_index(t, key, fp);
+		if (index < 0) {
+			if (!grow(t)) {
+				return false;
+			}
+			insert_at(t, t->size, key, value, fp);
+			return true;
+		}
+	}
+	free_entry(t, &t->entries[index]);
+	t->entries[index].key = key;
+	t->entries[index].value = value;
+	STAT_ADD(t, overwrites, 1);
+	return true;
+}
+
+/**
+ * table_insert_batch() - Add a number of key/value pairs to a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n pointers to key values.
+ * @values: Array of n pointers to value values.
+ * @n: Number of pairs to insert.
+ *
+ * Equivalent to calling table_insert() for each pair in array order.
+ * In sorted mode the pairs are appended, sorted once and merged with
+ * the existing entries, instead of being shifted into place one by one.
+ * Room for all n pairs is made before any of them is inserted, so the
+ * batch either fails as a whole or not at all.
+ *
+ * Return: True if the pairs were inserted, false if not enough memory
+ * was available, in which case the table is unchanged.
+ * Simplified asymptotic complexity analysis : O(n log n + size) sorted,
+ * O(n * size) unordered
+ */
+bool table_insert_batch(table *t, void **keys, void **values, int n)
+{
+	if (!materialize(t) || !reserve(t, t->size + n)) {
+		return false;
+	}
+	if (t->mode != TABLE_MODE_SORTED) {
+		//The inserts cannot fail, the buffer has room for all pairs.
+		for (int i = 0; i < n; i++) {
+			table_insert(t, keys[i], values[i]);
+		}
+		return true;
+	}
+	int old_size = t->size;
+	table_entry *tmp = malloc((old_size + n) * sizeof(table_entry));
+	if (tmp == NULL) {
+		return false;
+	}
+	STAT_ADD(t, allocations, 1);
+	int added_n = n;
+	//Append the new pairs and sort them, the last duplicate wins.
+	table_entry *added = &t->entries[old_size];
+	for (int i = 0; i < n; i++) {
+		added[i].key = keys[i];
+		added[i].value = values[i];
+	}
+	sort_entries(t, added, n, tmp);
+	n = unique_last(t, added, n);
+
+	//Merge the old and new entries, a new pair replaces an old one.
+	int i = 0, j = 0, k = 0;
+	while (i < old_size && j < n) {
+		int c = key_compare(t, t->entries[i].key, added[j].key);
+		if (c < 0) {
+			tmp[k++] = t->entries[i++];
+		} else {
+			if (c == 0) {
+				free_entry(t, &t->entries[i++]);
 			}
+			tmp[k++] = added[j++];
+		}
+	}
+	while (i < old_size) {
+		tmp[k++] = t->entries[i++];
+	}
+	while (j < n) {
+		tmp[k++] = added[j++];
+	}
+	memcpy(t->entries, tmp, k * sizeof(table_entry));
+	free(tmp);
+	t->size = k;
+	STAT_ADD(t, inserts, k - old_size);
+	STAT_ADD(t, overwrites, added_n - (k - old_size));
+	refresh_fingerprints(t, 0);
+	return true;
+}
 
-			array_1d_set_value(tablePointer->entries,insertElement,index);
-			checkElement = array_1d_inspect_value(tablePointer->entries, index);
-			inserted = true;		//Used to exit loop and function.
+/**
+ * table_set_mode() - Change the storage mode of a table.
+ * @t: Table to manipulate.
+ * @mode: The new mode.
+ *
+ * All modes are supported. Switching to sorted mode sorts the entries
+ * once. Switching to TABLE_MODE_COUNT starts all lookup counts at zero.
+ *
+ * Return: True if the mode was changed, false if the mode is not
+ * supported or not enough memory was available.
+ * Simplified asymptotic complexity analysis : O(n log n)
+ */
+bool table_set_mode(table *t, table_mode mode)
+{
+	if (mode != t->mode && !materialize(t)) {
+		return false;
+	}
+	switch (mode) {
+	case TABLE_MODE_UNORDERED:
+	case TABLE_MODE_MOVE_TO_FRONT:
+	case TABLE_MODE_TRANSPOSE:
+		break;
+	case TABLE_MODE_SORTED:
+		if (t->mode != TABLE_MODE_SORTED && t->size > 1) {
+			table_entry *tmp = malloc(t->size * sizeof(table_entry));
+			if (tmp == NULL) {
+				return false;
+			}
+			STAT_ADD(t, allocations, 1);
+			sort_entries(t, t->entries, t->size, tmp);
+			free(tmp);
+			refresh_fingerprints(t, 0);
+		}
+		break;
+	case TABLE_MODE_COUNT:
+		if (t->counts == NULL) {
+			t->counts = calloc(t->capacity > 0 ? t->capacity : 1,
+					   sizeof(unsigned));
+			if (t->counts == NULL) {
+				return false;
+			}
+			STAT_ADD(t, allocations, 1);
 		}
-		index++;	//Check next index of array.
+		break;
+	default:
+		return false;
 	}
-	//If Key do not exist put it to next available slot.
-	if(inserted == false){
-		array_1d_set_value(tablePointer->entries,insertElement,tablePointer->nextIndexAvailable);
-		checkElement = array_1d_inspect_value(tablePointer->entries, tablePointer->nextIndexAvailable);
-		inserted = true;					//Used to exit loop and function.
-		tablePointer->nextIndexAvailable++;	//Update nextIndexAvailable in the array.
+	if (mode != TABLE_MODE_COUNT) {
+		free(t->counts);
+		t->counts = NULL;
 	}
+	t->mode = mode;
+	return true;
 }
 
 /**
@@ -154,26 +986,156 @@ void table_insert(table *t, void *key, void *value)
  *
  * Return: The value corresponding to a given key, or NULL if the key
  * is not found in the table. If the table contains duplicate keys,
- * the value that was latest inserted will be returned.
- * Simplified asymptotic complexity analysis : O(n)
+ * the value that was latest inserted will be returned. In the
+ * self-organizing modes the found entry is moved towards the front.
+ * Simplified asymptotic complexity analysis : O(n), O(log n) sorted
  */
 void *table_lookup(const table *t, const void *key)
 {
-	//Pointer used to check element.
-	table_entry *checkElement;
-	//Pointer for table.
-	table *tablePointer = (table*)t;
-	int index = array_1d_low(t->entries);
-	//Traverse through all values to see if key exist, then replace if it does.
-	while(array_1d_has_value(tablePointer->entries,index)){
-		//Look at current slot of array
-		checkElement = array_1d_inspect_value(tablePointer->entries, index);
-		if(tablePointer->key_cmp_func(checkElement->key, key) == 0){	//If key found, return value.
-			return checkElement->value;
+	if (t->mapped) {
+		return lookup_mapped(t, key);
+	}
+	int index = find_index(t, key, key_fingerprint(t, key));
+	count_lookup(t, index >= 0);
+	if (index < 0) {
+		return NULL;
+	}
+	void *value = t->entries[index].value;
+	//Self-organizing modes rearrange the table on every hit.
+	if (t->mode != TABLE_MODE_UNORDERED && t->mode != TABLE_MODE_SORTED) {
+		reorganize((table *)t, index);
+	}
+	return value;
+}
+
+/*
+ * Look up a group of at most BATCH_GROUP keys in a sorted table. The
+ * binary searches run in lockstep and the probed entries of all keys
+ * are prefetched before any of them is compared, so the cache misses
+ * of one step overlap instead of being paid one after another.
+ */
+static void lookup_group_sorted(const table *t, void **keys, int n,
+				void **values)
+{
+	int lo[BATCH_GROUP];
+	int len[BATCH_GROUP];
+	for (int j = 0; j < n; j++) {
+		lo[j] = 0;
+		len[j] = t->size;
+	}
+	//Each search narrows [lo, lo+len-1] to the last entry whose key
+	//is not greater than the searched key. All searches halve their
+	//length in every step, so they finish together.
+	int steps = 0;
+	for (;;) {
+		bool active = false;
+		for (int j = 0; j < n; j++) {
+			if (len[j] > 1) {
+				__builtin_prefetch(&t->entries[lo[j] + len[j] / 2]);
+				active = true;
+			}
+		}
+		if (!active) {
+			break;
+		}
+		steps++;
+		for (int j = 0; j < n; j++) {
+			if (len[j] > 1) {
+				int half = len[j] / 2;
+				if (key_compare(t, t->entries[lo[j] + half].key,
+						keys[j]) <= 0) {
+					lo[j] += half;
+				}
+				len[j] -= half;
+			}
+		}
+	}
+	for (int j = 0; j < n; j++) {
+		bool hit = t->size > 0 &&
+			key_compare(t, t->entries[lo[j]].key, keys[j]) == 0;
+		values[j] = hit ? t->entries[lo[j]].value : NULL;
+		count_probes(t, t->size > 0 ? steps + 1 : 0);
+		count_lookup(t, hit);
+	}
+}
+
+/**
+ * table_lookup_batch() - Look up a number of keys in a table.
+ * @table: Table to inspect.
+ * @keys: Array of n keys to look up.
+ * @n: Number of keys.
+ * @values: Array of n pointers to be filled with the results.
+ *
+ * In sorted mode the keys are looked up in groups with interleaved
+ * binary searches. In the other modes the keys are looked up one at a
+ * time, and the key memory of upcoming keys is prefetched so that it
+ * is cached when the key is hashed or compared.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(n * size),
+ * O(n log size) sorted
+ */
+void table_lookup_batch(const table *t, void **keys, int n, void **values)
+{
+	if (t->mode == TABLE_MODE_SORTED && !t->mapped) {
+		for (int i = 0; i < n; i += BATCH_GROUP) {
+			int m = n - i < BATCH_GROUP ? n - i : BATCH_GROUP;
+			lookup_group_sorted(t, keys + i, m, values + i);
+		}
+		return;
+	}
+	for (int i = 0; i < n; i++) {
+		if (i + PREFETCH_DISTANCE < n) {
+			__builtin_prefetch(keys[i + PREFETCH_DISTANCE]);
 		}
-		index++;	//Point at the next slow.
+		values[i] = table_lookup(t, keys[i]);
+	}
+}
+
+//State shared by the threads of a parallel lookup.
+typedef struct lookup_job {
+	const table *t;
+	void **keys;
+	void **values;
+} lookup_job;
+
+/*
+ * Look up keys [begin, end-1] of a parallel lookup.
+ */
+static void lookup_task(void *arg, int begin, int end)
+{
+	lookup_job *job = arg;
+	table_lookup_batch(job->t, job->keys + begin, end - begin,
+			   job->values + begin);
+}
+
+/**
+ * table_lookup_batch_parallel() - Look up a number of keys in a table
+ * using a thread pool.
+ * @table: Table to inspect.
+ * @keys: Array of n keys to look up.
+ * @n: Number of keys.
+ * @values: Array of n pointers to be filled with the results.
+ * @pool: Thread pool to run the lookups on.
+ *
+ * The keys are split into ranges that are looked up with
+ * table_lookup_batch() by the threads of the pool. A lookup in a
+ * self-organizing mode rearranges the table, so in those modes the
+ * keys are looked up by the calling thread only.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(n * size / threads),
+ * O(n log size / threads) sorted
+ */
+void table_lookup_batch_parallel(const table *t, void **keys, int n,
+				 void **values, threadpool *pool)
+{
+	if (t->mode != TABLE_MODE_UNORDERED && t->mode != TABLE_MODE_SORTED) {
+		table_lookup_batch(t, keys, n, values);
+		return;
 	}
-	return NULL;
+	lookup_job job = { .t = t, .keys = keys, .values = values };
+	threadpool_run(pool, lookup_task, &job, n, PARALLEL_CHUNK);
 }
 
 /**
@@ -190,46 +1152,90 @@ void *table_lookup(const table *t, const void *key)
  */
 void table_remove(table *t, const void *key)
 {
-	//Pointer to check element.
-	table_entry *checkElement;
-	//Pointer used for moving element.
-	table_entry *moveElement = malloc(sizeof(table_entry));
-	//Pointer to table.
-	table *tablePointer = (table*)t;
-	int index = array_1d_low(t->entries);
-	int removedIndex;
-	bool removed = false;
-	//Traverse through all values to see if key exist, then remove if it does.
-	while(array_1d_has_value(tablePointer->entries,index) && removed == false){
-		checkElement = array_1d_inspect_value(tablePointer->entries, index);	//Load current slot
-		if(tablePointer->key_cmp_func(checkElement->key, key) == 0){	//If key found, remove it.
-			if (t->key_free_func != NULL) {
-				t->key_free_func(checkElement->key);
-			}
-			if (t->value_free_func != NULL) {
-				t->value_free_func(checkElement->value);
-			}
-			array_1d_set_value(tablePointer->entries,NULL,index);
-			removedIndex = index;
-			tablePointer->nextIndexAvailable--;	//Update nextIndexAvailable
-			removed = true;
-		}
-		index++;	//Check next index.
+	if (!materialize(t)) {
+		return;
+	}
+	int index = find_index(t, key, key_fingerprint(t, key));
+	if (index < 0) {
+		return;
+	}
+	free_entry(t, &t->entries[index]);
+	//Close the hole to make sure there are no "holes" in the array.
+	remove_at(t, index);
+	STAT_ADD(t, removes, 1);
+}
+
+/**
+ * table_foreach() - Call a function for each key/value pair in a table.
+ * @table: Table to inspect.
+ * @inspect_func: Function called with the key and value of each pair.
+ *
+ * The pairs are visited in buffer order.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(n)
+ */
+void table_foreach(const table *t, inspect_callback_pair inspect_func)
+{
+	for (int i = 0; i < t->size; i++) {
+		table_entry e = entry_at(t, i);
+		inspect_func(e.key, e.value);
 	}
-	//Move last element of array to removed index to make sure there are no "holes" in the array.
-	//Don't if removed element was the last element in the array.
-	if(removed && tablePointer->nextIndexAvailable != removedIndex){
-		checkElement = array_1d_inspect_value(tablePointer->entries, tablePointer->nextIndexAvailable);
-		//Copy the element at the end of the array to the index where the removed element used to be.
-		moveElement->key = checkElement->key;
-		moveElement->value = checkElement->value;
-		array_1d_set_value(tablePointer->entries,moveElement,removedIndex);
-		//Remove element at the end of the array.
-		array_1d_set_value(tablePointer->entries,NULL,tablePointer->nextIndexAvailable);
+}
+
+/**
+ * table_iter_begin() - Start iterating over a table.
+ * @table: Table to iterate over.
+ * @it: Iterator to initialize.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+void table_iter_begin(const table *t, table_iter *it)
+{
+	it->t = t;
+	it->index = 0;
+}
+
+/**
+ * table_iter_next() - Get the next key/value pair of an iteration.
+ * @it: Iterator started by table_iter_begin().
+ * @key: Set to the key of the next pair.
+ * @value: Set to the value of the next pair.
+ *
+ * Return: True if a pair was returned, false if all pairs have been
+ * visited.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+bool table_iter_next(table_iter *it, void **key, void **value)
+{
+	if (it->index >= it->t->size) {
+		return false;
 	}
-	else{
-		free(moveElement);	//Free if not used
+	table_entry e = entry_at(it->t, it->index);
+	*key = e.key;
+	*value = e.value;
+	it->index++;
+	return true;
+}
+
+/**
+ * table_arena() - Get the memory arena owned by a table.
+ * @table: Table to inspect.
+ *
+ * The entries themselves live in the entry buffer, so only keys and
+ * values are meant to be allocated from the arena.
+ *
+ * Return: The arena of the table, or NULL if not enough memory was
+ * available.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+arena *table_arena(table *t)
+{
+	if (t->arena == NULL) {
+		t->arena = arena_empty();
 	}
+	return t->arena;
 }
 
 /*
@@ -246,39 +1252,250 @@ void table_remove(table *t, const void *key)
  */
 void table_kill(table *t)
 {
-	int index = array_1d_low(t->entries);
-	//Pointer to table.
-	table *tablePointer = (table*)t;
-	//Pointer to element to check.
-	table_entry *checkElement;
-	//Traverse through array. Remove all elements.
-	while(array_1d_has_value(tablePointer->entries,index) && index < tablePointer->nextIndexAvailable+1){
-		checkElement = array_1d_inspect_value(tablePointer->entries, index);	//Load current slot
-			if (t->key_free_func != NULL) {
-				t->key_free_func(checkElement->key);
-			}
-			if (t->value_free_func != NULL) {
-				t->value_free_func(checkElement->value);
-			}
-		array_1d_set_value(tablePointer->entries,NULL,index);
-		index++;
+	for (int i = 0; i < t->size && !t->mapped; i++) {
+		free_entry(t, &t->entries[i]);
+	}
+	free(t->entries);
+	free(t->fingerprints);
+	free(t->counts);
+	if (t->arena != NULL) {
+		arena_kill(t->arena);
+	}
+	if (t->snapshot != NULL) {
+		snapshot_kill(t->snapshot);
 	}
-	array_1d_kill(t->entries);
 	free(t);
 }
+
+/*
+ * Call the free functions for entries [begin, end-1] of a table.
+ */
+static void kill_task(void *arg, int begin, int end)
+{
+	table *t = arg;
+	for (int i = begin; i < end; i++) {
+		free_entry(t, &t->entries[i]);
+	}
+}
+
+/*
+ * table_kill_parallel() - Destroy a table using a thread pool.
+ * @table: Table to destroy.
+ * @pool: Thread pool to run the free functions on.
+ *
+ * As table_kill(), but the free functions are called for ranges of the
+ * entries by the threads of the pool.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(n / threads)
+ */
+void table_kill_parallel(table *t, threadpool *pool)
+{
+	if (t->key_free_func != NULL || t->value_free_func != NULL) {
+		threadpool_run(pool, kill_task, t, t->size, PARALLEL_CHUNK);
+	}
+	t->size = 0;
+	table_kill(t);
+}
+
+/**
+ * table_save() - Write the pairs of a table to a snapshot file.
+ * @table: Table to save.
+ * @path: Name of the file to write.
+ * @key_size_func: A pointer to a function that returns the number of
+ *		   bytes of a key.
+ * @value_size_func: A pointer to a function that returns the number of
+ *		     bytes of a value.
+ *
+ * The pairs of a sorted or mapped table are already in key order, so
+ * they are saved without sorting.
+ *
+ * Return: True if the snapshot was saved, false with errno set
+ * otherwise.
+ * Simplified asymptotic complexity analysis : O(n log n + bytes),
+ * O(n + bytes) sorted
+ */
+bool table_save(const table *t, const char *path,
+		size_function *key_size_func,
+		size_function *value_size_func)
+{
+	int n = t->size;
+	void **keys = malloc((n > 0 ? n : 1) * sizeof(void *));
+	void **values = malloc((n > 0 ? n : 1) * sizeof(void *));
+	bool ok = false;
+	if (keys != NULL && values != NULL) {
+		for (int i = 0; i < n; i++) {
+			table_entry e = entry_at(t, i);
+			keys[i] = e.key;
+			values[i] = e.value;
+		}
+		ok = snapshot_save(path, keys, values, n, t->key_cmp_func,
+				   key_size_func, value_size_func);
+	}
+	free(keys);
+	free(values);
+	return ok;
+}
+
+/**
+ * table_load_mmap() - Create a table from a snapshot file.
+ * @path: Name of a file written by table_save().
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: A pointer to a function (or NULL) to be used to hash
+ *		   keys.
+ *
+ * The table is created in sorted mode and mapped: lookups binary
+ * search the records of the snapshot, and nothing is built until the
+ * table is changed, when the pairs are copied to the entry buffer.
+ *
+ * Return: Pointer to a new table, or NULL with errno set if the file
+ * could not be loaded.
+ * Simplified asymptotic complexity analysis : O(bytes) to check the
+ * file, O(1) otherwise
+ */
+table *table_load_mmap(const char *path, compare_function *key_cmp_func,
+		       hash_function *key_hash_func)
+{
+	snapshot *s = snapshot_load(path);
+	if (s == NULL) {
+		return NULL;
+	}
+	table *t = table_empty_with_hash(key_cmp_func, key_hash_func, NULL,
+					 NULL);
+	if (t == NULL) {
+		snapshot_kill(s);
+		errno = ENOMEM;
+		return NULL;
+	}
+	t->mode = TABLE_MODE_SORTED;
+	t->size = snapshot_size(s);
+	t->snapshot = s;
+	t->mapped = true;
+	return t;
+}
+
+/**
+ * table_memory_usage() - Get the memory allocated by a table.
+ * @table: Table to inspect.
+ *
+ * Return: The number of bytes, as table_memory_breakdown() without
+ * size functions.
+ * Simplified asymptotic complexity analysis : O(1), plus the number of
+ * arena blocks
+ */
+size_t table_memory_usage(const table *t)
+{
+	table_memory mem;
+	table_memory_breakdown(t, NULL, NULL, &mem);
+	return mem.total;
+}
+
+/**
+ * table_memory_breakdown() - Get the memory used by a table, by part.
+ * @table: Table to inspect.
+ * @key_size_func: A pointer to a function (or NULL) that returns the
+ *		   bytes owned by a key.
+ * @value_size_func: A pointer to a function (or NULL) that returns the
+ *		     bytes owned by a value.
+ * @mem: Set to the memory used by each part of the table.
+ *
+ * The entries in use are the entries, and their fingerprints and
+ * lookup counts the index. Allocated entries beyond the size, with
+ * their fingerprints and counts, are slack. A mapped table has none of
+ * these; its pairs, keys and values are all in the mapping.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(n) if a size function
+ * is given, otherwise as table_memory_usage()
+ */
+void table_memory_breakdown(const table *t, size_function *key_size_func,
+			    size_function *value_size_func,
+			    table_memory *mem)
+{
+	size_t index_size = 0;
+	if (t->fingerprints != NULL) {
+		index_size += sizeof(uint16_t);
+	}
+	if (t->counts != NULL) {
+		index_size += sizeof(unsigned);
+	}
+	memset(mem, 0, sizeof(*mem));
+	mem->pairs = t->size;
+	mem->table = sizeof(*t);
+	if (!t->mapped) {
+		mem->entries = (size_t)t->size * sizeof(table_entry);
+		mem->index = (size_t)t->size * index_size;
+		mem->slack = (size_t)(t->capacity - t->size) *
+			     (sizeof(table_entry) + index_size);
+	}
+	if (t->arena != NULL) {
+		mem->arena = arena_memory_usage(t->arena);
+	}
+	if (t->snapshot != NULL) {
+		mem->mapped = snapshot_bytes(t->snapshot);
+	}
+	for (int i = 0; i < t->size && key_size_func != NULL && !t->mapped;
+	     i++) {
+		mem->keys += key_size_func(entry_at(t, i).key);
+	}
+	for (int i = 0; i < t->size && value_size_func != NULL && !t->mapped;
+	     i++) {
+		mem->values += value_size_func(entry_at(t, i).value);
+	}
+	mem->total = mem->table + mem->entries + mem->index + mem->slack +
+		     mem->arena + mem->mapped + mem->keys + mem->values;
+}
+
+/**
+ * table_get_stats() - Get the operation counts of a table.
+ * @table: Table to inspect.
+ * @stats: Set to the counts since the table was created or
+ *	   table_reset_stats() was last called.
+ *
+ * A search examines the entries of a binary search in sorted mode, and
+ * every entry up to the key in the other modes.
+ *
+ * Return: True if the counts are kept, false otherwise.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+bool table_get_stats(const table *t, table_stats *stats)
+{
+#ifdef TABLE_STATS
+	*stats = t->stats;
+	return true;
+#else
+	(void)t;
+	memset(stats, 0, sizeof(*stats));
+	return false;
+#endif
+}
+
+/**
+ * table_reset_stats() - Set the operation counts of a table to zero.
+ * @table: Table to manipulate.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+void table_reset_stats(table *t)
+{
+#ifdef TABLE_STATS
+	memset(&t->stats, 0, sizeof(t->stats));
+#else
+	(void)t;
+#endif
+}
+
 /*
  * Used for printing table, useful while debugging.
  */
 void table_print(const table *t)
 {
-	table *tablePointer = (table*)t;
-	table_entry *checkElement;
-
-	int index = array_1d_low(t->entries);
-	while(array_1d_has_value(tablePointer->entries,index)){
-		checkElement = array_1d_inspect_value(tablePointer->entries, index);	//Load current slot
-		printf("key->%s value->%s\n",(char*)checkElement->key, (char*)checkElement->value);
-		index++;
+	for (int i = 0; i < t->size; i++) {
+		table_entry e = entry_at(t, i);
+		printf("key->%s value->%s\n",(char*)e.key, (char*)e.value);
 	}
 	printf("\n");
 }
+
+#endif // TABLE_BACKEND_HASH
@@ -0,0 +1,276 @@
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "epoch.h"
+
+/*
+ * Implementation of epoch-based reclamation with three epochs.
+ *
+ * The domain has a global epoch counter. A thread in a critical
+ * section publishes the global epoch it saw when it entered. The
+ * global epoch is only advanced from e to e+1 when every thread in a
+ * critical section has published e, so when the global epoch is e+2,
+ * no thread can still be inside a critical section that started
+ * before e+1. An object retired while the global epoch was e was
+ * unlinked before any such critical section, and can then be freed.
+ *
+ * Each thread keeps its retired objects in three lists, one for each
+ * of the last three epochs. Every RETIRE_BATCH retires, the thread
+ * tries to advance the global epoch and frees the lists that have
+ * become old enough.
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first version.
+ *   2026-10-16: v1.1, handles are aligned to cache lines.
+ */
+
+// Number of retires between attempts to advance the epoch.
+#define RETIRE_BATCH 64
+
+// Bit set in a published epoch while the thread is in a critical
+// section. The epoch itself is stored in the other bits.
+#define ACTIVE 1
+
+// Size of a cache line. Each handle starts on its own cache line, so
+// entering and leaving critical sections only writes to memory that no
+// other thread writes to.
+#define CACHE_LINE 64
+
+// ===========INTERNAL DATA TYPES============
+
+// A retired object.
+typedef struct retired {
+	void *p;
+	free_function free_func;
+	struct retired *next;
+} retired;
+
+struct epoch_thread {
+	// Published epoch << 1 | ACTIVE, or 0.
+	_Alignas(CACHE_LINE) _Atomic uint64_t local;
+	atomic_bool in_use; // True while registered to a thread.
+	epoch_domain *domain;
+	int depth; // Nesting depth of critical sections.
+	unsigned retires; // Number of retires, for RETIRE_BATCH.
+	retired *limbo[3]; // Retired objects, by epoch % 3.
+	uint64_t limbo_epoch[3]; // Epoch of the objects in each list.
+	struct epoch_thread *next; // Next handle of the domain.
+};
+
+struct epoch_domain {
+	_Atomic uint64_t global; // Global epoch.
+	_Atomic(epoch_thread *) threads; // All handles ever created.
+};
+
+// ===========INTERNAL FUNCTION IMPLEMENTATIONS============
+
+/*
+ * Free a list of retired objects.
+ */
+static void free_list(retired *r)
+{
+	while (r != NULL) {
+		retired *next = r->next;
+		r->free_func(r->p);
+		free(r);
+		r = next;
+	}
+}
+
+/*
+ * Advance the global epoch if every thread in a critical section has
+ * seen the current one.
+ */
+static void try_advance(epoch_domain *d)
+{
+	uint64_t g = atomic_load(&d->global);
+	for (epoch_thread *th = atomic_load(&d->threads); th != NULL;
+	     th = th->next) {
+		uint64_t local = atomic_load(&th->local);
+		if ((local & ACTIVE) && (local >> 1) != g) {
+			return;
+		}
+	}
+	atomic_compare_exchange_strong(&d->global, &g, g + 1);
+}
+
+/*
+ * Free the retired lists of a thread that are at least two epochs old.
+ */
+static void collect(epoch_thread *th)
+{
+	uint64_t g = atomic_load(&th->domain->global);
+	for (int b = 0; b < 3; b++) {
+		if (th->limbo[b] != NULL && th->limbo_epoch[b] + 2 <= g) {
+			free_list(th->limbo[b]);
+			th->limbo[b] = NULL;
+		}
+	}
+}
+
+// ===========DATA STRUCTURE INTERFACE IMPLEMENTATION============
+
+/**
+ * epoch_domain_empty() - Create a reclamation domain.
+ *
+ * Return: Pointer to a new domain, or NULL if not enough memory was
+ * available.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+epoch_domain *epoch_domain_empty(void)
+{
+	epoch_domain *d = malloc(sizeof(*d));
+	if (d != NULL) {
+		atomic_init(&d->global, 0);
+		atomic_init(&d->threads, NULL);
+	}
+	return d;
+}
+
+/**
+ * epoch_register() - Register the calling thread with a domain.
+ * @d: Domain to register with.
+ *
+ * A handle released by epoch_unregister is reused if there is one.
+ * Handles are never unlinked, so the list can be walked without locks.
+ *
+ * Return: Handle for the calling thread, or NULL if not enough memory
+ * was available.
+ * Simplified asymptotic complexity analysis : O(number of handles)
+ */
+epoch_thread *epoch_register(epoch_domain *d)
+{
+	for (epoch_thread *th = atomic_load(&d->threads); th != NULL;
+	     th = th->next) {
+		bool free_handle = false;
+		if (atomic_compare_exchange_strong(&th->in_use, &free_handle,
+						   true)) {
+			return th;
+		}
+	}
+	epoch_thread *th = aligned_alloc(CACHE_LINE, sizeof(*th));
+	if (th == NULL) {
+		return NULL;
+	}
+	memset(th, 0, sizeof(*th));
+	atomic_init(&th->local, 0);
+	atomic_init(&th->in_use, true);
+	th->domain = d;
+	th->next = atomic_load(&d->threads);
+	while (!atomic_compare_exchange_weak(&d->threads, &th->next, th)) {
+	}
+	return th;
+}
+
+/**
+ * epoch_unregister() - Unregister a thread from its domain.
+ * @th: Handle of the calling thread, not inside a critical section.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+void epoch_unregister(epoch_thread *th)
+{
+	collect(th);
+	atomic_store(&th->in_use, false);
+}
+
+/**
+ * epoch_enter() - Enter a critical section.
+ * @th: Handle of the calling thread.
+ *
+ * The fence orders the published epoch before all loads of shared
+ * pointers in the critical section. A thread that advances the epoch
+ * and misses the published value therefore ran before those loads, and
+ * everything it retired was already unlinked.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+void epoch_enter(epoch_thread *th)
+{
+	if (th->depth++ > 0) {
+		return;
+	}
+	uint64_t g = atomic_load_explicit(&th->domain->global,
+					  memory_order_relaxed);
+	atomic_store_explicit(&th->local, g << 1 | ACTIVE,
+			      memory_order_relaxed);
+	atomic_thread_fence(memory_order_seq_cst);
+}
+
+/**
+ * epoch_exit() - Leave a critical section.
+ * @th: Handle of the calling thread.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+void epoch_exit(epoch_thread *th)
+{
+	if (--th->depth > 0) {
+		return;
+	}
+	atomic_store_explicit(&th->local, 0, memory_order_release);
+}
+
+/**
+ * epoch_retire() - Free an object when no reader can see it anymore.
+ * @th: Handle of the calling thread.
+ * @p: Object that has been unlinked from all shared structures.
+ * @free_func: Function to be called to free p.
+ *
+ * If no memory is available for the bookkeeping, the object is leaked
+ * rather than freed early.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(1) amortized
+ */
+void epoch_retire(epoch_thread *th, void *p, free_function free_func)
+{
+	retired *r = malloc(sizeof(*r));
+	if (r == NULL) {
+		return;
+	}
+	r->p = p;
+	r->free_func = free_func;
+
+	uint64_t g = atomic_load(&th->domain->global);
+	int b = g % 3;
+	if (th->limbo_epoch[b] != g) {
+		// The list holds objects from epoch g-3 or earlier.
+		free_list(th->limbo[b]);
+		th->limbo[b] = NULL;
+		th->limbo_epoch[b] = g;
+	}
+	r->next = th->limbo[b];
+	th->limbo[b] = r;
+
+	if (++th->retires % RETIRE_BATCH == 0) {
+		try_advance(th->domain);
+		collect(th);
+	}
+}
+
+/**
+ * epoch_domain_kill() - Destroy a reclamation domain.
+ * @d: Domain to destroy.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(retired objects)
+ */
+void epoch_domain_kill(epoch_domain *d)
+{
+	epoch_thread *th = atomic_load(&d->threads);
+	while (th != NULL) {
+		epoch_thread *next = th->next;
+		for (int b = 0; b < 3; b++) {
+			free_list(th->limbo[b]);
+		}
+		free(th);
+		th = next;
+	}
+	free(d);
+}
@@ -0,0 +1,229 @@
+#include <string.h>
+
+#include "hash.h"
+
+/*
+ * Implementation of the built-in hash functions.
+ *
+ * All hashes are built on mix(), which multiplies two 64-bit words into
+ * a 128-bit product and xors its halves. Ints and pointers are one mix
+ * of the value with fixed odd constants. Byte blocks are consumed 16
+ * bytes at a time, each block mixed into a running seed, and the last
+ * 1-16 bytes are read with overlapping loads, so no byte outside the
+ * block is read and short keys take no loop at all.
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first version.
+ *   2026-10-16: v1.1, mix() works without a 128-bit integer type.
+ */
+
+// Odd constants with well spread bits, as used by wyhash.
+#define K0 0x2d358dccaa6c78a5ULL
+#define K1 0x8bb84b93962eacc9ULL
+#define K2 0x4b33a62ed433d4a3ULL
+
+// ===========INTERNAL FUNCTION IMPLEMENTATIONS============
+
+/*
+ * Multiply two words into a 128-bit product and return the xor of its
+ * halves. Compilers without a 128-bit integer type get the same result
+ * from four 32x32->64-bit products.
+ */
+static inline uint64_t mix(uint64_t a, uint64_t b)
+{
+#ifdef __SIZEOF_INT128__
+	__extension__ unsigned __int128 r = (unsigned __int128)a * b;
+	return (uint64_t)r ^ (uint64_t)(r >> 64);
+#else
+	uint64_t a_lo = (uint32_t)a;
+	uint64_t a_hi = a >> 32;
+	uint64_t b_lo = (uint32_t)b;
+	uint64_t b_hi = b >> 32;
+	uint64_t ll = a_lo * b_lo;
+	uint64_t lh = a_lo * b_hi;
+	uint64_t hl = a_hi * b_lo;
+	uint64_t hh = a_hi * b_hi;
+	// Carries out of the low half, at most 2^34.
+	uint64_t mid = (ll >> 32) + (uint32_t)lh + (uint32_t)hl;
+	uint64_t lo = (mid << 32) | (uint32_t)ll;
+	uint64_t hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+	return lo ^ hi;
+#endif
+}
+
+/*
+ * Read 8 or 4 bytes in machine byte order.
+ */
+static inline uint64_t read8(const unsigned char *p)
+{
+	uint64_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline uint64_t read4(const unsigned char *p)
+{
+	uint32_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+/*
+ * Hash a word, for ints and pointers.
+ */
+static inline uint64_t hash_word(uint64_t v)
+{
+	return mix(v ^ K0, K1);
+}
+
+// ===========HASH FUNCTIONS============
+
+/**
+ * hash_int() - Hash an int via a pointer.
+ * @ip: Pointer to the int to be hashed.
+ *
+ * Return: The hash of the int value.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+uint64_t hash_int(const void *ip)
+{
+	const int *n = ip;
+	return hash_word((uint64_t)(unsigned int)*n);
+}
+
+/**
+ * hash_ptr() - Hash a pointer value.
+ * @p: The pointer to be hashed, which is not dereferenced.
+ *
+ * Return: The hash of the address.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+uint64_t hash_ptr(const void *p)
+{
+	return hash_word((uint64_t)(uintptr_t)p);
+}
+
+/**
+ * hash_string() - Hash a NUL-terminated string.
+ * @s: Pointer to the string to be hashed.
+ *
+ * Return: The hash of the bytes of the string, as hash_bytes().
+ * Simplified asymptotic complexity analysis : O(length)
+ */
+uint64_t hash_string(const void *s)
+{
+	return hash_bytes(s, strlen(s));
+}
+
+/**
+ * hash_bytes() - Hash a block of memory.
+ * @p: Pointer to the bytes to be hashed.
+ * @n: Number of bytes.
+ *
+ * Return: The hash of the n bytes.
+ * Simplified asymptotic complexity analysis : O(n)
+ */
+uint64_t hash_bytes(const void *p, size_t n)
+{
+	const unsigned char *b = p;
+	uint64_t seed = K2;
+	uint64_t x;
+	uint64_t y;
+	if (n <= 16) {
+		if (n >= 4) {
+			// Two overlapping pairs of 4-byte reads cover 4-16
+			// bytes.
+			size_t step = (n >> 3) << 2;
+			x = (read4(b) << 32) | read4(b + step);
+			y = (read4(b + n - 4) << 32) | read4(b + n - 4 - step);
+		} else if (n > 0) {
+			x = ((uint64_t)b[0] << 16) | ((uint64_t)b[n >> 1] << 8) |
+			    b[n - 1];
+			y = 0;
+		} else {
+			x = 0;
+			y = 0;
+		}
+	} else {
+		size_t i = n;
+		while (i > 16) {
+			seed = mix(read8(b) ^ K1, read8(b + 8) ^ seed);
+			b += 16;
+			i -= 16;
+		}
+		// The last 16 bytes, which may overlap the last block.
+		x = read8(b + i - 16);
+		y = read8(b + i - 8);
+	}
+	return mix(mix(x ^ K1, y ^ seed) ^ K0, n ^ K1);
+}
+
+/**
+ * hash_int_batch() - Hash a number of ints via pointers.
+ * @keys: Array of n pointers to ints.
+ * @n: Number of keys.
+ * @hashes: Set to the hash_int() of each key.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(n)
+ */
+void hash_int_batch(void **keys, int n, uint64_t *hashes)
+{
+	for (int i = 0; i < n; i++) {
+		hashes[i] = hash_word((uint64_t)(unsigned int)*(int *)keys[i]);
+	}
+}
+
+/**
+ * hash_ptr_batch() - Hash a number of pointer values.
+ * @keys: Array of n pointers, which are not dereferenced.
+ * @n: Number of keys.
+ * @hashes: Set to the hash_ptr() of each key.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(n)
+ */
+void hash_ptr_batch(void **keys, int n, uint64_t *hashes)
+{
+	for (int i = 0; i < n; i++) {
+		hashes[i] = hash_word((uint64_t)(uintptr_t)keys[i]);
+	}
+}
+
+/**
+ * hash_string_batch() - Hash a number of NUL-terminated strings.
+ * @keys: Array of n strings.
+ * @n: Number of keys.
+ * @hashes: Set to the hash_string() of each key.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(total length)
+ */
+void hash_string_batch(void **keys, int n, uint64_t *hashes)
+{
+	for (int i = 0; i < n; i++) {
+		hashes[i] = hash_bytes(keys[i], strlen(keys[i]));
+	}
+}
+
+/**
+ * hash_batch_for() - Get the batch variant of a hash function.
+ * @f: A hash function, or NULL.
+ *
+ * Return: The batch variant of f if f is one of the built-in hash
+ * functions, or NULL otherwise.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+hash_batch_function *hash_batch_for(hash_function *f)
+{
+	if (f == hash_int) {
+		return hash_int_batch;
+	}
+	if (f == hash_ptr) {
+		return hash_ptr_batch;
+	}
+	if (f == hash_string) {
+		return hash_string_batch;
+	}
+	return NULL;
+}
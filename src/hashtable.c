@@ -0,0 +1,1058 @@
+/*
+ * Implementation of the generic table in table.h using an
+ * open-addressing hash index with linear probing.
+ *
+ * The key/value pairs are stored by value in a power-of-two sized
+ * slot array. The home slot of a key is derived from the value
+ * returned by the hash function registered in table_empty_with_hash().
+ * Removal uses backward-shift deletion, so no tombstones are left
+ * behind and probe sequences stay short.
+ *
+ * This implementation is only compiled if TABLE_BACKEND_HASH is
+ * defined, otherwise the array table in arraytable.c is used.
+ *
+ * If TABLE_STATS is defined, each table counts its operations, see
+ * table_get_stats(). A search probes the slots from the home slot up to
+ * the slot of the key or the first empty slot.
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first version.
+ *   2026-10-16: v1.1, added operation counts.
+ *   2026-10-16: v1.2, added memory accounting.
+ *   2026-10-16: v1.3, added snapshots.
+ *   2026-10-16: v1.4, batch operations use the batch variant of a
+ *               built-in hash function from hash.h.
+ *   2026-10-16: v1.5, table_empty_with_hash() returns NULL if not
+ *               enough memory was available.
+ *   2026-10-16: v1.6, table_insert() and table_insert_batch() report a
+ *               failed allocation.
+ */
+#ifdef TABLE_BACKEND_HASH
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "table.h"
+#include "hash.h"
+#include "snapshot.h"
+
+// Initial number of slots, must be a power of two.
+#define INITIAL_CAPACITY 8
+
+// Maximum load factor, expressed as LOAD_NUM/LOAD_DEN.
+#define LOAD_NUM 3
+#define LOAD_DEN 4
+
+// Number of keys whose home slots are prefetched together by the batch
+// operations.
+#define BATCH_GROUP 16
+
+// Smallest number of keys or slots handed to a thread at a time by the
+// parallel operations. Smaller inputs are handled by the calling thread.
+#define PARALLEL_CHUNK 4096
+
+// Add n to an operation count of table t. The counts are added
+// atomically, since lookups may run on several threads at once.
+// Without TABLE_STATS nothing is counted.
+#ifdef TABLE_STATS
+#define STAT_ADD(t, count, n) \
+	__atomic_fetch_add(&((table *)(t))->stats.count, (n), __ATOMIC_RELAXED)
+#else
+#define STAT_ADD(t, count, n) ((void)(t), (void)(n))
+#endif
+
+// ===========INTERNAL DATA TYPES============
+
+// A slot in the hash index. The slot is empty if key is NULL.
+typedef struct table_slot {
+	void *key;
+	void *value;
+	uint64_t hash; // Unscrambled hash value of key.
+} table_slot;
+
+struct table {
+	table_slot *slots;
+	int capacity; // Number of slots, a power of two.
+	int shift; // 64-log2(capacity), used to map a hash to a slot.
+	int size; // Number of occupied slots.
+	compare_function *key_cmp_func;
+	hash_function *key_hash_func;
+	hash_batch_function *key_hash_batch_func; // Or NULL, see hash.h.
+	free_function key_free_func;
+	free_function value_free_func;
+	arena *arena; // Arena for keys and values, or NULL.
+	snapshot *snapshot; // Mapped by table_load_mmap(), or NULL.
+#ifdef TABLE_STATS
+	table_stats stats;
+#endif
+};
+
+// ===========INTERNAL FUNCTION IMPLEMENTATIONS============
+
+/*
+ * Hash a key using the registered hash function. Without a hash
+ * function all keys share the same probe sequence and the table
+ * degrades to a linear scan.
+ */
+static uint64_t key_hash(const table *t, const void *key)
+{
+	if (t->key_hash_func == NULL) {
+		return 0;
+	}
+	return t->key_hash_func(key);
+}
+
+/*
+ * Hash n keys into hashes, with a single call if the hash function has
+ * a batch variant.
+ */
+static void key_hashes(const table *t, void **keys, int n, uint64_t *hashes)
+{
+	if (t->key_hash_batch_func != NULL) {
+		t->key_hash_batch_func(keys, n, hashes);
+		return;
+	}
+	for (int i = 0; i < n; i++) {
+		hashes[i] = key_hash(t, keys[i]);
+	}
+}
+
+/*
+ * Return the home slot for a hash value. Fibonacci hashing scrambles
+ * the bits, so that weak hash functions such as the identity still
+ * spread well over the slots.
+ */
+static int home_slot(const table *t, uint64_t hash)
+{
+	return (int)((hash * 0x9E3779B97F4A7C15ULL) >> t->shift);
+}
+
+/*
+ * Count a key search that probed the given number of slots.
+ */
+static void count_probes(const table *t, int probes)
+{
+#ifdef TABLE_STATS
+	int b = probes > 0 ? 32 - __builtin_clz(probes) : 0;
+	if (b >= TABLE_STATS_PROBE_BUCKETS) {
+		b = TABLE_STATS_PROBE_BUCKETS - 1;
+	}
+	STAT_ADD(t, probes[b], 1);
+	STAT_ADD(t, searches, 1);
+	STAT_ADD(t, probe_total, probes);
+#else
+	(void)t;
+	(void)probes;
+#endif
+}
+
+/*
+ * Count a lookup that found its key if hit is true.
+ */
+static void count_lookup(const table *t, bool hit)
+{
+	STAT_ADD(t, lookups, 1);
+	if (hit) {
+		STAT_ADD(t, hits, 1);
+	} else {
+		STAT_ADD(t, misses, 1);
+	}
+}
+
+/*
+ * Return the slot holding key, or the empty slot where it should be
+ * inserted if the key is not in the table.
+ */
+static int find_slot(const table *t, const void *key, uint64_t hash)
+{
+	int mask = t->capacity - 1;
+	int i = home_slot(t, hash);
+	int probes = 1;
+	while (t->slots[i].key != NULL) {
+		if (t->slots[i].hash == hash) {
+			STAT_ADD(t, compares, 1);
+			if (t->key_cmp_func(t->slots[i].key, key) == 0) {
+				break;
+			}
+		}
+		i = (i + 1) & mask;
+		probes++;
+	}
+	count_probes(t, probes);
+	return i;
+}
+
+/*
+ * Return the first empty slot of the probe sequence of a hash value.
+ */
+static int empty_slot(const table *t, uint64_t hash)
+{
+	int mask = t->capacity - 1;
+	int i = home_slot(t, hash);
+	while (t->slots[i].key != NULL) {
+		i = (i + 1) & mask;
+	}
+	return i;
+}
+
+/*
+ * Allocate a new slot array with the given capacity and move all
+ * pairs to it. Returns false if not enough memory was available, the
+ * table is unchanged in that case.
+ */
+static bool rehash(table *t, int capacity)
+{
+	table_slot *slots = calloc(capacity, sizeof(table_slot));
+	if (slots == NULL) {
+		return false;
+	}
+	table_slot *old_slots = t->slots;
+	int old_capacity = t->capacity;
+
+	t->slots = slots;
+	STAT_ADD(t, allocations, 1);
+	t->capacity = capacity;
+	t->shift = 64;
+	for (int c = capacity; c > 1; c >>= 1) {
+		t->shift--;
+	}
+
+	for (int j = 0; j < old_capacity; j++) {
+		if (old_slots[j].key != NULL) {
+			t->slots[empty_slot(t, old_slots[j].hash)] = old_slots[j];
+		}
+	}
+	free(old_slots);
+	return true;
+}
+
+/*
+ * Insert a key/value pair given the hash value of the key. Returns false
+ * if the table had to grow and not enough memory was available, the
+ * table is unchanged in that case.
+ */
+static bool insert_hashed(table *t, void *key, void *value, uint64_t hash)
+{
+	int i = find_slot(t, key, hash);
+
+	if (t->slots[i].key != NULL) {
+		// Overwrite an existing pair.
+		if (t->key_free_func != NULL) {
+			t->key_free_func(t->slots[i].key);
+		}
+		if (t->value_free_func != NULL) {
+			t->value_free_func(t->slots[i].value);
+		}
+		STAT_ADD(t, overwrites, 1);
+	} else {
+		if ((t->size + 1) * LOAD_DEN > t->capacity * LOAD_NUM) {
+			// Grow before the load factor is exceeded. The key
+			// is not in the table, so it goes to the first
+			// empty slot.
+			if (!rehash(t, t->capacity * 2)) {
+				return false;
+			}
+			i = empty_slot(t, hash);
+		}
+		t->size++;
+		STAT_ADD(t, inserts, 1);
+	}
+	t->slots[i].key = key;
+	t->slots[i].value = value;
+	t->slots[i].hash = hash;
+	return true;
+}
+
+/*
+ * Hash a group of at most BATCH_GROUP keys and prefetch their home
+ * slots, so that the slot cache misses of the group overlap.
+ */
+static void prefetch_group(const table *t, void **keys, int n,
+			   uint64_t *hashes)
+{
+	key_hashes(t, keys, n, hashes);
+	for (int i = 0; i < n; i++) {
+		__builtin_prefetch(&t->slots[home_slot(t, hashes[i])]);
+	}
+}
+
+// ===========DATA STRUCTURE INTERFACE IMPLEMENTATION============
+
+/**
+ * table_empty() - Create an empty table.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Return: Pointer to a new table, or NULL if not enough memory was
+ * available.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+table *table_empty(compare_function *key_cmp_func,
+		   free_function key_free_func,
+		   free_function value_free_func)
+{
+	return table_empty_with_hash(key_cmp_func, NULL, key_free_func,
+				     value_free_func);
+}
+
+/**
+ * table_empty_with_hash() - Create an empty table with a key hash function.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: A pointer to a function (or NULL) to be used to hash keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Return: Pointer to a new table, or NULL if not enough memory was
+ * available.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+table *table_empty_with_hash(compare_function *key_cmp_func,
+			     hash_function *key_hash_func,
+			     free_function key_free_func,
+			     free_function value_free_func)
+{
+	table *t = calloc(1, sizeof(*t));
+	if (t == NULL) {
+		return NULL;
+	}
+	STAT_ADD(t, allocations, 1);
+	t->key_cmp_func = key_cmp_func;
+	t->key_hash_func = key_hash_func;
+	t->key_hash_batch_func = hash_batch_for(key_hash_func);
+	t->key_free_func = key_free_func;
+	t->value_free_func = value_free_func;
+	if (!rehash(t, INITIAL_CAPACITY)) {
+		free(t);
+		return NULL;
+	}
+	return t;
+}
+
+/**
+ * table_from_arrays() - Create a table from arrays of keys and values.
+ * @keys: Array of n keys.
+ * @values: Array of n values, values[i] belongs to keys[i].
+ * @n: Number of pairs.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Without a hash function all keys share one probe sequence, so the
+ * build is quadratic. Use table_from_arrays_with_hash() instead.
+ *
+ * Return: Pointer to a new table, or NULL if not enough memory was
+ * available.
+ * Simplified asymptotic complexity analysis : O(n^2)
+ */
+table *table_from_arrays(void **keys, void **values, int n,
+			 compare_function *key_cmp_func,
+			 free_function key_free_func,
+			 free_function value_free_func)
+{
+	return table_from_arrays_with_hash(keys, values, n, key_cmp_func, NULL,
+					   key_free_func, value_free_func);
+}
+
+/**
+ * table_from_arrays_with_hash() - Create a table from arrays of keys
+ * and values with a key hash function.
+ * @keys: Array of n keys.
+ * @values: Array of n values, values[i] belongs to keys[i].
+ * @n: Number of pairs.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: A pointer to a function (or NULL) to be used to hash keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * The slot array is allocated once at its final size, and the pairs
+ * are inserted in prefetched groups as by table_insert_batch().
+ *
+ * Return: Pointer to a new table, or NULL if not enough memory was
+ * available.
+ * Simplified asymptotic complexity analysis : O(n) expected
+ */
+table *table_from_arrays_with_hash(void **keys, void **values, int n,
+				   compare_function *key_cmp_func,
+				   hash_function *key_hash_func,
+				   free_function key_free_func,
+				   free_function value_free_func)
+{
+	table *t = table_empty_with_hash(key_cmp_func, key_hash_func,
+					 key_free_func, value_free_func);
+	if (t != NULL && !table_insert_batch(t, keys, values, n)) {
+		table_kill(t);
+		return NULL;
+	}
+	return t;
+}
+
+// State shared by the threads of a parallel build.
+typedef struct build_job {
+	const table *t;
+	void **keys;
+	uint64_t *hashes;
+} build_job;
+
+/*
+ * Hash keys [begin, end-1] of a parallel build.
+ */
+static void hash_task(void *arg, int begin, int end)
+{
+	build_job *job = arg;
+	key_hashes(job->t, job->keys + begin, end - begin, job->hashes + begin);
+}
+
+/**
+ * table_from_arrays_parallel() - Create a table from arrays of keys and
+ * values using a thread pool.
+ * @keys: Array of n keys.
+ * @values: Array of n values, values[i] belongs to keys[i].
+ * @n: Number of pairs.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: A pointer to a function (or NULL) to be used to hash keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ * @pool: Thread pool to run the build on.
+ *
+ * The keys are hashed in parallel. The pairs are then placed by the
+ * calling thread in array order, which keeps the last pair for
+ * duplicate keys, with the home slots prefetched a group ahead.
+ *
+ * Return: Pointer to a new table, or NULL if not enough memory was
+ * available.
+ * Simplified asymptotic complexity analysis : O(n) expected
+ */
+table *table_from_arrays_parallel(void **keys, void **values, int n,
+				  compare_function *key_cmp_func,
+				  hash_function *key_hash_func,
+				  free_function key_free_func,
+				  free_function value_free_func,
+				  threadpool *pool)
+{
+	table *t = table_empty_with_hash(key_cmp_func, key_hash_func,
+					 key_free_func, value_free_func);
+	if (t == NULL) {
+		return NULL;
+	}
+	uint64_t *hashes = malloc(n * sizeof(uint64_t));
+	if (hashes == NULL && n > 0) {
+		table_kill(t);
+		return NULL;
+	}
+	STAT_ADD(t, allocations, 1);
+	int capacity = t->capacity;
+	while (n * LOAD_DEN > capacity * LOAD_NUM) {
+		capacity *= 2;
+	}
+	if (capacity != t->capacity && !rehash(t, capacity)) {
+		free(hashes);
+		table_kill(t);
+		return NULL;
+	}
+	build_job job = { .t = t, .keys = keys, .hashes = hashes };
+	threadpool_run(pool, hash_task, &job, n, PARALLEL_CHUNK);
+	for (int i = 0; i < n; i++) {
+		if (i + BATCH_GROUP < n) {
+			__builtin_prefetch(&t->slots[home_slot(t,
+						hashes[i + BATCH_GROUP])]);
+		}
+		insert_hashed(t, keys[i], values[i], hashes[i]);
+	}
+	free(hashes);
+	return t;
+}
+
+/**
+ * table_is_empty() - Check if a table is empty.
+ * @t: Table to check.
+ *
+ * Return: True if table contains no key/value pairs, false otherwise.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+bool table_is_empty(const table *t)
+{
+	return t->size == 0;
+}
+
+/**
+ * table_insert() - Add a key/value pair to a table.
+ * @t: Table to manipulate.
+ * @key: A pointer to the key value.
+ * @value: A pointer to the value value.
+ *
+ * Insert the key/value pair into the table. If the key is already
+ * present, the old key/value pair is replaced (and free'd if free
+ * functions were registered), so table_lookup() returns the latest
+ * added value for a duplicate key.
+ *
+ * Return: True if the pair was inserted, false if not enough memory was
+ * available to grow the table, in which case the table is unchanged.
+ * Simplified asymptotic complexity analysis : O(1) expected, amortized
+ */
+bool table_insert(table *t, void *key, void *value)
+{
+	return insert_hashed(t, key, value, key_hash(t, key));
+}
+
+/**
+ * table_insert_batch() - Add a number of key/value pairs to a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n pointers to key values.
+ * @values: Array of n pointers to value values.
+ * @n: Number of pairs to insert.
+ *
+ * Equivalent to calling table_insert() for each pair in array order.
+ * The slot array is grown once up front for the whole batch. The keys
+ * are then handled in groups, where the home slots of a group are
+ * prefetched before any of its pairs is inserted. The inserts cannot
+ * fail once the slot array has room for all n pairs.
+ *
+ * Return: True if the pairs were inserted, false if not enough memory
+ * was available to grow the table, in which case it is unchanged.
+ * Simplified asymptotic complexity analysis : O(n) expected
+ */
+bool table_insert_batch(table *t, void **keys, void **values, int n)
+{
+	uint64_t hashes[BATCH_GROUP];
+	int capacity = t->capacity;
+	while ((t->size + n) * LOAD_DEN > capacity * LOAD_NUM) {
+		capacity *= 2;
+	}
+	if (capacity != t->capacity && !rehash(t, capacity)) {
+		return false;
+	}
+	for (int i = 0; i < n; i += BATCH_GROUP) {
+		int m = n - i < BATCH_GROUP ? n - i : BATCH_GROUP;
+		prefetch_group(t, keys + i, m, hashes);
+		for (int j = 0; j < m; j++) {
+			insert_hashed(t, keys[i + j], values[i + j], hashes[j]);
+		}
+	}
+	return true;
+}
+
+/**
+ * table_set_mode() - Change the storage mode of a table.
+ * @t: Table to manipulate.
+ * @mode: The new mode.
+ *
+ * The hash table keeps no order, so only TABLE_MODE_UNORDERED is
+ * supported.
+ *
+ * Return: True if mode is TABLE_MODE_UNORDERED, false otherwise.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+bool table_set_mode(table *t, table_mode mode)
+{
+	(void)t;
+	return mode == TABLE_MODE_UNORDERED;
+}
+
+/**
+ * table_lookup() - Look up a given key in a table.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ *
+ * Return: The value corresponding to a given key, or NULL if the key
+ * is not found in the table. If the table contains duplicate keys,
+ * the value that was latest inserted will be returned.
+ * Simplified asymptotic complexity analysis : O(1) expected
+ */
+void *table_lookup(const table *t, const void *key)
+{
+	int i = find_slot(t, key, key_hash(t, key));
+	count_lookup(t, t->slots[i].key != NULL);
+	return t->slots[i].key != NULL ? t->slots[i].value : NULL;
+}
+
+/**
+ * table_lookup_batch() - Look up a number of keys in a table.
+ * @t: Table to inspect.
+ * @keys: Array of n keys to look up.
+ * @n: Number of keys.
+ * @values: Array of n pointers to be filled with the results.
+ *
+ * The keys are handled in groups. All keys of a group are hashed and
+ * their home slots prefetched before the first of them is probed.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(n) expected
+ */
+void table_lookup_batch(const table *t, void **keys, int n, void **values)
+{
+	uint64_t hashes[BATCH_GROUP];
+	for (int i = 0; i < n; i += BATCH_GROUP) {
+		int m = n - i < BATCH_GROUP ? n - i : BATCH_GROUP;
+		prefetch_group(t, keys + i, m, hashes);
+		for (int j = 0; j < m; j++) {
+			int k = find_slot(t, keys[i + j], hashes[j]);
+			count_lookup(t, t->slots[k].key != NULL);
+			values[i + j] = t->slots[k].key != NULL ?
+				t->slots[k].value : NULL;
+		}
+	}
+}
+
+// State shared by the threads of a parallel lookup.
+typedef struct lookup_job {
+	const table *t;
+	void **keys;
+	void **values;
+} lookup_job;
+
+/*
+ * Look up keys [begin, end-1] of a parallel lookup.
+ */
+static void lookup_task(void *arg, int begin, int end)
+{
+	lookup_job *job = arg;
+	table_lookup_batch(job->t, job->keys + begin, end - begin,
+			   job->values + begin);
+}
+
+/**
+ * table_lookup_batch_parallel() - Look up a number of keys in a table
+ * using a thread pool.
+ * @t: Table to inspect.
+ * @keys: Array of n keys to look up.
+ * @n: Number of keys.
+ * @values: Array of n pointers to be filled with the results.
+ * @pool: Thread pool to run the lookups on.
+ *
+ * The keys are split into ranges that are looked up with
+ * table_lookup_batch() by the threads of the pool.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(n / threads) expected
+ */
+void table_lookup_batch_parallel(const table *t, void **keys, int n,
+				 void **values, threadpool *pool)
+{
+	lookup_job job = { .t = t, .keys = keys, .values = values };
+	threadpool_run(pool, lookup_task, &job, n, PARALLEL_CHUNK);
+}
+
+/**
+ * table_remove() - Remove a key/value pair in the table.
+ * @t: Table to manipulate.
+ * @key: Key for which to remove pair.
+ *
+ * Any matching duplicates will be removed. Will call any free
+ * functions set for keys/values. Does nothing if key is not found in
+ * the table.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(1) expected
+ */
+void table_remove(table *t, const void *key)
+{
+	int mask = t->capacity - 1;
+	int i = find_slot(t, key, key_hash(t, key));
+
+	if (t->slots[i].key == NULL) {
+		return;
+	}
+	if (t->key_free_func != NULL) {
+		t->key_free_func(t->slots[i].key);
+	}
+	if (t->value_free_func != NULL) {
+		t->value_free_func(t->slots[i].value);
+	}
+	t->size--;
+	STAT_ADD(t, removes, 1);
+
+	// Backward-shift deletion: move later members of the probe
+	// sequence into the hole unless that would put them before
+	// their home slot.
+	int j = i;
+	for (;;) {
+		j = (j + 1) & mask;
+		if (t->slots[j].key == NULL) {
+			break;
+		}
+		int home = home_slot(t, t->slots[j].hash);
+		// Distance from home to j and from home to the hole i,
+		// counted along the probe direction.
+		if (((j - home) & mask) >= ((j - i) & mask)) {
+			t->slots[i] = t->slots[j];
+			i = j;
+		}
+	}
+	t->slots[i].key = NULL;
+	t->slots[i].value = NULL;
+}
+
+/**
+ * table_foreach() - Call a function for each key/value pair in a table.
+ * @t: Table to inspect.
+ * @inspect_func: Function called with the key and value of each pair.
+ *
+ * The pairs are visited in slot order.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(capacity)
+ */
+void table_foreach(const table *t, inspect_callback_pair inspect_func)
+{
+	for (int i = 0; i < t->capacity; i++) {
+		if (t->slots[i].key != NULL) {
+			inspect_func(t->slots[i].key, t->slots[i].value);
+		}
+	}
+}
+
+/**
+ * table_iter_begin() - Start iterating over a table.
+ * @t: Table to iterate over.
+ * @it: Iterator to initialize.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+void table_iter_begin(const table *t, table_iter *it)
+{
+	it->t = t;
+	it->index = 0;
+}
+
+/**
+ * table_iter_next() - Get the next key/value pair of an iteration.
+ * @it: Iterator started by table_iter_begin().
+ * @key: Set to the key of the next pair.
+ * @value: Set to the value of the next pair.
+ *
+ * Skips the empty slots after the previous pair.
+ *
+ * Return: True if a pair was returned, false if all pairs have been
+ * visited.
+ * Simplified asymptotic complexity analysis : O(1) amortized
+ */
+bool table_iter_next(table_iter *it, void **key, void **value)
+{
+	const table *t = it->t;
+	while (it->index < t->capacity) {
+		const table_slot *s = &t->slots[it->index++];
+		if (s->key != NULL) {
+			*key = s->key;
+			*value = s->value;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * table_arena() - Get the memory arena owned by a table.
+ * @t: Table to inspect.
+ *
+ * Return: The arena of the table, or NULL if not enough memory was
+ * available.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+arena *table_arena(table *t)
+{
+	if (t->arena == NULL) {
+		t->arena = arena_empty();
+	}
+	return t->arena;
+}
+
+/**
+ * table_kill() - Destroy a table.
+ * @t: Table to destroy.
+ *
+ * Return all dynamic memory used by the table and its elements. If a
+ * free_func was registered for keys and/or values at table creation,
+ * it is called each element to free any user-allocated memory
+ * occupied by the element values.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(n)
+ */
+void table_kill(table *t)
+{
+	for (int i = 0; i < t->capacity; i++) {
+		if (t->slots[i].key != NULL) {
+			if (t->key_free_func != NULL) {
+				t->key_free_func(t->slots[i].key);
+			}
+			if (t->value_free_func != NULL) {
+				t->value_free_func(t->slots[i].value);
+			}
+		}
+	}
+	free(t->slots);
+	if (t->arena != NULL) {
+		arena_kill(t->arena);
+	}
+	if (t->snapshot != NULL) {
+		snapshot_kill(t->snapshot);
+	}
+	free(t);
+}
+
+/*
+ * Call the free functions for the pairs in slots [begin, end-1].
+ */
+static void kill_task(void *arg, int begin, int end)
+{
+	table *t = arg;
+	for (int i = begin; i < end; i++) {
+		if (t->slots[i].key != NULL) {
+			if (t->key_free_func != NULL) {
+				t->key_free_func(t->slots[i].key);
+			}
+			if (t->value_free_func != NULL) {
+				t->value_free_func(t->slots[i].value);
+			}
+			t->slots[i].key = NULL;
+		}
+	}
+}
+
+/**
+ * table_kill_parallel() - Destroy a table using a thread pool.
+ * @t: Table to destroy.
+ * @pool: Thread pool to run the free functions on.
+ *
+ * As table_kill(), but the free functions are called for ranges of the
+ * slots by the threads of the pool. The freed slots are cleared, so
+ * table_kill() only releases the slot array.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(capacity / threads)
+ */
+void table_kill_parallel(table *t, threadpool *pool)
+{
+	if (t->key_free_func != NULL || t->value_free_func != NULL) {
+		threadpool_run(pool, kill_task, t, t->capacity, PARALLEL_CHUNK);
+	}
+	table_kill(t);
+}
+
+/**
+ * table_save() - Write the pairs of a table to a snapshot file.
+ * @t: Table to save.
+ * @path: Name of the file to write.
+ * @key_size_func: A pointer to a function that returns the number of
+ *		   bytes of a key.
+ * @value_size_func: A pointer to a function that returns the number of
+ *		     bytes of a value.
+ *
+ * Return: True if the snapshot was saved, false with errno set
+ * otherwise.
+ * Simplified asymptotic complexity analysis : O(n log n + bytes)
+ */
+bool table_save(const table *t, const char *path,
+		size_function *key_size_func,
+		size_function *value_size_func)
+{
+	int n = t->size;
+	void **keys = malloc((n > 0 ? n : 1) * sizeof(void *));
+	void **values = malloc((n > 0 ? n : 1) * sizeof(void *));
+	bool ok = false;
+	if (keys != NULL && values != NULL) {
+		int j = 0;
+		for (int i = 0; i < t->capacity; i++) {
+			if (t->slots[i].key != NULL) {
+				keys[j] = t->slots[i].key;
+				values[j] = t->slots[i].value;
+				j++;
+			}
+		}
+		ok = snapshot_save(path, keys, values, n, t->key_cmp_func,
+				   key_size_func, value_size_func);
+	}
+	free(keys);
+	free(values);
+	return ok;
+}
+
+/**
+ * table_load_mmap() - Create a table from a snapshot file.
+ * @path: Name of a file written by table_save().
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: A pointer to a function (or NULL) to be used to hash
+ *		   keys.
+ *
+ * The slots are sized for the pairs of the snapshot and point to the
+ * keys and values in the mapping. The keys of a snapshot are distinct,
+ * so each goes to the first empty slot of its probe sequence without
+ * being compared.
+ *
+ * Return: Pointer to a new table, or NULL with errno set if the file
+ * could not be loaded.
+ * Simplified asymptotic complexity analysis : O(bytes)
+ */
+table *table_load_mmap(const char *path, compare_function *key_cmp_func,
+		       hash_function *key_hash_func)
+{
+	snapshot *s = snapshot_load(path);
+	if (s == NULL) {
+		return NULL;
+	}
+	table *t = table_empty_with_hash(key_cmp_func, key_hash_func, NULL,
+					 NULL);
+	if (t == NULL) {
+		snapshot_kill(s);
+		errno = ENOMEM;
+		return NULL;
+	}
+	int n = snapshot_size(s);
+	int capacity = t->capacity;
+	while (n * LOAD_DEN > capacity * LOAD_NUM) {
+		capacity *= 2;
+	}
+	if (capacity != t->capacity && !rehash(t, capacity)) {
+		table_kill(t);
+		snapshot_kill(s);
+		errno = ENOMEM;
+		return NULL;
+	}
+	for (int i = 0; i < n; i++) {
+		void *key = snapshot_key(s, i);
+		uint64_t hash = key_hash(t, key);
+		table_slot *slot = &t->slots[empty_slot(t, hash)];
+		slot->key = key;
+		slot->value = snapshot_value(s, i);
+		slot->hash = hash;
+	}
+	t->size = n;
+	t->snapshot = s;
+	return t;
+}
+
+/**
+ * table_memory_usage() - Get the memory allocated by a table.
+ * @t: Table to inspect.
+ *
+ * Return: The number of bytes, as table_memory_breakdown() without
+ * size functions.
+ * Simplified asymptotic complexity analysis : O(1), plus the number of
+ * arena blocks
+ */
+size_t table_memory_usage(const table *t)
+{
+	table_memory mem;
+	table_memory_breakdown(t, NULL, NULL, &mem);
+	return mem.total;
+}
+
+/**
+ * table_memory_breakdown() - Get the memory used by a table, by part.
+ * @t: Table to inspect.
+ * @key_size_func: A pointer to a function (or NULL) that returns the
+ *		   bytes owned by a key.
+ * @value_size_func: A pointer to a function (or NULL) that returns the
+ *		     bytes owned by a value.
+ * @mem: Set to the memory used by each part of the table.
+ *
+ * The key and value of an occupied slot are its entry, and the stored
+ * hash value is its index. Empty slots are slack.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(capacity) if a size
+ * function is given, otherwise as table_memory_usage()
+ */
+void table_memory_breakdown(const table *t, size_function *key_size_func,
+			    size_function *value_size_func,
+			    table_memory *mem)
+{
+	memset(mem, 0, sizeof(*mem));
+	mem->pairs = t->size;
+	mem->table = sizeof(*t);
+	mem->entries = (size_t)t->size * offsetof(table_slot, hash);
+	mem->index = (size_t)t->size *
+		     (sizeof(table_slot) - offsetof(table_slot, hash));
+	mem->slack = (size_t)(t->capacity - t->size) * sizeof(table_slot);
+	if (t->arena != NULL) {
+		mem->arena = arena_memory_usage(t->arena);
+	}
+	if (t->snapshot != NULL) {
+		mem->mapped = snapshot_bytes(t->snapshot);
+	}
+	if (key_size_func != NULL || value_size_func != NULL) {
+		for (int i = 0; i < t->capacity; i++) {
+			const table_slot *s = &t->slots[i];
+			if (s->key == NULL) {
+				continue;
+			}
+			if (key_size_func != NULL) {
+				mem->keys += key_size_func(s->key);
+			}
+			if (value_size_func != NULL) {
+				mem->values += value_size_func(s->value);
+			}
+		}
+	}
+	mem->total = mem->table + mem->entries + mem->index + mem->slack +
+		     mem->arena + mem->mapped + mem->keys + mem->values;
+}
+
+/**
+ * table_get_stats() - Get the operation counts of a table.
+ * @t: Table to inspect.
+ * @stats: Set to the counts since the table was created or
+ *	   table_reset_stats() was last called.
+ *
+ * Return: True if the counts are kept, false otherwise.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+bool table_get_stats(const table *t, table_stats *stats)
+{
+#ifdef TABLE_STATS
+	*stats = t->stats;
+	return true;
+#else
+	(void)t;
+	memset(stats, 0, sizeof(*stats));
+	return false;
+#endif
+}
+
+/**
+ * table_reset_stats() - Set the operation counts of a table to zero.
+ * @t: Table to manipulate.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+void table_reset_stats(table *t)
+{
+#ifdef TABLE_STATS
+	memset(&t->stats, 0, sizeof(t->stats));
+#else
+	(void)t;
+#endif
+}
+
+/*
+ * Used for printing table, useful while debugging. Assumes that keys
+ * and values are strings.
+ */
+void table_print(const table *t)
+{
+	for (int i = 0; i < t->capacity; i++) {
+		if (t->slots[i].key != NULL) {
+			printf("key->%s value->%s\n", (char *)t->slots[i].key,
+			       (char *)t->slots[i].value);
+		}
+	}
+	printf("\n");
+}
+
+#endif // TABLE_BACKEND_HASH
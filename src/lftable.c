@@ -0,0 +1,285 @@
+#include <stdatomic.h>
+#include <stdlib.h>
+
+#include "lftable.h"
+
+/*
+ * Implementation of a lock-free table with open addressing and linear
+ * probing.
+ *
+ * A slot is a key and a value pointer. The key of an empty slot is
+ * NULL. A slot is claimed for a key with a compare-and-swap on the key
+ * and is then bound to that key for the lifetime of the table, so a
+ * probe sequence never changes once a reader has walked it. The value
+ * pointer is NULL while the key is absent and is replaced with an
+ * atomic exchange, which makes insert and remove a single store once
+ * the slot is found. The old value is retired to the epoch domain.
+ *
+ * A lookup only loads pointers and stops at the first empty slot or at
+ * most after visiting every slot, so it is wait-free.
+ *
+ * Removed keys keep their slots. Giving a slot to another key would
+ * let two inserts of the same key claim different slots, and a reader
+ * could pair the new key with the old value, so the table never
+ * reclaims slots and instead bounds the distinct keys ever inserted.
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first version.
+ *   2026-10-16: v1.1, the bound on distinct keys is documented.
+ */
+
+// ===========INTERNAL DATA TYPES============
+
+typedef struct lftable_slot {
+	_Atomic(void *) key;
+	_Atomic(void *) value;
+} lftable_slot;
+
+struct lftable {
+	lftable_slot *slots;
+	int capacity; // Number of slots, a power of two.
+	int shift; // 64-log2(capacity), used to map a hash to a slot.
+	epoch_domain *domain;
+	compare_function *key_cmp_func;
+	hash_function *key_hash_func;
+	free_function key_free_func;
+	free_function value_free_func;
+};
+
+// ===========INTERNAL FUNCTION IMPLEMENTATIONS============
+
+/*
+ * Map the hash value of a key to its home slot with Fibonacci hashing.
+ */
+static int home_slot(const lftable *t, const void *key)
+{
+	uint64_t h = t->key_hash_func(key) * 0x9E3779B97F4A7C15ULL;
+	return t->shift < 64 ? (int)(h >> t->shift) : 0;
+}
+
+/*
+ * Return the slot bound to key, or NULL if the key has never been
+ * inserted.
+ */
+static lftable_slot *find_slot(const lftable *t, const void *key)
+{
+	int mask = t->capacity - 1;
+	int i = home_slot(t, key);
+	for (int probes = 0; probes < t->capacity; probes++) {
+		void *k = atomic_load_explicit(&t->slots[i].key,
+					       memory_order_acquire);
+		if (k == NULL) {
+			return NULL;
+		}
+		if (t->key_cmp_func(k, key) == 0) {
+			return &t->slots[i];
+		}
+		i = (i + 1) & mask;
+	}
+	return NULL;
+}
+
+// ===========DATA STRUCTURE INTERFACE IMPLEMENTATION============
+
+/**
+ * lftable_empty() - Create an empty lock-free table.
+ * @max_keys: Largest number of distinct keys that may ever be inserted,
+ *	      counting removed keys.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: A pointer to a function to be used to hash keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * The slot array has at least twice as many slots as max_keys, so the
+ * probe sequences stay short even when the table is full.
+ *
+ * Return: Pointer to a new table, or NULL if not enough memory was
+ * available.
+ * Simplified asymptotic complexity analysis : O(max_keys)
+ */
+lftable *lftable_empty(int max_keys,
+		       compare_function *key_cmp_func,
+		       hash_function *key_hash_func,
+		       free_function key_free_func,
+		       free_function value_free_func)
+{
+	lftable *t = malloc(sizeof(*t));
+	if (t == NULL) {
+		return NULL;
+	}
+	t->capacity = 1;
+	t->shift = 64;
+	while (t->capacity < 2 * max_keys) {
+		t->capacity *= 2;
+		t->shift--;
+	}
+	t->slots = calloc(t->capacity, sizeof(lftable_slot));
+	t->domain = epoch_domain_empty();
+	if (t->slots == NULL || t->domain == NULL) {
+		free(t->slots);
+		if (t->domain != NULL) {
+			epoch_domain_kill(t->domain);
+		}
+		free(t);
+		return NULL;
+	}
+	t->key_cmp_func = key_cmp_func;
+	t->key_hash_func = key_hash_func;
+	t->key_free_func = key_free_func;
+	t->value_free_func = value_free_func;
+	return t;
+}
+
+/**
+ * lftable_attach() - Register the calling thread with a table.
+ * @t: Table that the thread will use.
+ *
+ * Return: Handle for the calling thread, or NULL if not enough memory
+ * was available.
+ * Simplified asymptotic complexity analysis : O(threads)
+ */
+epoch_thread *lftable_attach(lftable *t)
+{
+	return epoch_register(t->domain);
+}
+
+/**
+ * lftable_detach() - Unregister a thread from a table.
+ * @th: Handle returned by lftable_attach().
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+void lftable_detach(epoch_thread *th)
+{
+	epoch_unregister(th);
+}
+
+/**
+ * lftable_insert() - Add a key/value pair to a table.
+ * @t: Table to manipulate.
+ * @th: Handle of the calling thread.
+ * @key: A pointer to the key value.
+ * @value: A pointer to the value value, not NULL.
+ *
+ * Return: True if the pair was inserted, false if the table is full,
+ * which cannot happen before max_keys distinct keys have been inserted.
+ * Simplified asymptotic complexity analysis : O(1) expected
+ */
+bool lftable_insert(lftable *t, epoch_thread *th, void *key, void *value)
+{
+	int mask = t->capacity - 1;
+	int i = home_slot(t, key);
+	epoch_enter(th);
+	for (int probes = 0; probes < t->capacity; probes++) {
+		lftable_slot *s = &t->slots[i];
+		void *k = atomic_load_explicit(&s->key, memory_order_acquire);
+		bool claimed = false;
+		if (k == NULL) {
+			// On failure k is set to the key that won the slot.
+			claimed = atomic_compare_exchange_strong(&s->key, &k, key);
+		}
+		if (claimed || t->key_cmp_func(k, key) == 0) {
+			void *old = atomic_exchange(&s->value, value);
+			if (!claimed && t->key_free_func != NULL) {
+				// The slot keeps its first key.
+				t->key_free_func(key);
+			}
+			if (old != NULL && t->value_free_func != NULL) {
+				epoch_retire(th, old, t->value_free_func);
+			}
+			epoch_exit(th);
+			return true;
+		}
+		i = (i + 1) & mask;
+	}
+	epoch_exit(th);
+	return false;
+}
+
+/**
+ * lftable_lookup() - Look up a given key in a table.
+ * @t: Table to inspect.
+ * @th: Handle of the calling thread.
+ * @key: Key to look up.
+ *
+ * Return: The value corresponding to a given key, or NULL if the key
+ * is not found in the table.
+ * Simplified asymptotic complexity analysis : O(1) expected
+ */
+void *lftable_lookup(lftable *t, epoch_thread *th, const void *key)
+{
+	void *value = NULL;
+	epoch_enter(th);
+	lftable_slot *s = find_slot(t, key);
+	if (s != NULL) {
+		value = atomic_load_explicit(&s->value, memory_order_acquire);
+	}
+	epoch_exit(th);
+	return value;
+}
+
+/**
+ * lftable_remove() - Remove a key/value pair in the table.
+ * @t: Table to manipulate.
+ * @th: Handle of the calling thread.
+ * @key: Key for which to remove pair.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(1) expected
+ */
+void lftable_remove(lftable *t, epoch_thread *th, const void *key)
+{
+	epoch_enter(th);
+	lftable_slot *s = find_slot(t, key);
+	if (s != NULL) {
+		void *old = atomic_exchange(&s->value, NULL);
+		if (old != NULL && t->value_free_func != NULL) {
+			epoch_retire(th, old, t->value_free_func);
+		}
+	}
+	epoch_exit(th);
+}
+
+/**
+ * lftable_is_empty() - Check if a table is empty.
+ * @t: Table to check.
+ *
+ * Return: True if table contains no key/value pairs, false otherwise.
+ * Simplified asymptotic complexity analysis : O(capacity)
+ */
+bool lftable_is_empty(lftable *t)
+{
+	for (int i = 0; i < t->capacity; i++) {
+		if (atomic_load(&t->slots[i].value) != NULL) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * lftable_kill() - Destroy a table.
+ * @t: Table to destroy.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(capacity)
+ */
+void lftable_kill(lftable *t)
+{
+	for (int i = 0; i < t->capacity; i++) {
+		void *key = atomic_load(&t->slots[i].key);
+		void *value = atomic_load(&t->slots[i].value);
+		if (key != NULL && t->key_free_func != NULL) {
+			t->key_free_func(key);
+		}
+		if (value != NULL && t->value_free_func != NULL) {
+			t->value_free_func(value);
+		}
+	}
+	epoch_domain_kill(t->domain);
+	free(t->slots);
+	free(t);
+}
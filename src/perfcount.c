@@ -0,0 +1,246 @@
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+#include "perfcount.h"
+
+/*
+ * Implementation of hardware performance counters with perf_event_open.
+ *
+ * Every event is a separate file descriptor, disabled on open. The
+ * events are read with their enabled and running times. If the kernel
+ * has more events than hardware counters, it multiplexes them, and a
+ * count is scaled by enabled/running to estimate the full count. A
+ * reset only clears the value, not the times, so the times are read on
+ * start and the count is scaled by how much they grew since. On systems
+ * other than Linux no event is available.
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first version.
+ *   2026-10-16: v1.1, counts are scaled by the times since the start.
+ */
+
+// ===========INTERNAL DATA TYPES============
+
+struct perfcount {
+	int fds[PERFCOUNT_EVENTS]; // Descriptor of each event, or -1.
+	uint64_t enabled[PERFCOUNT_EVENTS]; // Time enabled at the start.
+	uint64_t running[PERFCOUNT_EVENTS]; // Time running at the start.
+	int error; // errno of the first event that failed to open.
+};
+
+static const char *event_names[PERFCOUNT_EVENTS] = {
+	"cycles",
+	"instructions",
+	"cache_misses",
+	"branch_misses",
+};
+
+// ===========INTERNAL FUNCTION IMPLEMENTATIONS============
+
+#ifdef __linux__
+// perf_event configuration of each event.
+static const unsigned long long event_configs[PERFCOUNT_EVENTS] = {
+	PERF_COUNT_HW_CPU_CYCLES,
+	PERF_COUNT_HW_INSTRUCTIONS,
+	PERF_COUNT_HW_CACHE_MISSES,
+	PERF_COUNT_HW_BRANCH_MISSES,
+};
+
+/*
+ * Open a disabled hardware event counting the calling thread in user
+ * space. Returns the descriptor, or -1 with errno set.
+ */
+static int open_event(perfcount_event event)
+{
+	struct perf_event_attr attr;
+	memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = PERF_TYPE_HARDWARE;
+	attr.config = event_configs[event];
+	attr.disabled = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+			   PERF_FORMAT_TOTAL_TIME_RUNNING;
+	return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+/*
+ * Read the value, time enabled and time running of an event. Returns
+ * false if the event could not be read.
+ */
+static bool read_event(int fd, uint64_t data[3])
+{
+	return read(fd, data, 3 * sizeof(uint64_t)) ==
+	       (ssize_t)(3 * sizeof(uint64_t));
+}
+#else
+static int open_event(perfcount_event event)
+{
+	(void)event;
+	errno = ENOSYS;
+	return -1;
+}
+
+static bool read_event(int fd, uint64_t data[3])
+{
+	(void)fd;
+	(void)data;
+	return false;
+}
+#endif
+
+// ===========DATA STRUCTURE INTERFACE IMPLEMENTATION============
+
+/**
+ * perfcount_empty() - Open a set of counters for the calling thread.
+ *
+ * Return: Pointer to a new counter set, or NULL if not enough memory
+ * was available.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+perfcount *perfcount_empty(void)
+{
+	perfcount *p = malloc(sizeof(*p));
+	if (p == NULL) {
+		return NULL;
+	}
+	p->error = 0;
+	for (int e = 0; e < PERFCOUNT_EVENTS; e++) {
+		p->enabled[e] = 0;
+		p->running[e] = 0;
+		p->fds[e] = open_event(e);
+		if (p->fds[e] < 0 && p->error == 0) {
+			p->error = errno;
+		}
+	}
+	return p;
+}
+
+/**
+ * perfcount_available() - Check if an event is counted.
+ * @p: Counter set to inspect.
+ * @event: Event to check.
+ *
+ * Return: True if the event could be opened, false otherwise.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+bool perfcount_available(const perfcount *p, perfcount_event event)
+{
+	return p->fds[event] >= 0;
+}
+
+/**
+ * perfcount_error() - Get the reason why events are unavailable.
+ * @p: Counter set to inspect.
+ *
+ * Return: The errno of the first event that could not be opened, or 0
+ * if all events are available.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+int perfcount_error(const perfcount *p)
+{
+	return p->error;
+}
+
+/**
+ * perfcount_event_name() - Get the name of an event.
+ * @event: Event to name.
+ *
+ * Return: A short name, e.g. "cycles".
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+const char *perfcount_event_name(perfcount_event event)
+{
+	return event_names[event];
+}
+
+/**
+ * perfcount_start() - Reset the counters and start counting.
+ * @p: Counter set to start.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+void perfcount_start(perfcount *p)
+{
+#ifdef __linux__
+	for (int e = 0; e < PERFCOUNT_EVENTS; e++) {
+		uint64_t data[3];
+		if (p->fds[e] >= 0) {
+			ioctl(p->fds[e], PERF_EVENT_IOC_RESET, 0);
+			if (read_event(p->fds[e], data)) {
+				p->enabled[e] = data[1];
+				p->running[e] = data[2];
+			}
+			ioctl(p->fds[e], PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+#else
+	(void)p;
+#endif
+}
+
+/**
+ * perfcount_stop() - Stop counting and read the counters.
+ * @p: Counter set to stop.
+ * @counts: Set to the count of each event since perfcount_start().
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+void perfcount_stop(perfcount *p, uint64_t counts[PERFCOUNT_EVENTS])
+{
+#ifdef __linux__
+	// Stop all events before reading any, so that the reads are not
+	// counted.
+	for (int e = 0; e < PERFCOUNT_EVENTS; e++) {
+		if (p->fds[e] >= 0) {
+			ioctl(p->fds[e], PERF_EVENT_IOC_DISABLE, 0);
+		}
+	}
+#endif
+	// Scale each count for multiplexing by the times since the start.
+	// An event that could not be read or never ran counts 0.
+	for (int e = 0; e < PERFCOUNT_EVENTS; e++) {
+		uint64_t data[3];
+		counts[e] = 0;
+		if (p->fds[e] < 0 || !read_event(p->fds[e], data)) {
+			continue;
+		}
+		uint64_t enabled = data[1] - p->enabled[e];
+		uint64_t running = data[2] - p->running[e];
+		if (running == 0) {
+			continue;
+		}
+		counts[e] = data[0];
+		if (running < enabled) {
+			counts[e] = (uint64_t)((double)data[0] * enabled / running);
+		}
+	}
+}
+
+/**
+ * perfcount_kill() - Close a counter set.
+ * @p: Counter set to close.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+void perfcount_kill(perfcount *p)
+{
+	for (int e = 0; e < PERFCOUNT_EVENTS; e++) {
+		if (p->fds[e] >= 0) {
+			close(p->fds[e]);
+		}
+	}
+	free(p);
+}
@@ -0,0 +1,382 @@
+#include <stdatomic.h>
+#include <stdlib.h>
+
+#include "rcutable.h"
+
+/*
+ * Implementation of a read-copy-update table with open addressing and
+ * linear probing.
+ *
+ * The pairs are immutable entries that are never changed once a
+ * reader may see them. The index is an array of entry pointers, and
+ * the table holds a pointer to the current index. The writer changes
+ * the table only with single pointer stores:
+ *
+ *   - insert of a new key stores a new entry into a free slot,
+ *   - insert of an existing key stores a new entry over the old one,
+ *   - remove stores TOMBSTONE over the entry, so probe sequences that
+ *     pass the slot stay intact,
+ *   - when the index is too full, a new index is built with the live
+ *     entries and the table pointer is switched to it.
+ *
+ * The replaced entries and indexes are retired to the epoch domain.
+ * Readers see either the old or the new state of each slot and never
+ * wait or write to shared memory.
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first version.
+ *   2026-10-16: v1.1, a lookup uses the entry that matched its key.
+ */
+
+// Initial number of slots, must be a power of two.
+#define INITIAL_CAPACITY 8
+
+// Maximum share of used slots (entries and tombstones), expressed as
+// LOAD_NUM/LOAD_DEN.
+#define LOAD_NUM 3
+#define LOAD_DEN 4
+
+// Marker for a slot whose entry has been removed.
+#define TOMBSTONE ((rcu_entry *)&tombstone)
+
+// ===========INTERNAL DATA TYPES============
+
+typedef struct rcu_entry {
+	void *key;
+	void *value;
+	uint64_t hash;
+	const struct rcutable *t; // Table, for the free functions.
+} rcu_entry;
+
+typedef struct rcu_index {
+	int capacity; // Number of slots, a power of two.
+	int shift; // 64-log2(capacity), used to map a hash to a slot.
+	int used; // Number of slots that are not NULL.
+	_Atomic(rcu_entry *) slots[];
+} rcu_index;
+
+struct rcutable {
+	_Atomic(rcu_index *) index;
+	int size; // Number of pairs, only used by the writer.
+	epoch_domain *domain;
+	compare_function *key_cmp_func;
+	hash_function *key_hash_func;
+	free_function key_free_func;
+	free_function value_free_func;
+};
+
+static char tombstone;
+
+// ===========INTERNAL FUNCTION IMPLEMENTATIONS============
+
+/*
+ * Allocate an empty index with the given number of slots.
+ */
+static rcu_index *new_index(int capacity)
+{
+	rcu_index *idx = calloc(1, sizeof(*idx) +
+				capacity * sizeof(_Atomic(rcu_entry *)));
+	if (idx == NULL) {
+		return NULL;
+	}
+	idx->capacity = capacity;
+	idx->shift = 64;
+	for (int c = capacity; c > 1; c >>= 1) {
+		idx->shift--;
+	}
+	return idx;
+}
+
+/*
+ * Map a hash value to its home slot with Fibonacci hashing.
+ */
+static int home_slot(const rcu_index *idx, uint64_t hash)
+{
+	uint64_t h = hash * 0x9E3779B97F4A7C15ULL;
+	return idx->shift < 64 ? (int)(h >> idx->shift) : 0;
+}
+
+/*
+ * Return the slot of key in idx, or -1 if the key is not in the index.
+ * The entry that matched is returned through entry, since a reader that
+ * loads the slot again may see an entry of another key stored there by
+ * the writer in between.
+ */
+static int find_slot(const rcutable *t, rcu_index *idx,
+		     const void *key, uint64_t hash, rcu_entry **entry)
+{
+	int mask = idx->capacity - 1;
+	int i = home_slot(idx, hash);
+	for (int probes = 0; probes < idx->capacity; probes++) {
+		rcu_entry *e = atomic_load_explicit(&idx->slots[i],
+						    memory_order_acquire);
+		if (e == NULL) {
+			return -1;
+		}
+		if (e != TOMBSTONE && e->hash == hash &&
+		    t->key_cmp_func(e->key, key) == 0) {
+			*entry = e;
+			return i;
+		}
+		i = (i + 1) & mask;
+	}
+	return -1;
+}
+
+/*
+ * Free an entry together with its key and value.
+ */
+static void free_entry(void *p)
+{
+	rcu_entry *e = p;
+	if (e->t->key_free_func != NULL) {
+		e->t->key_free_func(e->key);
+	}
+	if (e->t->value_free_func != NULL) {
+		e->t->value_free_func(e->value);
+	}
+	free(e);
+}
+
+/*
+ * Publish a new index holding the live entries of the current one.
+ * The capacity is doubled unless most used slots are tombstones.
+ * Returns false if not enough memory was available.
+ */
+static bool rebuild(rcutable *t, epoch_thread *th)
+{
+	rcu_index *old = atomic_load_explicit(&t->index, memory_order_relaxed);
+	int capacity = old->capacity;
+	if ((t->size + 1) * LOAD_DEN > capacity * LOAD_NUM / 2) {
+		capacity *= 2;
+	}
+	rcu_index *idx = new_index(capacity);
+	if (idx == NULL) {
+		return false;
+	}
+	int mask = capacity - 1;
+	for (int j = 0; j < old->capacity; j++) {
+		rcu_entry *e = atomic_load_explicit(&old->slots[j],
+						    memory_order_relaxed);
+		if (e != NULL && e != TOMBSTONE) {
+			int i = home_slot(idx, e->hash);
+			while (atomic_load_explicit(&idx->slots[i],
+						    memory_order_relaxed) != NULL) {
+				i = (i + 1) & mask;
+			}
+			atomic_init(&idx->slots[i], e);
+			idx->used++;
+		}
+	}
+	atomic_store_explicit(&t->index, idx, memory_order_release);
+	epoch_retire(th, old, free);
+	return true;
+}
+
+// ===========DATA STRUCTURE INTERFACE IMPLEMENTATION============
+
+/**
+ * rcutable_empty() - Create an empty read-copy-update table.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: A pointer to a function to be used to hash keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Return: Pointer to a new table, or NULL if not enough memory was
+ * available.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+rcutable *rcutable_empty(compare_function *key_cmp_func,
+			 hash_function *key_hash_func,
+			 free_function key_free_func,
+			 free_function value_free_func)
+{
+	rcutable *t = malloc(sizeof(*t));
+	if (t == NULL) {
+		return NULL;
+	}
+	rcu_index *idx = new_index(INITIAL_CAPACITY);
+	t->domain = epoch_domain_empty();
+	if (idx == NULL || t->domain == NULL) {
+		free(idx);
+		if (t->domain != NULL) {
+			epoch_domain_kill(t->domain);
+		}
+		free(t);
+		return NULL;
+	}
+	atomic_init(&t->index, idx);
+	t->size = 0;
+	t->key_cmp_func = key_cmp_func;
+	t->key_hash_func = key_hash_func;
+	t->key_free_func = key_free_func;
+	t->value_free_func = value_free_func;
+	return t;
+}
+
+/**
+ * rcutable_attach() - Register the calling thread with a table.
+ * @t: Table that the thread will use.
+ *
+ * Return: Handle for the calling thread, or NULL if not enough memory
+ * was available.
+ * Simplified asymptotic complexity analysis : O(threads)
+ */
+epoch_thread *rcutable_attach(rcutable *t)
+{
+	return epoch_register(t->domain);
+}
+
+/**
+ * rcutable_detach() - Unregister a thread from a table.
+ * @th: Handle returned by rcutable_attach().
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+void rcutable_detach(epoch_thread *th)
+{
+	epoch_unregister(th);
+}
+
+/**
+ * rcutable_insert() - Add a key/value pair to a table.
+ * @t: Table to manipulate.
+ * @th: Handle of the calling thread, which must be the only writer.
+ * @key: A pointer to the key value.
+ * @value: A pointer to the value value.
+ *
+ * A new key goes into the first tombstone or empty slot of its probe
+ * sequence. Reusing a tombstone is safe because the key was not found
+ * further along the sequence, and no other thread inserts.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(1) expected
+ */
+void rcutable_insert(rcutable *t, epoch_thread *th, void *key, void *value)
+{
+	rcu_entry *e = malloc(sizeof(*e));
+	if (e == NULL) {
+		return;
+	}
+	e->key = key;
+	e->value = value;
+	e->hash = t->key_hash_func(key);
+	e->t = t;
+
+	rcu_index *idx = atomic_load_explicit(&t->index, memory_order_relaxed);
+	rcu_entry *old;
+	int i = find_slot(t, idx, key, e->hash, &old);
+	if (i >= 0) {
+		atomic_store_explicit(&idx->slots[i], e, memory_order_release);
+		epoch_retire(th, old, free_entry);
+		return;
+	}
+	if ((idx->used + 1) * LOAD_DEN > idx->capacity * LOAD_NUM) {
+		if (!rebuild(t, th)) {
+			free(e);
+			return;
+		}
+		idx = atomic_load_explicit(&t->index, memory_order_relaxed);
+	}
+	int mask = idx->capacity - 1;
+	i = home_slot(idx, e->hash);
+	for (;;) {
+		rcu_entry *s = atomic_load_explicit(&idx->slots[i],
+						    memory_order_relaxed);
+		if (s == NULL || s == TOMBSTONE) {
+			if (s == NULL) {
+				idx->used++;
+			}
+			break;
+		}
+		i = (i + 1) & mask;
+	}
+	atomic_store_explicit(&idx->slots[i], e, memory_order_release);
+	t->size++;
+}
+
+/**
+ * rcutable_lookup() - Look up a given key in a table.
+ * @t: Table to inspect.
+ * @th: Handle of the calling thread.
+ * @key: Key to look up.
+ *
+ * Return: The value corresponding to a given key, or NULL if the key
+ * is not found in the table.
+ * Simplified asymptotic complexity analysis : O(1) expected
+ */
+void *rcutable_lookup(rcutable *t, epoch_thread *th, const void *key)
+{
+	void *value = NULL;
+	uint64_t hash = t->key_hash_func(key);
+	epoch_enter(th);
+	rcu_index *idx = atomic_load_explicit(&t->index, memory_order_acquire);
+	rcu_entry *e;
+	if (find_slot(t, idx, key, hash, &e) >= 0) {
+		value = e->value;
+	}
+	epoch_exit(th);
+	return value;
+}
+
+/**
+ * rcutable_remove() - Remove a key/value pair in the table.
+ * @t: Table to manipulate.
+ * @th: Handle of the calling thread, which must be the only writer.
+ * @key: Key for which to remove pair.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(1) expected
+ */
+void rcutable_remove(rcutable *t, epoch_thread *th, const void *key)
+{
+	rcu_index *idx = atomic_load_explicit(&t->index, memory_order_relaxed);
+	rcu_entry *old;
+	int i = find_slot(t, idx, key, t->key_hash_func(key), &old);
+	if (i < 0) {
+		return;
+	}
+	atomic_store_explicit(&idx->slots[i], TOMBSTONE, memory_order_release);
+	epoch_retire(th, old, free_entry);
+	t->size--;
+}
+
+/**
+ * rcutable_is_empty() - Check if a table is empty.
+ * @t: Table to check.
+ *
+ * Return: True if table contains no key/value pairs, false otherwise.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+bool rcutable_is_empty(const rcutable *t)
+{
+	return t->size == 0;
+}
+
+/**
+ * rcutable_kill() - Destroy a table.
+ * @t: Table to destroy.
+ *
+ * The epoch domain is killed first, which frees all retired entries
+ * and indexes. The live entries are then free'd from the current
+ * index.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(capacity)
+ */
+void rcutable_kill(rcutable *t)
+{
+	epoch_domain_kill(t->domain);
+	rcu_index *idx = atomic_load(&t->index);
+	for (int i = 0; i < idx->capacity; i++) {
+		rcu_entry *e = atomic_load(&idx->slots[i]);
+		if (e != NULL && e != TOMBSTONE) {
+			free_entry(e);
+		}
+	}
+	free(idx);
+	free(t);
+}
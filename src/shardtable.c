@@ -0,0 +1,201 @@
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "shardtable.h"
+#include "table.h"
+
+/*
+ * Implementation of a thread-safe table as an array of tables from
+ * table.h, each guarded by a pthread read-write lock.
+ *
+ * The shards are in the default unordered mode, where table_lookup()
+ * does not modify the table, so lookups only take the read lock. Each
+ * shard is aligned to its own cache line, so that threads locking
+ * neighbouring shards do not invalidate each other's cache lines.
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first version.
+ *   2026-10-16: v1.1, shardtable_insert() reports a failed allocation.
+ */
+
+// Size of a cache line, the alignment of a shard.
+#define CACHE_LINE 64
+
+// ===========INTERNAL DATA TYPES============
+
+typedef struct shard {
+	_Alignas(CACHE_LINE) pthread_rwlock_t lock;
+	table *t;
+} shard;
+
+struct shardtable {
+	shard *shards;
+	int mask; // Number of shards minus one.
+	hash_function *key_hash_func;
+};
+
+// ===========INTERNAL FUNCTION IMPLEMENTATIONS============
+
+/*
+ * Return the shard of a key. The hash is mixed with the splitmix64
+ * finalizer before its low bits are used. The tables in the shards
+ * scramble the hash differently, so the keys of one shard are still
+ * spread over its whole index.
+ */
+static shard *key_shard(const shardtable *t, const void *key)
+{
+	uint64_t h = t->key_hash_func(key);
+	h ^= h >> 30;
+	h *= 0xBF58476D1CE4E5B9ULL;
+	h ^= h >> 27;
+	h *= 0x94D049BB133111EBULL;
+	h ^= h >> 31;
+	return &t->shards[h & t->mask];
+}
+
+// ===========DATA STRUCTURE INTERFACE IMPLEMENTATION============
+
+/**
+ * shardtable_empty() - Create an empty sharded table.
+ * @shards: Number of shards, rounded up to a power of two.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: A pointer to a function to be used to hash keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Return: Pointer to a new table, or NULL if not enough memory was
+ * available.
+ * Simplified asymptotic complexity analysis : O(shards)
+ */
+shardtable *shardtable_empty(int shards,
+			     compare_function *key_cmp_func,
+			     hash_function *key_hash_func,
+			     free_function key_free_func,
+			     free_function value_free_func)
+{
+	int n = 1;
+	while (n < shards) {
+		n *= 2;
+	}
+	shardtable *t = malloc(sizeof(*t));
+	if (t == NULL) {
+		return NULL;
+	}
+	t->shards = aligned_alloc(CACHE_LINE, n * sizeof(shard));
+	if (t->shards == NULL) {
+		free(t);
+		return NULL;
+	}
+	t->mask = n - 1;
+	t->key_hash_func = key_hash_func;
+	for (int i = 0; i < n; i++) {
+		pthread_rwlock_init(&t->shards[i].lock, NULL);
+		t->shards[i].t = table_empty_with_hash(key_cmp_func,
+						       key_hash_func,
+						       key_free_func,
+						       value_free_func);
+		if (t->shards[i].t == NULL) {
+			t->mask = i - 1;
+			pthread_rwlock_destroy(&t->shards[i].lock);
+			shardtable_kill(t);
+			return NULL;
+		}
+	}
+	return t;
+}
+
+/**
+ * shardtable_is_empty() - Check if a table is empty.
+ * @t: Table to check.
+ *
+ * Return: True if table contains no key/value pairs, false otherwise.
+ * Simplified asymptotic complexity analysis : O(shards)
+ */
+bool shardtable_is_empty(shardtable *t)
+{
+	for (int i = 0; i <= t->mask; i++) {
+		shard *s = &t->shards[i];
+		pthread_rwlock_rdlock(&s->lock);
+		bool empty = table_is_empty(s->t);
+		pthread_rwlock_unlock(&s->lock);
+		if (!empty) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * shardtable_insert() - Add a key/value pair to a table.
+ * @t: Table to manipulate.
+ * @key: A pointer to the key value.
+ * @value: A pointer to the value value.
+ *
+ * Return: True if the pair was inserted, false if not enough memory was
+ * available.
+ * Simplified asymptotic complexity analysis : as table_insert() for
+ * a table of n/shards pairs
+ */
+bool shardtable_insert(shardtable *t, void *key, void *value)
+{
+	shard *s = key_shard(t, key);
+	pthread_rwlock_wrlock(&s->lock);
+	bool ok = table_insert(s->t, key, value);
+	pthread_rwlock_unlock(&s->lock);
+	return ok;
+}
+
+/**
+ * shardtable_lookup() - Look up a given key in a table.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ *
+ * Return: The value corresponding to a given key, or NULL if the key
+ * is not found in the table.
+ * Simplified asymptotic complexity analysis : as table_lookup() for
+ * a table of n/shards pairs
+ */
+void *shardtable_lookup(shardtable *t, const void *key)
+{
+	shard *s = key_shard(t, key);
+	pthread_rwlock_rdlock(&s->lock);
+	void *value = table_lookup(s->t, key);
+	pthread_rwlock_unlock(&s->lock);
+	return value;
+}
+
+/**
+ * shardtable_remove() - Remove a key/value pair in the table.
+ * @t: Table to manipulate.
+ * @key: Key for which to remove pair.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : as table_remove() for
+ * a table of n/shards pairs
+ */
+void shardtable_remove(shardtable *t, const void *key)
+{
+	shard *s = key_shard(t, key);
+	pthread_rwlock_wrlock(&s->lock);
+	table_remove(s->t, key);
+	pthread_rwlock_unlock(&s->lock);
+}
+
+/**
+ * shardtable_kill() - Destroy a table.
+ * @t: Table to destroy.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(n + shards)
+ */
+void shardtable_kill(shardtable *t)
+{
+	for (int i = 0; i <= t->mask; i++) {
+		table_kill(t->shards[i].t);
+		pthread_rwlock_destroy(&t->shards[i].lock);
+	}
+	free(t->shards);
+	free(t);
+}
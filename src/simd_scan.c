@@ -0,0 +1,210 @@
+#include <stdatomic.h>
+#include <stdint.h>
+
+#include "simd_scan.h"
+
+/*
+ * Implementation of vectorized search functions for dense arrays of
+ * small integers.
+ *
+ * Each function has a scalar version and, on x86 with GCC or Clang,
+ * SSE2 and AVX2 versions compiled with per-function target
+ * attributes, so no special compiler flags are needed. The version
+ * to use is resolved on the first call from the CPU features and is
+ * then called through an atomic function pointer.
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first version.
+ *   2026-10-16: v1.1, added scan_i32().
+ *   2026-10-16: v1.2, the function pointers are atomic.
+ */
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_SCAN_X86
+#include <immintrin.h>
+#endif
+
+// ===========INTERNAL DATA TYPES============
+
+typedef int scan_u16_function(const uint16_t *, int, int, uint16_t);
+typedef int scan_i32_function(const int32_t *, int, int, int32_t);
+
+// ===========INTERNAL FUNCTION IMPLEMENTATIONS============
+
+static int scan_u16_scalar(const uint16_t *a, int from, int n, uint16_t v)
+{
+	for (int i = from; i < n; i++) {
+		if (a[i] == v) {
+			return i;
+		}
+	}
+	return n;
+}
+
+static int scan_i32_scalar(const int32_t *a, int from, int n, int32_t v)
+{
+	for (int i = from; i < n; i++) {
+		if (a[i] == v) {
+			return i;
+		}
+	}
+	return n;
+}
+
+#ifdef SIMD_SCAN_X86
+
+__attribute__((target("sse2")))
+static int scan_u16_sse2(const uint16_t *a, int from, int n, uint16_t v)
+{
+	__m128i needle = _mm_set1_epi16((short)v);
+	int i = from;
+	for (; i + 8 <= n; i += 8) {
+		__m128i block = _mm_loadu_si128((const __m128i *)(a + i));
+		unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi16(block, needle));
+		if (mask != 0) {
+			// Two mask bits per 16-bit element.
+			return i + __builtin_ctz(mask) / 2;
+		}
+	}
+	return scan_u16_scalar(a, i, n, v);
+}
+
+__attribute__((target("avx2")))
+static int scan_u16_avx2(const uint16_t *a, int from, int n, uint16_t v)
+{
+	__m256i needle = _mm256_set1_epi16((short)v);
+	int i = from;
+	for (; i + 16 <= n; i += 16) {
+		__m256i block = _mm256_loadu_si256((const __m256i *)(a + i));
+		unsigned mask = (unsigned)_mm256_movemask_epi8(
+			_mm256_cmpeq_epi16(block, needle));
+		if (mask != 0) {
+			return i + __builtin_ctz(mask) / 2;
+		}
+	}
+	return scan_u16_sse2(a, i, n, v);
+}
+
+__attribute__((target("sse2")))
+static int scan_i32_sse2(const int32_t *a, int from, int n, int32_t v)
+{
+	__m128i needle = _mm_set1_epi32(v);
+	int i = from;
+	for (; i + 4 <= n; i += 4) {
+		__m128i block = _mm_loadu_si128((const __m128i *)(a + i));
+		unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi32(block, needle));
+		if (mask != 0) {
+			// Four mask bits per 32-bit element.
+			return i + __builtin_ctz(mask) / 4;
+		}
+	}
+	return scan_i32_scalar(a, i, n, v);
+}
+
+__attribute__((target("avx2")))
+static int scan_i32_avx2(const int32_t *a, int from, int n, int32_t v)
+{
+	__m256i needle = _mm256_set1_epi32(v);
+	int i = from;
+	// Two blocks per iteration, the loop is bound by the compare
+	// throughput rather than by the branch.
+	for (; i + 16 <= n; i += 16) {
+		__m256i b0 = _mm256_loadu_si256((const __m256i *)(a + i));
+		__m256i b1 = _mm256_loadu_si256((const __m256i *)(a + i + 8));
+		__m256i eq = _mm256_or_si256(_mm256_cmpeq_epi32(b0, needle),
+					     _mm256_cmpeq_epi32(b1, needle));
+		if (!_mm256_testz_si256(eq, eq)) {
+			break;
+		}
+	}
+	for (; i + 8 <= n; i += 8) {
+		__m256i block = _mm256_loadu_si256((const __m256i *)(a + i));
+		unsigned mask = (unsigned)_mm256_movemask_epi8(
+			_mm256_cmpeq_epi32(block, needle));
+		if (mask != 0) {
+			return i + __builtin_ctz(mask) / 4;
+		}
+	}
+	return scan_i32_sse2(a, i, n, v);
+}
+
+#endif // SIMD_SCAN_X86
+
+static int scan_u16_resolve(const uint16_t *a, int from, int n, uint16_t v);
+
+// Version of scan_u16 to call. Starts out as the resolver, which
+// replaces itself on the first call. The pointer is read and written
+// by any thread, so it is atomic. Relaxed order is enough, since every
+// value it can hold is a function that is valid on its own.
+static scan_u16_function *_Atomic scan_u16_impl = scan_u16_resolve;
+
+static int scan_u16_resolve(const uint16_t *a, int from, int n, uint16_t v)
+{
+	scan_u16_function *impl = scan_u16_scalar;
+#ifdef SIMD_SCAN_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		impl = scan_u16_avx2;
+	} else if (__builtin_cpu_supports("sse2")) {
+		impl = scan_u16_sse2;
+	}
+#endif
+	atomic_store_explicit(&scan_u16_impl, impl, memory_order_relaxed);
+	return impl(a, from, n, v);
+}
+
+static int scan_i32_resolve(const int32_t *a, int from, int n, int32_t v);
+
+// Version of scan_i32 to call, resolved like scan_u16_impl.
+static scan_i32_function *_Atomic scan_i32_impl = scan_i32_resolve;
+
+static int scan_i32_resolve(const int32_t *a, int from, int n, int32_t v)
+{
+	scan_i32_function *impl = scan_i32_scalar;
+#ifdef SIMD_SCAN_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		impl = scan_i32_avx2;
+	} else if (__builtin_cpu_supports("sse2")) {
+		impl = scan_i32_sse2;
+	}
+#endif
+	atomic_store_explicit(&scan_i32_impl, impl, memory_order_relaxed);
+	return impl(a, from, n, v);
+}
+
+// ===========INTERFACE IMPLEMENTATION============
+
+/**
+ * scan_u16() - Find the next occurrence of a value in an array.
+ * @a: array to search.
+ * @from: index to start searching at.
+ * @n: number of elements in the array.
+ * @v: value to search for.
+ *
+ * Returns: The smallest index i such that from <= i < n and a[i] == v,
+ * or n if there is no such index.
+ */
+int scan_u16(const uint16_t *a, int from, int n, uint16_t v)
+{
+	scan_u16_function *impl =
+		atomic_load_explicit(&scan_u16_impl, memory_order_relaxed);
+	return impl(a, from, n, v);
+}
+
+/**
+ * scan_i32() - Find the next occurrence of a value in an array.
+ * @a: array to search.
+ * @from: index to start searching at.
+ * @n: number of elements in the array.
+ * @v: value to search for.
+ *
+ * Returns: The smallest index i such that from <= i < n and a[i] == v,
+ * or n if there is no such index.
+ */
+int scan_i32(const int32_t *a, int from, int n, int32_t v)
+{
+	scan_i32_function *impl =
+		atomic_load_explicit(&scan_i32_impl, memory_order_relaxed);
+	return impl(a, from, n, v);
+}
@@ -0,0 +1,531 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "snapshot.h"
+
+/*
+ * Implementation of binary snapshots of key/value pairs.
+ *
+ * A record is a record_header followed by the key bytes and the value
+ * bytes, each padded with zeros to a multiple of 8 bytes. The offset
+ * array and the records are written in one pass, and the header with
+ * the checksum is written last. The checksum is computed over 64-bit
+ * words; every part of the file is a multiple of 8 bytes long.
+ *
+ * Loading maps the whole file and validates it before any pair is
+ * used, so a lookup in a loaded snapshot can trust the offsets.
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first version.
+ *   2026-10-16: v1.1, snapshot_save() syncs the directory.
+ *   2026-10-16: v1.2, snapshot_save() writes to a unique temporary file.
+ */
+
+// Start of a snapshot file, and the version of the format.
+#define SNAPSHOT_MAGIC "TBLSNAP"
+#define SNAPSHOT_VERSION 1
+
+// Written in the byte order of the writer, read back to check that the
+// reader has the same byte order.
+#define SNAPSHOT_BYTE_ORDER 0x01020304u
+
+// Value size of a record whose value is NULL.
+#define SNAPSHOT_NULL UINT32_MAX
+
+// Starting value and multiplier of the checksum.
+#define CHECKSUM_SEED 0x736E617073686F74ULL
+#define CHECKSUM_PRIME 0x9E3779B97F4A7C15ULL
+
+// ===========INTERNAL DATA TYPES============
+
+// Header at the start of a snapshot file.
+typedef struct file_header {
+	char magic[8];		// SNAPSHOT_MAGIC, zero padded.
+	uint32_t version;	// SNAPSHOT_VERSION.
+	uint32_t byte_order;	// SNAPSHOT_BYTE_ORDER.
+	uint64_t count;		// Number of records.
+	uint64_t file_size;	// Size of the whole file in bytes.
+	uint64_t checksum;	// Checksum of the bytes after the header.
+} file_header;
+
+// Header of a record. The key starts right after it.
+typedef struct record_header {
+	uint32_t key_size;	// Bytes of the key.
+	uint32_t value_size;	// Bytes of the value, or SNAPSHOT_NULL.
+} record_header;
+
+struct snapshot {
+	const unsigned char *base; // Start of the mapping.
+	size_t bytes;		// Size of the mapping.
+	int count;		// Number of records.
+	const uint64_t *offsets; // File offset of each record, in key order.
+};
+
+// ===========INTERNAL FUNCTION IMPLEMENTATIONS============
+
+/*
+ * Round a size up to a multiple of 8.
+ */
+static uint64_t pad8(uint64_t size)
+{
+	return (size + 7) & ~(uint64_t)7;
+}
+
+/*
+ * Return the number of bytes of a record with the given key and value
+ * sizes.
+ */
+static uint64_t record_size(uint32_t key_size, uint32_t value_size)
+{
+	return sizeof(record_header) + pad8(key_size) +
+	       pad8(value_size == SNAPSHOT_NULL ? 0 : value_size);
+}
+
+/*
+ * Add bytes, a multiple of 8, to checksum h and return the new
+ * checksum. Each step is a bijection of h, so changing any one word
+ * always changes the checksum.
+ */
+static uint64_t checksum_add(uint64_t h, const void *data, size_t bytes)
+{
+	const unsigned char *p = data;
+	for (size_t i = 0; i < bytes; i += 8) {
+		uint64_t w;
+		memcpy(&w, p + i, sizeof(w));
+		h = (h ^ w) * CHECKSUM_PRIME;
+		h ^= h >> 32;
+	}
+	return h;
+}
+
+/*
+ * Sort the indices in a[0..n-1] by the keys they refer to, using tmp
+ * as scratch space. The merge is skipped if the halves are already in
+ * order, so sorted input takes O(n) compares.
+ */
+static void sort_order(void **keys, int *a, int *tmp, int n,
+		       compare_function *key_cmp_func)
+{
+	if (n < 2) {
+		return;
+	}
+	int half = n / 2;
+	sort_order(keys, a, tmp, half, key_cmp_func);
+	sort_order(keys, a + half, tmp, n - half, key_cmp_func);
+	if (key_cmp_func(keys[a[half - 1]], keys[a[half]]) <= 0) {
+		return;
+	}
+	memcpy(tmp, a, n * sizeof(int));
+	int i = 0;
+	int j = half;
+	int k = 0;
+	while (i < half && j < n) {
+		if (key_cmp_func(keys[tmp[j]], keys[tmp[i]]) < 0) {
+			a[k++] = tmp[j++];
+		} else {
+			a[k++] = tmp[i++];
+		}
+	}
+	while (i < half) {
+		a[k++] = tmp[i++];
+	}
+	while (j < n) {
+		a[k++] = tmp[j++];
+	}
+}
+
+/*
+ * Return the header of record i of a loaded snapshot.
+ */
+static const record_header *record_at(const snapshot *s, int i)
+{
+	return (const record_header *)(s->base + s->offsets[i]);
+}
+
+/*
+ * Check the header, checksum and record bounds of a mapped file of the
+ * given size. Returns true if the file is a valid snapshot.
+ */
+static bool is_valid(const unsigned char *base, size_t bytes)
+{
+	file_header h;
+	if (bytes < sizeof(h) || bytes % 8 != 0) {
+		return false;
+	}
+	memcpy(&h, base, sizeof(h));
+	char magic[sizeof(h.magic)] = SNAPSHOT_MAGIC;
+	if (memcmp(h.magic, magic, sizeof(magic)) != 0 ||
+	    h.version != SNAPSHOT_VERSION ||
+	    h.byte_order != SNAPSHOT_BYTE_ORDER || h.file_size != bytes ||
+	    h.count > INT_MAX || h.count > (bytes - sizeof(h)) / 8) {
+		return false;
+	}
+	if (checksum_add(CHECKSUM_SEED, base + sizeof(h),
+			 bytes - sizeof(h)) != h.checksum) {
+		return false;
+	}
+	const uint64_t *offsets = (const uint64_t *)(base + sizeof(h));
+	uint64_t records = sizeof(h) + h.count * 8;
+	for (uint64_t i = 0; i < h.count; i++) {
+		uint64_t offset = offsets[i];
+		if (offset < records || offset % 8 != 0 ||
+		    bytes - offset < sizeof(record_header)) {
+			return false;
+		}
+		const record_header *r = (const record_header *)(base + offset);
+		if (record_size(r->key_size, r->value_size) > bytes - offset) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+ * Write the records of the pairs in the given order to f, after the
+ * header and the offsets. Returns the checksum through checksum, and
+ * false with errno set if a write failed.
+ */
+static bool write_records(FILE *f, void **keys, void **values,
+			  const int *order, const uint32_t *key_sizes,
+			  const uint32_t *value_sizes, int n,
+			  uint64_t *checksum)
+{
+	uint64_t h = *checksum;
+	unsigned char *buf = NULL;
+	size_t buf_size = 0;
+	for (int i = 0; i < n; i++) {
+		int p = order[i];
+		size_t size = record_size(key_sizes[i], value_sizes[i]);
+		if (size > buf_size) {
+			unsigned char *b = realloc(buf, size);
+			if (b == NULL) {
+				free(buf);
+				return false;
+			}
+			buf = b;
+			buf_size = size;
+		}
+		memset(buf, 0, size);
+		record_header r = { key_sizes[i], value_sizes[i] };
+		memcpy(buf, &r, sizeof(r));
+		memcpy(buf + sizeof(r), keys[p], key_sizes[i]);
+		if (values[p] != NULL) {
+			memcpy(buf + sizeof(r) + pad8(key_sizes[i]), values[p],
+			       value_sizes[i]);
+		}
+		h = checksum_add(h, buf, size);
+		if (fwrite(buf, 1, size, f) != size) {
+			free(buf);
+			return false;
+		}
+	}
+	free(buf);
+	*checksum = h;
+	return true;
+}
+
+/*
+ * Flush the directory that holds path, so that a rename to path is
+ * durable. Returns false with errno set if the directory could not be
+ * synced.
+ */
+static bool sync_dir(const char *path)
+{
+	const char *slash = strrchr(path, '/');
+	size_t len = slash == NULL ? 0 : slash == path ? 1 : slash - path;
+	char *dir = malloc(len + sizeof("."));
+	if (dir == NULL) {
+		return false;
+	}
+	if (len == 0) {
+		strcpy(dir, ".");
+	} else {
+		memcpy(dir, path, len);
+		dir[len] = '\0';
+	}
+	int fd = open(dir, O_RDONLY | O_DIRECTORY);
+	free(dir);
+	if (fd < 0) {
+		return false;
+	}
+	bool ok = fsync(fd) == 0;
+	int error = errno;
+	close(fd);
+	errno = error;
+	return ok;
+}
+
+// ===========DATA STRUCTURE INTERFACE IMPLEMENTATION============
+
+/**
+ * snapshot_save() - Write key/value pairs to a snapshot file.
+ * @path: Name of the file to write.
+ * @keys: Array of n keys, all different.
+ * @values: Array of n values, values[i] belongs to keys[i].
+ * @n: Number of pairs.
+ * @key_cmp_func: A pointer to a function used to sort the keys.
+ * @key_size_func: A pointer to a function that returns the number of
+ *		   bytes of a key.
+ * @value_size_func: A pointer to a function that returns the number of
+ *		     bytes of a value.
+ *
+ * Return: True if the snapshot was written, false with errno set
+ * otherwise.
+ * Simplified asymptotic complexity analysis : O(n log n + bytes)
+ */
+bool snapshot_save(const char *path, void **keys, void **values, int n,
+		   compare_function *key_cmp_func,
+		   size_function *key_size_func,
+		   size_function *value_size_func)
+{
+	size_t m = n > 0 ? n : 1;
+	int *order = malloc(m * sizeof(int));
+	int *tmp = malloc(m * sizeof(int));
+	uint64_t *offsets = malloc(m * sizeof(uint64_t));
+	uint32_t *key_sizes = malloc(m * sizeof(uint32_t));
+	uint32_t *value_sizes = malloc(m * sizeof(uint32_t));
+	char *tmp_path = malloc(strlen(path) + sizeof(".XXXXXX"));
+	file_header h = { SNAPSHOT_MAGIC, SNAPSHOT_VERSION,
+			  SNAPSHOT_BYTE_ORDER, n, 0, 0 };
+	FILE *f = NULL;
+	bool created = false;
+	bool ok = false;
+	if (order == NULL || tmp == NULL || offsets == NULL ||
+	    key_sizes == NULL || value_sizes == NULL || tmp_path == NULL) {
+		goto out;
+	}
+	for (int i = 0; i < n; i++) {
+		order[i] = i;
+	}
+	sort_order(keys, order, tmp, n, key_cmp_func);
+
+	uint64_t offset = sizeof(h) + (uint64_t)n * sizeof(uint64_t);
+	for (int i = 0; i < n; i++) {
+		int p = order[i];
+		size_t key_size = key_size_func(keys[p]);
+		size_t value_size = values[p] == NULL ? SNAPSHOT_NULL
+						      : value_size_func(values[p]);
+		if (key_size >= SNAPSHOT_NULL ||
+		    (values[p] != NULL && value_size >= SNAPSHOT_NULL)) {
+			errno = EOVERFLOW;
+			goto out;
+		}
+		key_sizes[i] = key_size;
+		value_sizes[i] = value_size;
+		offsets[i] = offset;
+		offset += record_size(key_sizes[i], value_sizes[i]);
+	}
+	h.file_size = offset;
+
+	// A unique file next to path, so that saves to the same path at
+	// the same time do not write to the same file.
+	sprintf(tmp_path, "%s.XXXXXX", path);
+	int fd = mkstemp(tmp_path);
+	if (fd < 0) {
+		goto out;
+	}
+	created = true;
+	f = fchmod(fd, 0644) == 0 ? fdopen(fd, "wb") : NULL;
+	if (f == NULL) {
+		int error = errno;
+		close(fd);
+		errno = error;
+		goto out;
+	}
+	h.checksum = checksum_add(CHECKSUM_SEED, offsets,
+				  (size_t)n * sizeof(uint64_t));
+	if (fwrite(&h, sizeof(h), 1, f) != 1 ||
+	    fwrite(offsets, sizeof(uint64_t), n, f) != (size_t)n ||
+	    !write_records(f, keys, values, order, key_sizes, value_sizes,
+			   n, &h.checksum)) {
+		goto out;
+	}
+	// The header is written again with the checksum.
+	if (fseek(f, 0, SEEK_SET) != 0 || fwrite(&h, sizeof(h), 1, f) != 1 ||
+	    fflush(f) != 0 || fsync(fileno(f)) != 0) {
+		goto out;
+	}
+	ok = fclose(f) == 0;
+	f = NULL;
+	ok = ok && rename(tmp_path, path) == 0 && sync_dir(path);
+out:
+	if (!ok && created) {
+		int error = errno;
+		if (f != NULL) {
+			fclose(f);
+		}
+		remove(tmp_path);
+		errno = error;
+	}
+	free(order);
+	free(tmp);
+	free(offsets);
+	free(key_sizes);
+	free(value_sizes);
+	free(tmp_path);
+	return ok;
+}
+
+/**
+ * snapshot_load() - Map a snapshot file into memory.
+ * @path: Name of the file to load.
+ *
+ * Return: Pointer to the mapped snapshot, or NULL with errno set if the
+ * file could not be mapped or is not a valid snapshot.
+ * Simplified asymptotic complexity analysis : O(bytes)
+ */
+snapshot *snapshot_load(const char *path)
+{
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		return NULL;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		int error = errno;
+		close(fd);
+		errno = error;
+		return NULL;
+	}
+	size_t bytes = st.st_size;
+	if (bytes < sizeof(file_header)) {
+		close(fd);
+		errno = EINVAL;
+		return NULL;
+	}
+	void *base = mmap(NULL, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+	int error = errno;
+	close(fd);
+	if (base == MAP_FAILED) {
+		errno = error;
+		return NULL;
+	}
+	if (!is_valid(base, bytes)) {
+		munmap(base, bytes);
+		errno = EINVAL;
+		return NULL;
+	}
+	snapshot *s = malloc(sizeof(*s));
+	if (s == NULL) {
+		munmap(base, bytes);
+		errno = ENOMEM;
+		return NULL;
+	}
+	s->base = base;
+	s->bytes = bytes;
+	s->count = (int)((const file_header *)base)->count;
+	s->offsets = (const uint64_t *)(s->base + sizeof(file_header));
+	return s;
+}
+
+/**
+ * snapshot_size() - Get the number of pairs of a snapshot.
+ * @s: Snapshot to inspect.
+ *
+ * Return: The number of pairs.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+int snapshot_size(const snapshot *s)
+{
+	return s->count;
+}
+
+/**
+ * snapshot_key() - Get a key of a snapshot.
+ * @s: Snapshot to inspect.
+ * @i: Index of the pair, in key order.
+ *
+ * Return: A pointer to the key in the mapping.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+void *snapshot_key(const snapshot *s, int i)
+{
+	return (void *)(record_at(s, i) + 1);
+}
+
+/**
+ * snapshot_value() - Get a value of a snapshot.
+ * @s: Snapshot to inspect.
+ * @i: Index of the pair, in key order.
+ *
+ * Return: A pointer to the value in the mapping, or NULL if the value
+ * was NULL when it was saved.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+void *snapshot_value(const snapshot *s, int i)
+{
+	const record_header *r = record_at(s, i);
+	if (r->value_size == SNAPSHOT_NULL) {
+		return NULL;
+	}
+	return (void *)((const unsigned char *)(r + 1) + pad8(r->key_size));
+}
+
+/**
+ * snapshot_find() - Find a key in a snapshot by binary search.
+ * @s: Snapshot to search.
+ * @key: Key to find.
+ * @key_cmp_func: A pointer to a function that orders the keys as the
+ *		  function given to snapshot_save().
+ * @probes: Set to the number of keys compared.
+ *
+ * Return: The index of the key, or -1 if it is not in the snapshot.
+ * Simplified asymptotic complexity analysis : O(log n)
+ */
+int snapshot_find(const snapshot *s, const void *key,
+		  compare_function *key_cmp_func, int *probes)
+{
+	int lo = 0;
+	int hi = s->count;
+	int n = 0;
+	while (lo < hi) {
+		int mid = lo + (hi - lo) / 2;
+		int c = key_cmp_func(snapshot_key(s, mid), key);
+		n++;
+		if (c == 0) {
+			*probes = n;
+			return mid;
+		}
+		if (c < 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	*probes = n;
+	return -1;
+}
+
+/**
+ * snapshot_bytes() - Get the size of a snapshot.
+ * @s: Snapshot to inspect.
+ *
+ * Return: The number of bytes mapped, and the size of the structure
+ * describing the mapping.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+size_t snapshot_bytes(const snapshot *s)
+{
+	return s->bytes + sizeof(*s);
+}
+
+/**
+ * snapshot_kill() - Unmap a snapshot.
+ * @s: Snapshot to unmap.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+void snapshot_kill(snapshot *s)
+{
+	munmap((void *)s->base, s->bytes);
+	free(s);
+}
@@ -0,0 +1,200 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "table_int.h"
+#include "simd_scan.h"
+
+/*
+ * Implementation of a table with int keys.
+ *
+ * The keys and values are kept in two parallel arrays. The key array
+ * is a dense int32_t array that is searched with scan_i32(), which
+ * compares 8 keys per instruction on AVX2. Removal moves the last pair
+ * into the hole, so the live pairs always occupy [0, size-1].
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first version.
+ */
+
+_Static_assert(sizeof(int) == sizeof(int32_t), "int must be 32 bits");
+
+// Smallest number of pairs allocated for a non-empty table.
+#define MIN_CAPACITY 8
+
+// ===========INTERNAL DATA TYPES============
+
+struct table_int {
+	int32_t *keys; // Keys [0, size-1] are in use.
+	void **values; // Value of each key.
+	int size; // Number of pairs in use.
+	int capacity; // Number of pairs allocated.
+	free_function value_free_func;
+};
+
+// ===========INTERNAL FUNCTION IMPLEMENTATIONS============
+
+/*
+ * Change the number of allocated pairs. Returns false if not enough
+ * memory was available, the table is still consistent in that case.
+ */
+static bool set_capacity(table_int *t, int capacity)
+{
+	int32_t *keys = realloc(t->keys, capacity * sizeof(int32_t));
+	if (keys == NULL) {
+		return false;
+	}
+	t->keys = keys;
+	void **values = realloc(t->values, capacity * sizeof(void *));
+	if (values == NULL) {
+		// Both arrays hold at least the smaller capacity.
+		if (capacity < t->capacity) {
+			t->capacity = capacity;
+		}
+		return false;
+	}
+	t->values = values;
+	t->capacity = capacity;
+	return true;
+}
+
+/*
+ * Return the index of key, or -1 if the key is not in the table.
+ */
+static int find_index(const table_int *t, int key)
+{
+	int i = scan_i32(t->keys, 0, t->size, key);
+	return i < t->size ? i : -1;
+}
+
+// ===========DATA STRUCTURE INTERFACE IMPLEMENTATION============
+
+/**
+ * table_int_empty() - Create an empty table with int keys.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Return: Pointer to a new table, or NULL if not enough memory was
+ * available.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+table_int *table_int_empty(free_function value_free_func)
+{
+	table_int *t = calloc(1, sizeof(*t));
+	if (t != NULL) {
+		t->value_free_func = value_free_func;
+	}
+	return t;
+}
+
+/**
+ * table_int_is_empty() - Check if a table is empty.
+ * @t: Table to check.
+ *
+ * Return: True if table contains no key/value pairs, false otherwise.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+bool table_int_is_empty(const table_int *t)
+{
+	return t->size == 0;
+}
+
+/**
+ * table_int_insert() - Add a key/value pair to a table.
+ * @t: Table to manipulate.
+ * @key: The key.
+ * @value: A pointer to the value value.
+ *
+ * Insert the key/value pair into the table. If the key is already in
+ * the table, its old value is replaced (and free'd if a free function
+ * was registered).
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(n)
+ */
+void table_int_insert(table_int *t, int key, void *value)
+{
+	int i = find_index(t, key);
+	if (i >= 0) {
+		if (t->value_free_func != NULL) {
+			t->value_free_func(t->values[i]);
+		}
+		t->values[i] = value;
+		return;
+	}
+	if (t->size == t->capacity &&
+	    !set_capacity(t, t->capacity < MIN_CAPACITY ? MIN_CAPACITY
+							: 2 * t->capacity)) {
+		return;
+	}
+	t->keys[t->size] = key;
+	t->values[t->size] = value;
+	t->size++;
+}
+
+/**
+ * table_int_lookup() - Look up a given key in a table.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ *
+ * Return: The value corresponding to a given key, or NULL if the key
+ * is not found in the table.
+ * Simplified asymptotic complexity analysis : O(n)
+ */
+void *table_int_lookup(const table_int *t, int key)
+{
+	int i = find_index(t, key);
+	return i >= 0 ? t->values[i] : NULL;
+}
+
+/**
+ * table_int_remove() - Remove a key/value pair in the table.
+ * @t: Table to manipulate.
+ * @key: Key for which to remove pair.
+ *
+ * Will call any free function set for values. Does nothing if key is
+ * not found in the table.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(n)
+ */
+void table_int_remove(table_int *t, int key)
+{
+	int i = find_index(t, key);
+	if (i < 0) {
+		return;
+	}
+	if (t->value_free_func != NULL) {
+		t->value_free_func(t->values[i]);
+	}
+	// Move the last pair into the hole.
+	t->size--;
+	t->keys[i] = t->keys[t->size];
+	t->values[i] = t->values[t->size];
+	// Halve the arrays when less than a quarter is used.
+	if (t->capacity > MIN_CAPACITY && t->size < t->capacity / 4) {
+		set_capacity(t, t->capacity / 2);
+	}
+}
+
+/**
+ * table_int_kill() - Destroy a table.
+ * @t: Table to destroy.
+ *
+ * Return all dynamic memory used by the table. If a free function was
+ * registered for values at table creation, it is called for each
+ * value.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(n)
+ */
+void table_int_kill(table_int *t)
+{
+	if (t->value_free_func != NULL) {
+		for (int i = 0; i < t->size; i++) {
+			t->value_free_func(t->values[i]);
+		}
+	}
+	free(t->keys);
+	free(t->values);
+	free(t);
+}
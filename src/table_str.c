@@ -0,0 +1,393 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "table_str.h"
+#include "hash.h"
+
+/*
+ * Implementation of a table with string keys using an open-addressing
+ * hash index with linear probing, as in hashtable.c.
+ *
+ * The pairs are stored by value in a power-of-two sized array of
+ * 32-byte slots. A slot holds the first 8 bytes of its key as a word,
+ * the key length, a 32-bit hash of the key, the next 8 bytes of the key
+ * and the value. A key of up to TABLE_STR_INLINE bytes fits in the
+ * slot, a longer one is copied to the heap and the slot holds a pointer
+ * to the copy instead of the next 8 bytes.
+ *
+ * A search packs its key the same way once, and then compares the
+ * first word, the length and the hash of each probed slot. An inline
+ * key that passes is settled by one more word compare, so searches of
+ * short keys never leave the slot array. Only long keys that pass have
+ * the rest of their heap copy compared. Removal uses backward-shift
+ * deletion, so no tombstones are left behind.
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first version.
+ *   2026-10-16: v1.1, keys are hashed with hash_bytes() from hash.h.
+ */
+
+// Bytes of a key kept as a word in the slot, and bytes kept after it.
+#define PREFIX_BYTES 8
+#define REST_BYTES 8
+
+// Alignment of the slot array, so that no slot straddles two cache
+// lines.
+#define CACHE_LINE 64
+
+// Length of an empty slot.
+#define EMPTY UINT32_MAX
+
+// Initial number of slots, must be a power of two.
+#define INITIAL_CAPACITY 8
+
+// Maximum load factor, expressed as LOAD_NUM/LOAD_DEN.
+#define LOAD_NUM 3
+#define LOAD_DEN 4
+
+_Static_assert(PREFIX_BYTES + REST_BYTES == TABLE_STR_INLINE,
+	       "inline keys must fill the slot");
+_Static_assert(REST_BYTES >= sizeof(char *), "no room for a long key");
+
+// ===========INTERNAL DATA TYPES============
+
+typedef struct slot {
+	uint64_t prefix;	// Bytes [0, 7] of the key, zero padded.
+	uint32_t len;		// Length of the key, or EMPTY.
+	uint32_t hash;		// Hash of the key.
+	uint64_t rest;		// Bytes [8, 15] of an inline key, zero
+				// padded, or a pointer to a long key.
+	void *value;
+} slot;
+
+_Static_assert(sizeof(slot) == 32, "slots should be 32 bytes");
+
+struct table_str {
+	slot *slots;
+	int capacity; // Number of slots, a power of two.
+	int shift; // 64-log2(capacity), used to map a hash to a slot.
+	int size; // Number of occupied slots.
+	free_function value_free_func;
+};
+
+// ===========INTERNAL FUNCTION IMPLEMENTATIONS============
+
+/*
+ * Return the heap copy of the key of a slot with a long key.
+ */
+static char *long_key(const slot *s)
+{
+	char *key;
+	memcpy(&key, &s->rest, sizeof(key));
+	return key;
+}
+
+/*
+ * Read up to 8 bytes of a key as a word, zero padded.
+ */
+static uint64_t key_word(const char *p, size_t n)
+{
+	uint64_t w = 0;
+	if (n >= sizeof(w)) {
+		memcpy(&w, p, sizeof(w));
+	} else {
+		for (size_t i = 0; i < n; i++) {
+			w |= (uint64_t)(unsigned char)p[i] << (8 * i);
+		}
+	}
+	return w;
+}
+
+/*
+ * Set the prefix, length, hash and, for an inline key, the rest of a
+ * slot from a key. Returns false if the key is too long to be stored.
+ */
+static bool pack_key(slot *s, const char *key)
+{
+	size_t len = strlen(key);
+	if (len >= EMPTY) {
+		return false;
+	}
+	uint64_t h = hash_bytes(key, len);
+	s->prefix = key_word(key, len);
+	s->len = len;
+	s->hash = (uint32_t)h;
+	s->rest = len > PREFIX_BYTES && len <= TABLE_STR_INLINE ?
+		  key_word(key + PREFIX_BYTES, len - PREFIX_BYTES) : 0;
+	return true;
+}
+
+/*
+ * Return the home slot for a hash value. Fibonacci hashing spreads the
+ * hash over the slots.
+ */
+static int home_slot(const table_str *t, uint32_t hash)
+{
+	return (int)((hash * 0x9E3779B97F4A7C15ULL) >> t->shift);
+}
+
+/*
+ * Return the slot of the key packed in probe, or the empty slot that
+ * ends its probe sequence if the key is not in the table.
+ */
+static int find_slot(const table_str *t, const slot *probe, const char *key)
+{
+	int mask = t->capacity - 1;
+	int i = home_slot(t, probe->hash);
+	for (;; i = (i + 1) & mask) {
+		const slot *s = &t->slots[i];
+		if (s->len == EMPTY) {
+			return i;
+		}
+		if (s->prefix != probe->prefix || s->len != probe->len ||
+		    s->hash != probe->hash) {
+			continue;
+		}
+		if (probe->len <= TABLE_STR_INLINE ? s->rest == probe->rest :
+		    memcmp(long_key(s) + PREFIX_BYTES, key + PREFIX_BYTES,
+			   probe->len - PREFIX_BYTES) == 0) {
+			return i;
+		}
+	}
+}
+
+/*
+ * Return the first empty slot in the probe sequence of a hash value.
+ */
+static int empty_slot(const table_str *t, uint32_t hash)
+{
+	int mask = t->capacity - 1;
+	int i = home_slot(t, hash);
+	while (t->slots[i].len != EMPTY) {
+		i = (i + 1) & mask;
+	}
+	return i;
+}
+
+/*
+ * Allocate an empty slot array with the given capacity. Returns NULL if
+ * not enough memory was available.
+ */
+static slot *empty_slots(int capacity)
+{
+	slot *slots = aligned_alloc(CACHE_LINE, capacity * sizeof(slot));
+	if (slots != NULL) {
+		for (int i = 0; i < capacity; i++) {
+			slots[i].len = EMPTY;
+		}
+	}
+	return slots;
+}
+
+/*
+ * Allocate a new slot array with the given capacity and move all pairs
+ * to it. Returns false if not enough memory was available, the table is
+ * unchanged in that case.
+ */
+static bool rehash(table_str *t, int capacity)
+{
+	slot *slots = empty_slots(capacity);
+	if (slots == NULL) {
+		return false;
+	}
+	slot *old_slots = t->slots;
+	int old_capacity = t->capacity;
+	t->slots = slots;
+	t->capacity = capacity;
+	t->shift = 64;
+	for (int c = capacity; c > 1; c >>= 1) {
+		t->shift--;
+	}
+	for (int j = 0; j < old_capacity; j++) {
+		if (old_slots[j].len != EMPTY) {
+			t->slots[empty_slot(t, old_slots[j].hash)] = old_slots[j];
+		}
+	}
+	free(old_slots);
+	return true;
+}
+
+/*
+ * Free the heap copy of the key of a slot, if it has one.
+ */
+static void free_key(slot *s)
+{
+	if (s->len > TABLE_STR_INLINE) {
+		free(long_key(s));
+	}
+}
+
+// ===========DATA STRUCTURE INTERFACE IMPLEMENTATION============
+
+/**
+ * table_str_empty() - Create an empty table with string keys.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Return: Pointer to a new table, or NULL if not enough memory was
+ * available.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+table_str *table_str_empty(free_function value_free_func)
+{
+	table_str *t = calloc(1, sizeof(*t));
+	if (t == NULL) {
+		return NULL;
+	}
+	if (!rehash(t, INITIAL_CAPACITY)) {
+		free(t);
+		return NULL;
+	}
+	t->value_free_func = value_free_func;
+	return t;
+}
+
+/**
+ * table_str_is_empty() - Check if a table is empty.
+ * @t: Table to check.
+ *
+ * Return: True if table contains no key/value pairs, false otherwise.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+bool table_str_is_empty(const table_str *t)
+{
+	return t->size == 0;
+}
+
+/**
+ * table_str_insert() - Add a key/value pair to a table.
+ * @t: Table to manipulate.
+ * @key: The key, a string that is copied by the table.
+ * @value: A pointer to the value value.
+ *
+ * Insert the key/value pair into the table. If the key is already in
+ * the table, its old value is replaced (and free'd if a free function
+ * was registered).
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(1) amortized
+ */
+void table_str_insert(table_str *t, const char *key, void *value)
+{
+	slot probe;
+	if (!pack_key(&probe, key)) {
+		return;
+	}
+	int i = find_slot(t, &probe, key);
+	if (t->slots[i].len != EMPTY) {
+		if (t->value_free_func != NULL) {
+			t->value_free_func(t->slots[i].value);
+		}
+		t->slots[i].value = value;
+		return;
+	}
+	if ((t->size + 1) * LOAD_DEN > t->capacity * LOAD_NUM) {
+		// Grow before the load factor is exceeded. The key is not
+		// in the table, so it goes to the first empty slot.
+		if (!rehash(t, t->capacity * 2)) {
+			return;
+		}
+		i = empty_slot(t, probe.hash);
+	}
+	if (probe.len > TABLE_STR_INLINE) {
+		char *copy = malloc(probe.len + 1);
+		if (copy == NULL) {
+			return;
+		}
+		memcpy(copy, key, probe.len + 1);
+		memcpy(&probe.rest, &copy, sizeof(copy));
+	}
+	probe.value = value;
+	t->slots[i] = probe;
+	t->size++;
+}
+
+/**
+ * table_str_lookup() - Look up a given key in a table.
+ * @t: Table to inspect.
+ * @key: Key to look up.
+ *
+ * Return: The value corresponding to a given key, or NULL if the key
+ * is not found in the table.
+ * Simplified asymptotic complexity analysis : O(1) expected
+ */
+void *table_str_lookup(const table_str *t, const char *key)
+{
+	slot probe;
+	if (!pack_key(&probe, key)) {
+		return NULL;
+	}
+	int i = find_slot(t, &probe, key);
+	return t->slots[i].len != EMPTY ? t->slots[i].value : NULL;
+}
+
+/**
+ * table_str_remove() - Remove a key/value pair in the table.
+ * @t: Table to manipulate.
+ * @key: Key for which to remove pair.
+ *
+ * Will call any free function set for values. Does nothing if key is
+ * not found in the table.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(1) expected
+ */
+void table_str_remove(table_str *t, const char *key)
+{
+	slot probe;
+	if (!pack_key(&probe, key)) {
+		return;
+	}
+	int mask = t->capacity - 1;
+	int i = find_slot(t, &probe, key);
+	if (t->slots[i].len == EMPTY) {
+		return;
+	}
+	if (t->value_free_func != NULL) {
+		t->value_free_func(t->slots[i].value);
+	}
+	free_key(&t->slots[i]);
+	t->size--;
+
+	// Backward-shift deletion, see table_remove() in hashtable.c.
+	int j = i;
+	for (;;) {
+		j = (j + 1) & mask;
+		if (t->slots[j].len == EMPTY) {
+			break;
+		}
+		int home = home_slot(t, t->slots[j].hash);
+		if (((j - home) & mask) >= ((j - i) & mask)) {
+			t->slots[i] = t->slots[j];
+			i = j;
+		}
+	}
+	t->slots[i].len = EMPTY;
+}
+
+/**
+ * table_str_kill() - Destroy a table.
+ * @t: Table to destroy.
+ *
+ * Return all dynamic memory used by the table. If a free function was
+ * registered for values at table creation, it is called for each
+ * value.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(capacity)
+ */
+void table_str_kill(table_str *t)
+{
+	for (int i = 0; i < t->capacity; i++) {
+		if (t->slots[i].len == EMPTY) {
+			continue;
+		}
+		if (t->value_free_func != NULL) {
+			t->value_free_func(t->slots[i].value);
+		}
+		free_key(&t->slots[i]);
+	}
+	free(t->slots);
+	free(t);
+}
@@ -22,10 +22,91 @@
  * 2018-02-20 v1.5 Niclas Borlin <niclas@cs.umu.se>.
  *                 Now completely destroys and rebuilds table between timed
  *                 tests to reduce cache effects.
+ * 2026-10-16 v1.6 Tables are created with a key hash function, so the
+ *                 test can be run against hashed implementations. Compile
+ *                 with -DTABLE_BACKEND_HASH to test hashtable.c instead of
+ *                 arraytable.c.
+ * 2026-10-16 v1.7 Added correctness and speed tests for the int-keyed
+ *                 table in table_int.h.
+ * 2026-10-16 v1.8 Added tests of table_insert_batch() and of the sorted
+ *                 table mode. The speed test is repeated in sorted mode
+ *                 if the implementation supports it.
+ * 2026-10-16 v1.9 The batch test also covers the self-organizing modes.
+ *                 The skewed lookup test is repeated for each mode the
+ *                 implementation supports.
+ * 2026-10-16 v1.10 Added a speed test of table_lookup_batch() and a
+ *                 check of its results to the batch test.
+ * 2026-10-16 v1.11 Added tests of table_from_arrays().
+ * 2026-10-16 v1.12 Added tests of tables with keys and values allocated
+ *                 from the table arena.
+ * 2026-10-16 v1.13 Added tests of table_foreach() and the table
+ *                 iterators.
+ * 2026-10-16 v1.14 Added tests of the sharded table in shardtable.h and
+ *                 a multi-threaded benchmark, selected with -t.
+ * 2026-10-16 v1.15 Added a stress test of the lock-free table in
+ *                 lftable.h, which is also run by the multi-threaded
+ *                 benchmark.
+ * 2026-10-16 v1.16 Added tests of the read-copy-update table in
+ *                 rcutable.h and a benchmark of readers running next to
+ *                 one writer, selected with -t.
+ * 2026-10-16 v1.17 Added tests of the parallel build, lookup and kill
+ *                 using a thread pool, and a benchmark of them that is
+ *                 run with -t.
+ * 2026-10-16 v1.18 Benchmarks are timed in nanoseconds with the
+ *                 monotonic clock, repeated after warmup runs, and
+ *                 reported as ns/op with median, p99 and stddev. The
+ *                 results can be written as JSON or CSV.
+ * 2026-10-16 v1.19 Added YCSB-style workloads from workload.h, selected
+ *                 with -p, and a test of the workload generator.
+ * 2026-10-16 v1.20 n is no longer capped at 40000. Added a sweep of
+ *                 table sizes up to n, selected with -s, that reports
+ *                 ns/op and bytes/entry at each size.
+ * 2026-10-16 v1.21 If the table implementation is compiled with
+ *                 TABLE_STATS, the operation counts and probe lengths of
+ *                 the tables of each benchmark are printed after it.
+ * 2026-10-16 v1.22 Benchmarks report cycles, instructions, cache misses
+ *                 and branch misses per operation from the hardware
+ *                 counters in perfcount.h, where they are available.
+ * 2026-10-16 v1.23 Benchmarks report the memory of the table itself per
+ *                 entry from table_memory_usage(). Added a test of
+ *                 table_memory_breakdown().
+ * 2026-10-16 v1.24 Added tests and benchmarks of table_save() and
+ *                 table_load_mmap().
+ * 2026-10-16 v1.25 Added tests of the durable table in waltable.h, and
+ *                 benchmarks of its inserts with group commit and of
+ *                 replaying its log.
+ * 2026-10-16 v1.26 Added tests and benchmarks of the string-keyed table
+ *                 in table_str.h.
+ * 2026-10-16 v1.27 Tables are created with the built-in hash functions
+ *                 in hash.h instead of hash functions of their own. Added
+ *                 a test and a benchmark of the hash functions.
+ * 2026-10-16 v1.28 Durable table lookups copy the value. The threads of
+ *                 the durable table test look up their keys while
+ *                 checkpoints are made.
+ * 2026-10-16 v1.29 The durable table test reopens a table from a
+ *                 checkpoint and the log as it was before it.
+ * 2026-10-16 v1.30 The memory breakdown of a mapped table is checked.
+ * 2026-10-16 v1.31 The lock-free table test checks the bound on
+ *                 distinct keys.
+ * 2026-10-16 v1.32 Tests 2-8 use table_empty() again, as before v1.6,
+ *                 and are run a second time on tables with a key hash
+ *                 function.
+ * 2026-10-16 v1.33 The snapshot test saves from two threads to the same
+ *                 file at the same time.
 */
 
-#define VERSION "v1.5"
-#define VERSION_DATE "2018-02-20"
+#define VERSION "v1.33"
+#define VERSION_DATE "2026-10-16"
+#define NAME "tabletest"
+
+#ifdef TABLE_BACKEND_HASH
+#define BACKEND "hashtable"
+#else
+#define BACKEND "arraytable"
+#endif
+
+#define USAGE "[-s] [-t threads] [-p profiles] [-w warmup] [-r trials] " \
+        "[-f text|json|csv]"
 
 /*
  * Correctness testing algorithm:
@@ -54,19 +135,173 @@
  *    that it is gone and that the other key returns the cocorrect
  *    value. The second key is removed and it is checked that the
  *    table is empty.
+ *    Tests 2-8 are run twice, on tables made by table_empty() and on
+ *    tables made by table_empty_with_hash().
+ * 9. Tests the int-keyed table by inserting, overwriting, looking up
+ *    and removing keys.
+ * 10. Tests table_insert_batch() with duplicate keys in each table mode
+ *     the implementation supports, followed by lookups and removals.
+ * 11. Tests table_from_arrays() with duplicate keys, followed by
+ *     lookups and removals.
+ * 12. Tests a table whose keys and values are allocated from the table
+ *     arena, with inserts, overwrites, lookups and removals.
+ * 13. Tests that table_foreach() and the table iterators visit each
+ *     key/value pair exactly once.
+ * 14. Tests the sharded table, first from one thread and then with
+ *     several threads inserting at the same time.
+ * 15. Checks that the lock-free table takes max_keys distinct keys,
+ *     even if they are removed again, and then stress tests it with
+ *     several threads inserting, removing and looking up the same keys,
+ *     checking every value that is found while it can still be read.
+ * 16. Tests the read-copy-update table from one thread, then with one
+ *     writer thread changing the keys while reader threads check the
+ *     values they find.
+ * 17. Tests table_from_arrays_parallel(), table_lookup_batch_parallel()
+ *     and table_kill_parallel() on a thread pool against the serial
+ *     versions.
+ * 18. Runs each workload profile against a table, checking that reads,
+ *     updates and removes name keys in the table, that inserts name
+ *     new keys, and that the number of keys stays steady. Also checks
+ *     that the generator is repeatable and that Zipfian keys are
+ *     skewed and uniform keys are not.
+ * 19. Tests table_memory_usage() and table_memory_breakdown() while
+ *     keys are inserted, overwritten and removed, and memory is
+ *     allocated from the table arena.
+ * 20. Saves a table with table_save() and loads it with
+ *     table_load_mmap(), checking the pairs of the loaded table before
+ *     and after it is first changed, and again after saving and
+ *     loading the changed table, and after two threads save it to the
+ *     same file at once. Also checks that a corrupt or missing file is
+ *     not loaded.
+ * 21. Tests the durable table: changes that were synced survive closing
+ *     and reopening it, before and after a checkpoint, a torn record at
+ *     the end of the log is dropped on replay, and changes synced by
+ *     several threads at the same time, with checkpoints in between,
+ *     all survive.
+ * 22. Tests the string-keyed table with inline and long keys, including
+ *     keys that share their first bytes and length, by inserting,
+ *     overwriting, looking up and removing keys.
+ * 23. Tests the built-in hash functions: equal keys hash equally, the
+ *     batch variants match, every byte of a key changes its hash, and
+ *     consecutive ints and similar strings spread evenly over buckets.
  *
  * There is also a module measuring time for insertions, lookups etc.
+ * Each benchmark builds its own table before the timing starts, is run
+ * -w times untimed and then -r times timed, and is reported as ns per
+ * operation: the median, p99 and standard deviation of the trials.
+ * Where the hardware counters of perfcount.h are available, the timed
+ * parts are also counted, and the events per operation over all trials
+ * are reported, as is the memory of the table itself per entry, see
+ * table_memory_usage(). Only the calling thread is counted, so the counts of
+ * the parallel benchmarks leave out the work of the pool threads.
+ * With -f json or -f csv, the results are written to stdout in that
+ * format and all other output goes to stderr. If the table
+ * implementation is compiled with TABLE_STATS, each result is followed
+ * by the operation counts of the tables of its last trial, see
+ * table_get_stats(), which are part of the other output.
+ *
+ * The snapshot benchmarks time table_save(), table_load_mmap() and
+ * lookups in a freshly loaded table, which are served from the mapped
+ * file until the table is changed.
+ * The durable table benchmarks time inserts into a waltable that
+ * syncs after every insert and after every WAL_SYNC_BATCH inserts, and
+ * opening a waltable by replaying a log of n inserts.
+ * The hash benchmarks time the functions of hash.h one key at a time
+ * and in batches, with FNV-1a as a baseline for strings.
+ *
+ * The speed tests end with YCSB-style workloads from workload.h, mixed
+ * reads, updates, inserts and removes on Zipfian or uniform keys. With
+ * -p, only the given comma-separated profiles (or "all") are run.
+ *
+ * With -s, the speed tests are replaced by a sweep of table sizes from
+ * SWEEP_MIN, doubling up to n, which crosses the cache levels. Each
+ * size reports the time of a build and of lookups that hit, miss and
+ * are batched, and the bytes used per entry.
+ * With -t, the single-threaded speed tests are replaced by a benchmark
+ * of a mixed workload on a table guarded by one mutex, the sharded
+ * table and the lock-free table, run with 1, 2, 4, ... threads, and
+ * by a benchmark of 1, 2, 4, ... reader threads running next to one
+ * writer thread, and by a comparison of the serial and parallel bulk
+ * operations.
  * */
+#include <errno.h>
+#include <limits.h>
+#include <math.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <sys/time.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
 #include "table.h"
+#include "hash.h"
+#include "table_int.h"
+#include "table_str.h"
+#include "shardtable.h"
+#include "lftable.h"
+#include "rcutable.h"
+#include "workload.h"
+#include "perfcount.h"
+#include "waltable.h"
 
-// Maximum size of the table to generate
+// Size of the table to generate if none is given. Any size up to
+// MAX_TABLESIZE can be given, the sample arrays hold 2n keys.
 #define TABLESIZE 40000
-#define SAMPLESIZE TABLESIZE*2
+#define MAX_TABLESIZE (INT_MAX/2)
+
+// Smallest table size of the size sweep, and the largest number of
+// lookups timed per trial at each size.
+#define SWEEP_MIN 1024
+#define SWEEP_OPS (1<<20)
+
+// Number of operations done by each thread in the multi-threaded
+// benchmark, and the number of shards of the sharded table.
+#define THREAD_OPS 500000
+#define THREAD_SHARDS 64
+
+// Default number of untimed runs and of timed trials of each benchmark.
+#define BENCH_WARMUP 1
+#define BENCH_TRIALS 5
+
+// Number of pairs used by the test of the parallel operations, and the
+// number of threads of its pool.
+#define PARALLEL_TEST_PAIRS 50000
+#define PARALLEL_TEST_THREADS 4
+
+// Number of keys and of operations per profile in the test of the
+// workload generator.
+#define WORKLOAD_TEST_KEYS 1000
+#define WORKLOAD_TEST_OPS 20000
+
+// Number of keys in the test of the memory accounting.
+#define MEMORY_TEST_KEYS 100
+
+// Number of keys in the test of the snapshots, and the name of the
+// snapshot files, see make_snapshot_path().
+#define SNAPSHOT_TEST_KEYS 1000
+// Number of times each of two threads saves a snapshot to the same file
+// in test_snapshot().
+#define SNAPSHOT_TEST_SAVES 20
+#define SNAPSHOT_PATH_TEMPLATE "/tmp/tabletest-XXXXXX"
+
+// Number of keys and of threads in the test of the durable table, and
+// the log size at which its threads make checkpoints.
+#define WAL_TEST_KEYS 1000
+#define WAL_TEST_THREADS 4
+#define WAL_TEST_CHECKPOINT 4096
+
+// Number of inserts per sync in the group commit benchmark, and the
+// largest number of inserts timed when every insert is synced.
+#define WAL_SYNC_BATCH 64
+#define WAL_SYNC_OPS 1000
+
+// Number of keys in the test of the hash functions, the number of
+// buckets they must spread evenly over, and the longest block hashed.
+#define HASH_TEST_KEYS 65536
+#define HASH_TEST_BUCKETS 256
+#define HASH_TEST_BLOCK 64
 
 /**
  * copy_string() - Create a dynamic copy of a string.
@@ -116,15 +351,16 @@ int *int_ptr_from_int(int i)
 }
 
 /**
- * get_milliseconds() - Return the current time-of-day in milliseconds.
+ * get_nanoseconds() - Return the time of the monotonic clock in
+ * nanoseconds.
  *
- * Returns: The current time-of-day in milliseconds.
+ * Returns: The current time of CLOCK_MONOTONIC in nanoseconds.
  */
-unsigned long get_milliseconds()
+uint64_t get_nanoseconds()
 {
-        struct timeval tv;
-        gettimeofday(&tv, 0);
-        return (unsigned long)(tv.tv_sec*1000 + tv.tv_usec/1000);
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec*1000000000 + (uint64_t)ts.tv_nsec;
 }
 
 /**
@@ -143,6 +379,18 @@ int int_compare(const void *ip1,const void *ip2)
         return (*n1 - *n2);
 }
 
+/**
+ * int_size() - Return the size of a dynamic integer.
+ * @ip: Pointer to the integer.
+ *
+ * Returns: sizeof(int), the bytes allocated by int_ptr_from_int().
+ */
+size_t int_size(const void *ip)
+{
+        (void)ip;
+        return sizeof(int);
+}
+
 /**
  * string_compare() - Compare two strings.
  * @ip1, @ip2: Pointers to strings to be compared.
@@ -159,6 +407,27 @@ int string_compare(const void *ip1,const void *ip2)
         return strcmp(s1,s2);
 }
 
+/**
+ * fnv1a_hash() - Hash a string a byte at a time.
+ * @ip: Pointer to the string to be hashed.
+ *
+ * Computes the 64-bit FNV-1a hash of the string. The tables of the
+ * tests use hash_string() from hash.h, this is the baseline it is
+ * compared with in the hash benchmark.
+ *
+ * Returns: The hash value.
+ */
+uint64_t fnv1a_hash(const void *ip)
+{
+        const unsigned char *s=ip;
+        uint64_t h=0xcbf29ce484222325ULL;
+        while (*s) {
+                h^=*s++;
+                h*=0x100000001b3ULL;
+        }
+        return h;
+}
+
 /* Shuffles the numbers stored in seq
  *    seq - an array of randomnumbers to be shuffled
  *    n - the number of elements in seq to shuffle, i.e the indexes [0, n]
@@ -204,120 +473,718 @@ void insert_values(table *t, int *keys, int *values, int n)
 }
 
 
+/* Return a printable name for a table mode.
+ */
+const char *mode_name(table_mode mode)
+{
+        switch (mode) {
+        case TABLE_MODE_UNORDERED:
+                return "unordered";
+        case TABLE_MODE_SORTED:
+                return "sorted";
+        case TABLE_MODE_MOVE_TO_FRONT:
+                return "move-to-front";
+        case TABLE_MODE_TRANSPOSE:
+                return "transpose";
+        case TABLE_MODE_COUNT:
+                return "count";
+        }
+        return "unknown";
+}
+
+/* Create an empty table with int keys for the speed tests.
+ *    mode - the storage mode to use
+ */
+table *create_int_table(table_mode mode)
+{
+        table *t = table_empty_with_hash(int_compare, hash_int, free, free);
+        table_set_mode(t, mode);
+        return t;
+}
+
+// Output formats of the benchmark results.
+typedef enum bench_format {
+        FORMAT_TEXT,
+        FORMAT_JSON,
+        FORMAT_CSV,
+} bench_format;
+
+// Benchmark settings, set from the command line.
+static int bench_warmup = BENCH_WARMUP;
+static int bench_trials = BENCH_TRIALS;
+static bench_format bench_output = FORMAT_TEXT;
+
+// Stream that the results are written to, and the number of results
+// written so far.
+static FILE *bench_file;
+static int bench_count;
+
+// Bytes per entry of the measured table, reported with the results
+// while it is not negative. If it is negative, the bytes per entry of
+// the last table of the benchmark that held any keys are reported,
+// see bench_collect().
+static double bench_bytes = -1;
+static double bench_table_bytes = -1;
+
+// Hardware counters of the calling thread, or NULL if none could be
+// opened, and the events counted by the timed trials of a benchmark.
+static perfcount *bench_counters;
+static uint64_t bench_counts[PERFCOUNT_EVENTS];
+
+// Type of a benchmark. A benchmark sets up its own table, times the
+// operations on it, cleans up, and returns the timed part in
+// nanoseconds, so that it can be repeated as often as needed.
+typedef uint64_t speed_phase(table_mode mode, int *keys, int *values, int n);
+
+// Statistics of the trials of a benchmark, in nanoseconds per
+// operation.
+typedef struct bench_stats {
+        double median;
+        double p99;
+        double mean;
+        double stddev;
+        double min;
+        double ops_per_s; // Throughput at the median time.
+        double bytes_per_entry; // Memory per entry, or negative.
+        // Hardware events per operation over all trials, negative for
+        // events that are not counted.
+        double events[PERFCOUNT_EVENTS];
+} bench_stats;
+
+/* Compare two doubles for qsort.
+ */
+int double_compare(const void *p1, const void *p2)
+{
+        double d1 = *(const double *)p1;
+        double d2 = *(const double *)p2;
+        return (d1 > d2) - (d1 < d2);
+}
+
+/* Compute the statistics of k samples. The samples are sorted. The p99
+ * is the nearest-rank percentile, and stddev the sample standard
+ * deviation.
+ */
+bench_stats compute_stats(double *x, int k)
+{
+        bench_stats s;
+        qsort(x, k, sizeof(double), double_compare);
+        s.min = x[0];
+        s.median = k%2 ? x[k/2] : (x[k/2-1] + x[k/2])/2;
+        int rank = (int)ceil(0.99*k);
+        s.p99 = x[rank > 0 ? rank-1 : 0];
+        s.mean = 0;
+        for (int i = 0; i < k; i++) {
+                s.mean += x[i];
+        }
+        s.mean /= k;
+        s.stddev = 0;
+        for (int i = 0; i < k; i++) {
+                s.stddev += (x[i] - s.mean)*(x[i] - s.mean);
+        }
+        s.stddev = k > 1 ? sqrt(s.stddev/(k-1)) : 0;
+        s.ops_per_s = s.median > 0 ? 1e9/s.median : 0;
+        return s;
+}
+
+/* Write the start of the benchmark results.
+ *    n - the number of elements used by the speed tests
+ */
+void bench_begin(int n)
+{
+        switch (bench_output) {
+        case FORMAT_TEXT:
+                fprintf(bench_file, "ns per operation, median of %d trials "
+                        "after %d warmup runs:\n", bench_trials,
+                        bench_warmup);
+                break;
+        case FORMAT_JSON:
+                fprintf(bench_file, "{\"version\": \"%s\", \"backend\": "
+                        "\"%s\", \"n\": %d, \"warmup\": %d, \"trials\": "
+                        "%d, \"results\": [", VERSION, BACKEND, n,
+                        bench_warmup, bench_trials);
+                break;
+        case FORMAT_CSV:
+                fprintf(bench_file, "backend,benchmark,variant,n,trials,"
+                        "median_ns,p99_ns,mean_ns,stddev_ns,min_ns,"
+                        "ops_per_s,bytes_per_entry");
+                for (int e = 0; e < PERFCOUNT_EVENTS; e++) {
+                        fprintf(bench_file, ",%s_per_op",
+                                perfcount_event_name(e));
+                }
+                fprintf(bench_file, "\n");
+                break;
+        }
+}
+
+/* Write the end of the benchmark results.
+ */
+void bench_end()
+{
+        if (bench_output == FORMAT_JSON) {
+                fprintf(bench_file, "\n]}\n");
+        }
+        fflush(bench_file);
+}
+
+/* Write the result of a benchmark.
+ *    name - the name of the benchmark
+ *    variant - the table mode or implementation that was measured
+ *    n - the number of operations per trial
+ *    s - the statistics of the trials
+ */
+void bench_report(const char *name, const char *variant, int n,
+                  const bench_stats *s)
+{
+        char bytes[32] = "";
+        char events[256] = "";
+        int len = 0;
+        switch (bench_output) {
+        case FORMAT_TEXT:
+                if (s->bytes_per_entry >= 0) {
+                        sprintf(bytes, ", %6.1f B/entry", s->bytes_per_entry);
+                }
+                for (int e = 0; e < PERFCOUNT_EVENTS; e++) {
+                        if (s->events[e] >= 0) {
+                                len += sprintf(events + len, "%s %.2f %s/op",
+                                               len ? "," : "", s->events[e],
+                                               perfcount_event_name(e));
+                        }
+                }
+                if (s->events[PERFCOUNT_CYCLES] > 0 &&
+                    s->events[PERFCOUNT_INSTRUCTIONS] >= 0) {
+                        sprintf(events + len, ", IPC %.2f",
+                                s->events[PERFCOUNT_INSTRUCTIONS]/
+                                s->events[PERFCOUNT_CYCLES]);
+                }
+                fprintf(bench_file, "%-20s %-14s %9d: %10.1f ns/op, p99 "
+                        "%10.1f, stddev %8.1f, %8.3f Mops/s%s\n", name,
+                        variant, n, s->median, s->p99, s->stddev,
+                        s->ops_per_s/1e6, bytes);
+                if (len > 0) {
+                        fprintf(bench_file, "%20s%s\n", "", events);
+                }
+                break;
+        case FORMAT_JSON:
+                if (s->bytes_per_entry >= 0) {
+                        sprintf(bytes, ", \"bytes_per_entry\": %.2f",
+                                s->bytes_per_entry);
+                }
+                for (int e = 0; e < PERFCOUNT_EVENTS; e++) {
+                        if (s->events[e] >= 0) {
+                                len += sprintf(events + len,
+                                               ", \"%s_per_op\": %.3f",
+                                               perfcount_event_name(e),
+                                               s->events[e]);
+                        }
+                }
+                fprintf(bench_file, "%s\n  {\"benchmark\": \"%s\", "
+                        "\"variant\": \"%s\", \"n\": %d, \"median_ns\": "
+                        "%.2f, \"p99_ns\": %.2f, \"mean_ns\": %.2f, "
+                        "\"stddev_ns\": %.2f, \"min_ns\": %.2f, "
+                        "\"ops_per_s\": %.0f%s%s}",
+                        bench_count ? "," : "", name, variant, n, s->median,
+                        s->p99, s->mean, s->stddev, s->min, s->ops_per_s,
+                        bytes, events);
+                break;
+        case FORMAT_CSV:
+                if (s->bytes_per_entry >= 0) {
+                        sprintf(bytes, "%.2f", s->bytes_per_entry);
+                }
+                for (int e = 0; e < PERFCOUNT_EVENTS; e++) {
+                        len += sprintf(events + len, ",");
+                        if (s->events[e] >= 0) {
+                                len += sprintf(events + len, "%.3f",
+                                               s->events[e]);
+                        }
+                }
+                fprintf(bench_file, "%s,%s,%s,%d,%d,%.2f,%.2f,%.2f,%.2f,"
+                        "%.2f,%.0f,%s%s\n", BACKEND, name, variant, n,
+                        bench_trials, s->median, s->p99, s->mean, s->stddev,
+                        s->min, s->ops_per_s, bytes, events);
+                break;
+        }
+        bench_count++;
+}
+
+// Operation counts of the tables killed by the current trial of a
+// benchmark, see bench_kill().
+static table_stats bench_table_stats;
+
+/* Add the operation counts of a table to bench_table_stats, if the
+ * table implementation keeps them, and set bench_table_bytes to the
+ * memory of the table itself per entry, if it holds any keys.
+ *    t - the table
+ */
+void bench_collect(const table *t)
+{
+        table_memory mem;
+        table_memory_breakdown(t, NULL, NULL, &mem);
+        if (mem.pairs > 0) {
+                bench_table_bytes = (double)mem.total/mem.pairs;
+        }
+        table_stats s;
+        if (!table_get_stats(t, &s)) {
+                return;
+        }
+        uint64_t *sum = (uint64_t *)&bench_table_stats;
+        const uint64_t *add = (const uint64_t *)&s;
+        for (size_t i = 0; i < sizeof(s)/sizeof(uint64_t); i++) {
+                sum[i] += add[i];
+        }
+}
+
+/* Kill a table of a benchmark, after collecting its operation counts
+ * and memory use, see bench_collect().
+ *    t - the table
+ */
+void bench_kill(table *t)
+{
+        bench_collect(t);
+        table_kill(t);
+}
+
+/* Print operation counts of tables, with the probe length histogram
+ * of the key searches. Bucket b > 0 holds the searches that examined
+ * 2^(b-1) to 2^b-1 entries.
+ *    s - the operation counts
+ */
+void print_table_stats(const table_stats *s)
+{
+        printf("%20s inserts %llu, overwrites %llu, lookups %llu "
+               "(hits %llu, misses %llu), removes %llu, compares %llu, "
+               "allocations %llu\n", "",
+               (unsigned long long)s->inserts,
+               (unsigned long long)s->overwrites,
+               (unsigned long long)s->lookups,
+               (unsigned long long)s->hits,
+               (unsigned long long)s->misses,
+               (unsigned long long)s->removes,
+               (unsigned long long)s->compares,
+               (unsigned long long)s->allocations);
+        if (s->searches == 0) {
+                return;
+        }
+        printf("%20s probes per search %.2f:", "",
+               (double)s->probe_total/s->searches);
+        for (int b = 0; b < TABLE_STATS_PROBE_BUCKETS; b++) {
+                if (s->probes[b] == 0) {
+                        continue;
+                }
+                long lo = b > 0 ? 1L << (b-1) : 0;
+                long hi = b > 0 ? (1L << b) - 1 : 0;
+                if (lo == hi) {
+                        printf(" %ld: %llu", lo,
+                               (unsigned long long)s->probes[b]);
+                } else {
+                        printf(" %ld-%ld: %llu", lo, hi,
+                               (unsigned long long)s->probes[b]);
+                }
+        }
+        printf("\n");
+}
+
+/* Start the timed part of a benchmark, and the hardware counters.
+ * Returns: The current time in nanoseconds.
+ */
+uint64_t bench_start()
+{
+        if (bench_counters != NULL) {
+                perfcount_start(bench_counters);
+        }
+        return get_nanoseconds();
+}
+
+/* End the timed part of a benchmark, and add the events counted since
+ * bench_start() to bench_counts.
+ * Returns: The current time in nanoseconds.
+ */
+uint64_t bench_stop()
+{
+        uint64_t now = get_nanoseconds();
+        if (bench_counters != NULL) {
+                uint64_t counts[PERFCOUNT_EVENTS];
+                perfcount_stop(bench_counters, counts);
+                for (int e = 0; e < PERFCOUNT_EVENTS; e++) {
+                        bench_counts[e] += counts[e];
+                }
+        }
+        return now;
+}
+
+/* Run a benchmark bench_warmup times without timing it, then
+ * bench_trials times, and report the time per operation. If the table
+ * implementation keeps operation counts, the counts of the tables of
+ * the last trial, setup included, are printed after the result.
+ *    name - the name of the benchmark
+ *    variant - the table mode or implementation that is measured
+ *    phase - the benchmark
+ *    mode - the storage mode passed to the benchmark
+ *    keys - a list of keys to use
+ *    values - a list of values to use
+ *    n - the size passed to the benchmark
+ *    ops - the number of operations the benchmark times
+ */
+void run_phase_ops(const char *name, const char *variant, speed_phase *phase,
+                   table_mode mode, int *keys, int *values, int n, int ops)
+{
+        double *ns = malloc(bench_trials*sizeof(double));
+        for (int i = 0; i < bench_warmup; i++) {
+                phase(mode, keys, values, n);
+        }
+        memset(bench_counts, 0, sizeof(bench_counts));
+        bench_table_bytes = -1;
+        for (int i = 0; i < bench_trials; i++) {
+                memset(&bench_table_stats, 0, sizeof(bench_table_stats));
+                ns[i] = (double)phase(mode, keys, values, n)/ops;
+        }
+        bench_stats s = compute_stats(ns, bench_trials);
+        s.bytes_per_entry = bench_bytes >= 0 ? bench_bytes : bench_table_bytes;
+        for (int e = 0; e < PERFCOUNT_EVENTS; e++) {
+                s.events[e] = bench_counters != NULL &&
+                        perfcount_available(bench_counters, e) ?
+                        (double)bench_counts[e]/ops/bench_trials : -1;
+        }
+        bench_report(name, variant, n, &s);
+        table_stats none = { 0 };
+        if (memcmp(&bench_table_stats, &none, sizeof(none)) != 0) {
+                print_table_stats(&bench_table_stats);
+        }
+        free(ns);
+}
+
+/* Run a benchmark of n operations, see run_phase_ops().
+ */
+void run_phase(const char *name, const char *variant, speed_phase *phase,
+               table_mode mode, int *keys, int *values, int n)
+{
+        run_phase_ops(name, variant, phase, mode, keys, values, n, n);
+}
+
+/* Create an int-keyed table in the given mode, filled with n pairs.
+ *    mode - the storage mode to use
+ *    keys - a list of keys to use
+ *    values - a list of values to use
+ */
+table *create_filled_int_table(table_mode mode, int *keys, int *values,
+                               int n)
+{
+        table *t = create_int_table(mode);
+        insert_values(t,keys,values,n);
+        return t;
+}
+
 /* Measures time taken to fill a table with values
- *    table - the table to fill
+ *    mode - the storage mode of the table
  *    keys - a list of keys to use
  *    values - a list of values to use
+ *    n - the number of pairs
+ * Returns: The elapsed time in nanoseconds.
  */
-void get_insert_speed(table *t, int *keys, int *values, int n)
+uint64_t get_insert_speed(table_mode mode, int *keys, int *values, int n)
 {
-        unsigned long start;
-        unsigned long end;
+        table *t = create_int_table(mode);
+        uint64_t start = bench_start();
+        insert_values(t,keys,values,n);
+        uint64_t end = bench_stop();
+        bench_kill(t);
+        return end-start;
+}
 
-        // Insert all items
-        printf("Insert %5d items                   : ", n);
-        start = get_milliseconds();
+/* Measures time taken to fill a table with values in one batch
+ *    mode - the storage mode of the table
+ *    keys - a list of keys to use
+ *    values - a list of values to use
+ *    n - the number of pairs
+ * Returns: The elapsed time in nanoseconds.
+ */
+uint64_t get_batch_insert_speed(table_mode mode, int *keys, int *values,
+                                int n)
+{
+        // The keys and values are allocated before timing starts
+        void **key_ptrs = malloc(n*sizeof(void *));
+        void **value_ptrs = malloc(n*sizeof(void *));
+        for(int i=0;i<n;i++) {
+                key_ptrs[i] = int_ptr_from_int(keys[i]);
+                value_ptrs[i] = int_ptr_from_int(values[i]);
+        }
+        table *t = create_int_table(mode);
+        uint64_t start = bench_start();
+        table_insert_batch(t, key_ptrs, value_ptrs, n);
+        uint64_t end = bench_stop();
+        bench_kill(t);
+        free(key_ptrs);
+        free(value_ptrs);
+        return end-start;
+}
+
+/* Measures time taken to build a table from arrays of keys and values
+ *    mode - not used, tables are built in unordered mode
+ *    keys - a list of keys to use
+ *    values - a list of values to use
+ *    n - the number of pairs
+ * Returns: The elapsed time in nanoseconds.
+ */
+uint64_t get_build_speed(table_mode mode, int *keys, int *values, int n)
+{
+        (void)mode;
+        // The keys and values are allocated before timing starts
+        void **key_ptrs = malloc(n*sizeof(void *));
+        void **value_ptrs = malloc(n*sizeof(void *));
+        for(int i=0;i<n;i++) {
+                key_ptrs[i] = int_ptr_from_int(keys[i]);
+                value_ptrs[i] = int_ptr_from_int(values[i]);
+        }
+        uint64_t start = bench_start();
+        table *t = table_from_arrays_with_hash(key_ptrs, value_ptrs, n,
+                                               int_compare, hash_int,
+                                               free, free);
+        uint64_t end = bench_stop();
+        bench_kill(t);
+        free(key_ptrs);
+        free(value_ptrs);
+        return end-start;
+}
+
+/* Measures time taken to fill a table with values from malloc and kill
+ * it.
+ *    mode - not used, tables are filled in unordered mode
+ *    keys - a list of keys to use
+ *    values - a list of values to use
+ *    n - the number of pairs
+ * Returns: The elapsed time in nanoseconds.
+ */
+uint64_t get_malloc_insert_speed(table_mode mode, int *keys, int *values,
+                                 int n)
+{
+        (void)mode;
+        uint64_t start = bench_start();
+        table *t = table_empty_with_hash(int_compare, hash_int, free, free);
         insert_values(t,keys,values,n);
-        end =  get_milliseconds();
-        printf("%lu ms.\n",end-start);
+        bench_kill(t);
+        uint64_t end = bench_stop();
+        return end-start;
+}
+
+/* Measures time taken to fill a table with values from the table arena
+ * and kill it.
+ *    mode - not used, tables are filled in unordered mode
+ *    keys - a list of keys to use
+ *    values - a list of values to use
+ *    n - the number of pairs
+ * Returns: The elapsed time in nanoseconds.
+ */
+uint64_t get_arena_insert_speed(table_mode mode, int *keys, int *values,
+                                int n)
+{
+        (void)mode;
+        uint64_t start = bench_start();
+        table *t = table_empty_with_hash(int_compare, hash_int, NULL, NULL);
+        arena *a = table_arena(t);
+        for(int i=0;i<n;i++) {
+                table_insert(t, arena_copy(a, &keys[i], sizeof(int)),
+                             arena_copy(a, &values[i], sizeof(int)));
+        }
+        bench_kill(t);
+        uint64_t end = bench_stop();
+        return end-start;
+}
+
+/* Measures time taken to read all pairs of a table with an iterator
+ *    mode - the storage mode of the table
+ *    keys - a list of keys to use
+ *    values - a list of values to use, a permutation of [0, n-1]
+ *    n - the number of pairs
+ * Returns: The elapsed time in nanoseconds.
+ */
+uint64_t get_iteration_speed(table_mode mode, int *keys, int *values, int n)
+{
+        table *t = create_filled_int_table(mode, keys, values, n);
+        table_iter it;
+        void *key;
+        void *value;
+        long sum = 0;
+
+        uint64_t start = bench_start();
+        table_iter_begin(t, &it);
+        while (table_iter_next(&it, &key, &value)) {
+                sum += *(int *)value;
+        }
+        uint64_t end = bench_stop();
+        bench_kill(t);
+        if (sum != (long)n*(n-1)/2) {
+                printf("Iteration returned the wrong values.\n");
+                exit(EXIT_FAILURE);
+        }
+        return end-start;
 }
 
 /* Measures time taken to do n lookups of existing keys in a table
- *    t - the table to fill
+ *    mode - the storage mode of the table
  *    keys - a list of keys to use
  *    values - a list of values to use
  *    n - the number of lookups to perform
+ * Returns: The elapsed time in nanoseconds.
  */
-void get_random_existing_lookup_speed(table *t, int *keys, int n)
+uint64_t get_random_existing_lookup_speed(table_mode mode, int *keys,
+                                          int *values, int n)
 {
-        unsigned long start;
-        unsigned long end;
-
-        printf("%5d random lookups                 : ",n );
-        start = get_milliseconds();
+        table *t = create_filled_int_table(mode, keys, values, n);
+        uint64_t start = bench_start();
         for(int i=0;i<n;i++) {
                 // The existing keys in the table are stored in index
-                // [0, TABLESIZE-1] in the key-array
+                // [0, n-1] in the key-array
                 int pos = rand()%n;
                 table_lookup(t,&keys[pos]);
         }
-        end = get_milliseconds();
-        printf("%lu ms.\n", end-start);
+        uint64_t end = bench_stop();
+        bench_kill(t);
+        return end-start;
 }
 
-/* Measures time taken to do n lookups of non-existing keys in a table
- *    t - the table to fill
+/* Measures time taken to do n lookups of existing keys in a table
+ * using table_lookup_batch(). The random keys are chosen before the
+ * timing starts.
+ *    mode - the storage mode of the table
  *    keys - a list of keys to use
  *    values - a list of values to use
  *    n - the number of lookups to perform
+ * Returns: The elapsed time in nanoseconds.
  */
-void get_random_non_existing_lookup_speed(table *t, int *keys, int n)
+uint64_t get_random_existing_lookup_batch_speed(table_mode mode, int *keys,
+                                                int *values, int n)
 {
-        unsigned long start;
-        unsigned long end;
+        table *t = create_filled_int_table(mode, keys, values, n);
+        void **key_ptrs = malloc(n*sizeof(void *));
+        void **found = malloc(n*sizeof(void *));
 
-        printf("%5d lookups with non-existent keys : ", n);
-        // We know the exisiting keys have indexes in [0, TABLESIZE-1]
-        // so if we try to lookup keys in the area [TABLESIZE,
-        // 2*TABLESIZE-1] they will not exist
-        start =  get_milliseconds();
-        int startindex = n;
-        for(int i=0;i<n;i++){
-                table_lookup(t,&keys[startindex + (i%n)]);
+        for(int i=0;i<n;i++) {
+                key_ptrs[i] = &keys[rand()%n];
         }
-        end = get_milliseconds();
-        printf("%lu ms.\n" ,end-start);
+        uint64_t start = bench_start();
+        table_lookup_batch(t, key_ptrs, n, found);
+        uint64_t end = bench_stop();
+        bench_kill(t);
+        free(key_ptrs);
+        free(found);
+        return end-start;
 }
 
-/* Measures time taken to do n lookups of existing keys in a table when the
- * keys chosen are from only a part of all available keys
- *    t - the table to fill
- *    keys - a list of keys to use
+/* Measures time taken to do n lookups of non-existing keys in a table
+ *    mode - the storage mode of the table
+ *    keys - a list of 2n keys to use
  *    values - a list of values to use
  *    n - the number of lookups to perform
+ * Returns: The elapsed time in nanoseconds.
  */
-void get_skewed_lookup_speed(table *t, int *keys, int n)
+uint64_t get_random_non_existing_lookup_speed(table_mode mode, int *keys,
+                                              int *values, int n)
 {
-        unsigned long start;
-        unsigned long end;
+        table *t = create_filled_int_table(mode, keys, values, n);
+        // We know the exisiting keys have indexes in [0, n-1] so if we
+        // try to lookup keys in the area [n, 2n-1] they will not exist
+        uint64_t start = bench_start();
+        int startindex = n;
+        for(int i=0;i<n;i++){
+                table_lookup(t,&keys[startindex + (i%n)]);
+        }
+        uint64_t end = bench_stop();
+        bench_kill(t);
+        return end-start;
+}
 
-        // Lookup skewed to a certain range (in this case the middle third
-        // of the keys used)
+/* Do n lookups of existing keys when the keys chosen are from only a
+ * part of all available keys, the middle third.
+ */
+void skewed_lookups(table *t, int *keys, int n)
+{
         int startindex = n/3;
         int stopindex = n*2/3;
         int partition = stopindex - startindex + 1;
 
-        printf("%5d skewed lookups                 : " ,n);
-        start =  get_milliseconds();
         for(int i=0;i<n;i++) {
                 int pos = rand()%partition + startindex;
                 table_lookup(t,&keys[pos]);
         }
-        end = get_milliseconds();
-        printf("%lu ms.\n" ,end-start);
 }
 
-/* Measures time taken remove all keys from a table
- *    t - the table to fill
+/* Measures time taken to do n lookups of existing keys in a table when the
+ * keys chosen are from only a part of all available keys
+ *    mode - the storage mode of the table
+ *    keys - a list of keys to use
+ *    values - a list of values to use
+ *    n - the number of lookups to perform
+ * Returns: The elapsed time in nanoseconds.
+ */
+uint64_t get_skewed_lookup_speed(table_mode mode, int *keys, int *values,
+                                 int n)
+{
+        table *t = create_filled_int_table(mode, keys, values, n);
+        uint64_t start = bench_start();
+        skewed_lookups(t, keys, n);
+        uint64_t end = bench_stop();
+        bench_kill(t);
+        return end-start;
+}
+
+/* Measures time taken to do n skewed lookups (as in
+ * get_skewed_lookup_speed) in a table that is filled first and then
+ * switched to the given mode, so that a self-organizing mode starts
+ * from the insertion order.
+ *    mode - the storage mode to switch to, must be supported
  *    keys - a list of keys to use
  *    values - a list of values to use
+ *    n - the number of lookups to perform
+ * Returns: The elapsed time in nanoseconds.
  */
-void get_remove_speed(table *t, int *keys, int n)
+uint64_t get_skewed_lookup_speed_after_fill(table_mode mode, int *keys,
+                                            int *values, int n)
 {
-        unsigned long start;
-        unsigned long end;
+        table *t = create_filled_int_table(TABLE_MODE_UNORDERED, keys,
+                                           values, n);
+        table_set_mode(t, mode);
+        uint64_t start = bench_start();
+        skewed_lookups(t, keys, n);
+        uint64_t end = bench_stop();
+        bench_kill(t);
+        return end-start;
+}
 
+/* Measures time taken remove all keys from a table
+ *    mode - the storage mode of the table
+ *    keys - a list of keys to use
+ *    values - a list of values to use
+ *    n - the number of pairs
+ * Returns: The elapsed time in nanoseconds.
+ */
+uint64_t get_remove_speed(table_mode mode, int *keys, int *values, int n)
+{
+        table *t = create_filled_int_table(mode, keys, values, n);
         // Remove all items, not in the same order as they were inserted
-        printf("Remove all items                     : ");
-        start = get_milliseconds();
-        random_shuffle(keys, n);  // to get a new order of the keys
+        random_shuffle(keys, n);
+        uint64_t start = bench_start();
         for(int i=0;i<n;i++) {
                 table_remove(t,&keys[i]);
         }
-        end = get_milliseconds();
-        printf("%lu ms.\n" ,end-start);
+        uint64_t end = bench_stop();
+        bench_kill(t);
+        return end-start;
 }
 
+// True while tests 2-8 run on tables with a key hash function.
+static bool basic_tests_hashed = false;
+
+/* Create an empty table with string keys and values for tests 2-8.
+ * Returns: A table made by table_empty(), or by table_empty_with_hash()
+ * with hash_string() while basic_tests_hashed is set.
+ */
+table *empty_string_table(void)
+{
+        if (basic_tests_hashed) {
+                return table_empty_with_hash(string_compare, hash_string,
+                                             free, free);
+        }
+        return table_empty(string_compare, free, free);
+}
 
 /* Tests if isempty returns true directly after a table is created.
  */
@@ -337,7 +1204,7 @@ void test_isempty(){
  */
 void test_insert_single_element(void)
 {
-        table *t = table_empty(string_compare, free, free);
+        table *t = empty_string_table();
         char *key = copy_string("key1");
         char *value = copy_string("value1");
 
@@ -396,7 +1263,7 @@ void test_lookup_missing_key(table *t, char *key)
  */
 void test_lookup_single_element()
 {
-        table *t = table_empty(string_compare, free, free);
+        table *t = empty_string_table();
 
         char *key1 = copy_string("key1");
         char *value1 = copy_string("value1");
@@ -431,7 +1298,7 @@ void test_lookup_single_element()
  */
 void test_insert_lookup_different_keys()
 {
-        table *t = table_empty(string_compare, free, free);
+        table *t = empty_string_table();
 
         char *key1 = copy_string("key1");
         char *key2 = copy_string("key2");
@@ -467,7 +1334,7 @@ void test_insert_lookup_different_keys()
  */
 void test_insert_lookup_same_keys()
 {
-        table *t = table_empty(string_compare, free, free);
+        table *t = empty_string_table();
 
         /* Separate key to use on lookup, since it is not defined
          * which duplicate key will be removed.
@@ -505,7 +1372,7 @@ void test_insert_lookup_same_keys()
  */
 void test_remove_single_element()
 {
-        table *t = table_empty(string_compare, free, free);
+        table *t = empty_string_table();
 
         char *key1 = copy_string("key1");
         char *value1 = copy_string("value1");
@@ -535,7 +1402,7 @@ void test_remove_single_element()
  */
 void test_remove_elements_different_keys()
 {
-        table *t = table_empty(string_compare, free, free);
+        table *t = empty_string_table();
 
         char *key1 = copy_string("key1");
         char *key2 = copy_string("key2");
@@ -596,7 +1463,7 @@ void test_remove_elements_different_keys()
  */
 void test_remove_elements_same_keys()
 {
-        table *t = table_empty(string_compare, free, free);
+        table *t = empty_string_table();
 
         /* Separate key to use in remove, since it is not defined
          * which duplicate key will be removed.
@@ -646,86 +1513,3120 @@ void test_remove_elements_same_keys()
         table_kill(t);
 }
 
-/*  Tests a table by performing a set of tests. Program exits if any
- *  error is found.
+/* Tests the int-keyed table. Three keys are inserted and looked up,
+ *  one of them is overwritten, and then they are removed one at a time
+ *  until the table is empty.
  */
-void correctnessTest()
+void test_int_table()
 {
-		test_isempty();
-        test_insert_single_element();
-        test_lookup_single_element();
-        test_insert_lookup_different_keys();
-        test_insert_lookup_same_keys();
-        test_remove_single_element();
-        test_remove_elements_different_keys();
-        test_remove_elements_same_keys();
+        table_int *t = table_int_empty(free);
+
+        if (!table_int_is_empty(t)) {
+                printf("A newly created int table is said to be nonempty.\n");
+                exit(EXIT_FAILURE);
+        }
+        for (int i=1; i<=3; i++) {
+                table_int_insert(t, i*100, int_ptr_from_int(i));
+        }
+        table_int_insert(t, 200, int_ptr_from_int(20));
+        for (int i=1; i<=3; i++) {
+                int *v = table_int_lookup(t, i*100);
+                int expected = i==2 ? 20 : i;
+                if (v == NULL || *v != expected) {
+                        printf("Int table returned the wrong value for key "
+                               "%d.\n", i*100);
+                        exit(EXIT_FAILURE);
+                }
+        }
+        if (table_int_lookup(t, 400) != NULL) {
+                printf("Int table claims a missing key exists.\n");
+                exit(EXIT_FAILURE);
+        }
+        for (int i=1; i<=3; i++) {
+                table_int_remove(t, i*100);
+                if (table_int_lookup(t, i*100) != NULL) {
+                        printf("Int table key %d still exists after "
+                               "removal.\n", i*100);
+                        exit(EXIT_FAILURE);
+                }
+        }
+        if (!table_int_is_empty(t)) {
+                printf("Removing all keys from an int table does not "
+                       "result in an empty table.\n");
+                exit(EXIT_FAILURE);
+        }
+        printf("Inserting, overwriting and removing keys in an int table "
+               "- OK\n");
+        table_int_kill(t);
 }
 
-/* Tests the speed of a table using random numbers. First a number of
- * elements are inserted. Second a random lookup among the elements are
- * done followed by a skewed lookup (where a subset of the keys are
- * looked up more frequently). Finally all elements are removed.
+/* Tests the string-keyed table. Keys of every storage class are
+ *  inserted: empty, shorter than a word, exactly a word, the longest
+ *  inline key, and long keys, some of them equal in their first bytes
+ *  and length. One key is overwritten, all keys and near misses are
+ *  looked up, and then the keys are removed one at a time until the
+ *  table is empty.
  */
-void speedTest(int n)
+void test_str_table()
 {
-        int randomsize = 2*n; // To make it easier testing
-                              // non-existing keys later
-        int *keys = malloc(randomsize*sizeof(int));
-        int *values = malloc(randomsize*sizeof(int));
-        create_random_sample(keys, randomsize);
-        create_random_sample(values, n);
-
-        table *t = table_empty(int_compare, free, free);
-        get_insert_speed(t, keys, values, n);
-        table_kill(t);
-
-        t = table_empty(int_compare, free, free);
-        insert_values(t,keys,values,n);
-        get_remove_speed(t, keys, n);
-        table_kill(t);
+        const char *keys[] = {
+                "", "a", "abcdefgh", "abcdefghijklmnop",
+                "abcdefghijklmnoq", "abcdefghijklmnopq",
+                "abcdefghijklmnopr", "abcdefghijklmnopqrstuvwxyz0123",
+        };
+        const char *missing[] = {
+                "b", "abcdefg", "abcdefgi", "abcdefghijklmno",
+                "abcdefghijklmnor", "abcdefghijklmnops",
+                "abcdefghijklmnopqrstuvwxyz0124",
+        };
+        int n = sizeof(keys)/sizeof(keys[0]);
+        int n_missing = sizeof(missing)/sizeof(missing[0]);
+        table_str *t = table_str_empty(free);
 
-        t = table_empty(int_compare, free, free);
-        insert_values(t,keys,values,n);
-        get_random_non_existing_lookup_speed(t, keys, n);
+        if (!table_str_is_empty(t)) {
+                printf("A newly created string table is said to be "
+                       "nonempty.\n");
+                exit(EXIT_FAILURE);
+        }
+        for (int i=0; i<n; i++) {
+                table_str_insert(t, keys[i], int_ptr_from_int(i));
+        }
+        // The table must keep its own copy of the key.
+        char *copy = copy_string(keys[5]);
+        table_str_insert(t, copy, int_ptr_from_int(50));
+        copy[0] = 'x';
+        free(copy);
+        for (int i=0; i<n; i++) {
+                int *v = table_str_lookup(t, keys[i]);
+                int expected = i==5 ? 50 : i;
+                if (v == NULL || *v != expected) {
+                        printf("String table returned the wrong value for "
+                               "key \"%s\".\n", keys[i]);
+                        exit(EXIT_FAILURE);
+                }
+        }
+        for (int i=0; i<n_missing; i++) {
+                if (table_str_lookup(t, missing[i]) != NULL) {
+                        printf("String table claims the missing key \"%s\" "
+                               "exists.\n", missing[i]);
+                        exit(EXIT_FAILURE);
+                }
+        }
+        for (int i=0; i<n; i++) {
+                table_str_remove(t, keys[i]);
+                if (table_str_lookup(t, keys[i]) != NULL) {
+                        printf("String table key \"%s\" still exists after "
+                               "removal.\n", keys[i]);
+                        exit(EXIT_FAILURE);
+                }
+                for (int j=i+1; j<n; j++) {
+                        if (table_str_lookup(t, keys[j]) == NULL) {
+                                printf("Removing a key from a string table "
+                                       "lost key \"%s\".\n", keys[j]);
+                                exit(EXIT_FAILURE);
+                        }
+                }
+        }
+        if (!table_str_is_empty(t)) {
+                printf("Removing all keys from a string table does not "
+                       "result in an empty table.\n");
+                exit(EXIT_FAILURE);
+        }
+        printf("Inserting, overwriting and removing inline and long keys "
+               "in a string table - OK\n");
+        table_str_kill(t);
+}
+
+/*  Checks that hashes spread evenly over HASH_TEST_BUCKETS buckets, by
+ *  their top bits and by their low bits. Exits on failure.
+ *    hashes - the hashes of distinct keys
+ *    n - the number of hashes, a multiple of HASH_TEST_BUCKETS
+ *    name - the name of the hash function, for the failure message
+ */
+void check_hash_spread(const uint64_t *hashes, int n, const char *name)
+{
+        int top[HASH_TEST_BUCKETS] = { 0 };
+        int low[HASH_TEST_BUCKETS] = { 0 };
+        for (int i = 0; i < n; i++) {
+                top[hashes[i] >> 56]++;
+                low[hashes[i] % HASH_TEST_BUCKETS]++;
+        }
+        int mean = n / HASH_TEST_BUCKETS;
+        for (int b = 0; b < HASH_TEST_BUCKETS; b++) {
+                if (abs(top[b] - mean) > mean*3/10 ||
+                    abs(low[b] - mean) > mean*3/10) {
+                        printf("%s spreads keys unevenly: bucket %d has "
+                               "%d and %d keys, expected about %d.\n",
+                               name, b, top[b], low[b], mean);
+                        exit(EXIT_FAILURE);
+                }
+        }
+}
+
+/*  Tests the built-in hash functions in hash.h. Equal keys at different
+ *  addresses must hash equally, the batch variants must match the
+ *  single ones, all prefixes of a block must hash differently, and the
+ *  hashes of consecutive ints and of similar strings must spread
+ *  evenly.
+ */
+void test_hash()
+{
+        int n = HASH_TEST_KEYS;
+        int *ints = malloc(n*sizeof(int));
+        char **strings = malloc(n*sizeof(char *));
+        void **keys = malloc(n*sizeof(void *));
+        uint64_t *hashes = malloc(n*sizeof(uint64_t));
+        for (int i = 0; i < n; i++) {
+                char s[32];
+                sprintf(s, "key%d", i);
+                ints[i] = i;
+                strings[i] = copy_string(s);
+        }
+
+        for (int i = 0; i < n; i++) {
+                keys[i] = &ints[i];
+        }
+        hash_int_batch(keys, n, hashes);
+        for (int i = 0; i < n; i++) {
+                int copy = ints[i];
+                if (hashes[i] != hash_int(&ints[i]) ||
+                    hash_int(&copy) != hash_int(&ints[i])) {
+                        printf("hash_int() is not consistent for %d.\n", i);
+                        exit(EXIT_FAILURE);
+                }
+        }
+        check_hash_spread(hashes, n, "hash_int()");
+
+        hash_ptr_batch(keys, n, hashes);
+        for (int i = 0; i < n; i++) {
+                if (hashes[i] != hash_ptr(keys[i])) {
+                        printf("hash_ptr_batch() does not match "
+                               "hash_ptr().\n");
+                        exit(EXIT_FAILURE);
+                }
+        }
+        check_hash_spread(hashes, n, "hash_ptr()");
+
+        hash_string_batch((void **)strings, n, hashes);
+        for (int i = 0; i < n; i++) {
+                char *copy = copy_string(strings[i]);
+                if (hashes[i] != hash_string(strings[i]) ||
+                    hash_string(copy) != hashes[i] ||
+                    hash_bytes(copy, strlen(copy)) != hashes[i]) {
+                        printf("hash_string() is not consistent for "
+                               "\"%s\".\n", strings[i]);
+                        exit(EXIT_FAILURE);
+                }
+                free(copy);
+        }
+        check_hash_spread(hashes, n, "hash_string()");
+
+        // Every prefix length takes its own path through hash_bytes().
+        unsigned char block[HASH_TEST_BLOCK];
+        uint64_t prefixes[HASH_TEST_BLOCK + 1];
+        memset(block, 'a', sizeof(block));
+        for (int len = 0; len <= HASH_TEST_BLOCK; len++) {
+                prefixes[len] = hash_bytes(block, len);
+                for (int shorter = 0; shorter < len; shorter++) {
+                        if (prefixes[shorter] == prefixes[len]) {
+                                printf("hash_bytes() collides for %d and "
+                                       "%d bytes.\n", shorter, len);
+                                exit(EXIT_FAILURE);
+                        }
+                }
+                for (int i = 0; i < len; i++) {
+                        block[i] ^= 1;
+                        if (hash_bytes(block, len) == prefixes[len]) {
+                                printf("hash_bytes() of %d bytes ignores "
+                                       "byte %d.\n", len, i);
+                                exit(EXIT_FAILURE);
+                        }
+                        block[i] ^= 1;
+                }
+        }
+
+        if (hash_batch_for(hash_int) != hash_int_batch ||
+            hash_batch_for(hash_ptr) != hash_ptr_batch ||
+            hash_batch_for(hash_string) != hash_string_batch ||
+            hash_batch_for(fnv1a_hash) != NULL ||
+            hash_batch_for(NULL) != NULL) {
+                printf("hash_batch_for() returns the wrong function.\n");
+                exit(EXIT_FAILURE);
+        }
+        for (int i = 0; i < n; i++) {
+                free(strings[i]);
+        }
+        free(ints);
+        free(strings);
+        free(keys);
+        free(hashes);
+        printf("Built-in hash functions are consistent and well spread "
+               "- OK\n");
+}
+
+/* Tests table_insert_batch() in a given mode. Two keys are inserted
+ *  one by one, then a batch with new keys, an existing key and a key
+ *  that is duplicated within the batch. It is checked that the last
+ *  inserted value wins for each key, then the keys are checked with
+ *  table_lookup_batch() and removed.
+ */
+void test_insert_batch(table_mode mode)
+{
+        table *t = table_empty_with_hash(string_compare, hash_string,
+                                         free, free);
+        if (!table_set_mode(t, mode)) {
+                printf("Batch insert in %s mode not supported - SKIPPED\n",
+                       mode_name(mode));
+                table_kill(t);
+                return;
+        }
+        table_insert(t, copy_string("key2"), copy_string("value2"));
+        table_insert(t, copy_string("key1"), copy_string("value1"));
+
+        void *keys[4] = { copy_string("key4"), copy_string("key3"),
+                          copy_string("key1"), copy_string("key4") };
+        void *values[4] = { copy_string("value4"), copy_string("value3"),
+                            copy_string("value1b"), copy_string("value4b") };
+        table_insert_batch(t, keys, values, 4);
+
+        test_lookup_existing_key(t, "key1", "value1b");
+        test_lookup_existing_key(t, "key2", "value2");
+        test_lookup_existing_key(t, "key3", "value3");
+        test_lookup_existing_key(t, "key4", "value4b");
+        test_lookup_missing_key(t, "key0");
+        test_lookup_missing_key(t, "key5");
+
+        void *lookup_keys[6] = { "key0", "key1", "key2",
+                                 "key3", "key4", "key5" };
+        char *expected[6] = { NULL, "value1b", "value2",
+                              "value3", "value4b", NULL };
+        void *found[6];
+        table_lookup_batch(t, lookup_keys, 6, found);
+        for (int i = 0; i < 6; i++) {
+                if (expected[i] == NULL ? found[i] != NULL :
+                    found[i] == NULL || strcmp(found[i], expected[i]) != 0) {
+                        printf("Batch lookup of key %s in %s mode gave the "
+                               "wrong value.\n", (char *)lookup_keys[i],
+                               mode_name(mode));
+                        exit(EXIT_FAILURE);
+                }
+        }
+
+        table_remove(t, "key2");
+        table_remove(t, "key1");
+        test_lookup_missing_key(t, "key1");
+        test_lookup_missing_key(t, "key2");
+        test_lookup_existing_key(t, "key3", "value3");
+        test_lookup_existing_key(t, "key4", "value4b");
+        table_remove(t, "key4");
+        table_remove(t, "key3");
+        if (!table_is_empty(t)) {
+                printf("Removing all batch inserted keys does not result "
+                       "in an empty table.\n");
+                exit(EXIT_FAILURE);
+        }
+        printf("Batch insert with duplicate keys in %s mode - OK\n",
+               mode_name(mode));
+        table_kill(t);
+}
+
+/*  Tests table_from_arrays() by building a table from arrays with
+ *  duplicate keys. It is checked that the last pair wins for each key,
+ *  that the table works as usual afterwards, and that it can be
+ *  emptied.
+ */
+void test_from_arrays()
+{
+        void *keys[5] = { copy_string("key2"), copy_string("key1"),
+                          copy_string("key2"), copy_string("key3"),
+                          copy_string("key2") };
+        void *values[5] = { copy_string("value2"), copy_string("value1"),
+                            copy_string("value2b"), copy_string("value3"),
+                            copy_string("value2c") };
+        table *t = table_from_arrays(keys, values, 5, string_compare,
+                                     free, free);
+
+        test_lookup_existing_key(t, "key1", "value1");
+        test_lookup_existing_key(t, "key2", "value2c");
+        test_lookup_existing_key(t, "key3", "value3");
+        test_lookup_missing_key(t, "key0");
+        table_insert(t, copy_string("key4"), copy_string("value4"));
+        test_lookup_existing_key(t, "key4", "value4");
+
+        table_remove(t, "key2");
+        test_lookup_missing_key(t, "key2");
+        table_remove(t, "key1");
+        table_remove(t, "key3");
+        table_remove(t, "key4");
+        if (!table_is_empty(t)) {
+                printf("Removing all keys of a table built from arrays "
+                       "does not result in an empty table.\n");
+                exit(EXIT_FAILURE);
+        }
+        table_kill(t);
+
+        t = table_from_arrays(NULL, NULL, 0, string_compare, free, free);
+        if (!table_is_empty(t)) {
+                printf("A table built from empty arrays is not empty.\n");
+                exit(EXIT_FAILURE);
+        }
+        table_kill(t);
+        printf("Building a table from arrays with duplicate keys - OK\n");
+}
+
+/*  Tests a table whose keys and values are copied into the table
+ *  arena. The table has no free functions, so overwritten and removed
+ *  pairs stay in the arena until the table is killed.
+ */
+void test_arena_table()
+{
+        table *t = table_empty_with_hash(string_compare, hash_string,
+                                         NULL, NULL);
+        arena *a = table_arena(t);
+        if (a == NULL || table_arena(t) != a) {
+                printf("table_arena() does not return the same arena "
+                       "on each call.\n");
+                exit(EXIT_FAILURE);
+        }
+        char *names[3] = { "key1", "key2", "key3" };
+        char *values[3] = { "value1", "value2", "value3" };
+        for (int i = 0; i < 3; i++) {
+                table_insert(t, arena_copy(a, names[i], strlen(names[i])+1),
+                             arena_copy(a, values[i], strlen(values[i])+1));
+        }
+        table_insert(t, arena_copy(a, "key2", 5), arena_copy(a, "value2b", 8));
+        test_lookup_existing_key(t, "key1", "value1");
+        test_lookup_existing_key(t, "key2", "value2b");
+        test_lookup_existing_key(t, "key3", "value3");
+        table_remove(t, "key1");
+        test_lookup_missing_key(t, "key1");
+        test_lookup_existing_key(t, "key3", "value3");
+
+        // Large enough to get an arena block of its own.
+        char *big = arena_alloc(a, 100000);
+        memset(big, 'x', 99999);
+        big[99999] = '\0';
+        table_insert(t, arena_copy(a, "big", 4), big);
+        test_lookup_existing_key(t, "key3", "value3");
+        if (table_lookup(t, "big") != big) {
+                printf("Lookup of a large arena value failed.\n");
+                exit(EXIT_FAILURE);
+        }
+        table_kill(t);
+        printf("Inserting, overwriting and removing arena allocated "
+               "pairs - OK\n");
+}
+
+// Number of calls to count_pair() and the sum of the visited values.
+static int pairs_seen;
+static int pairs_sum;
+
+/* Count a key/value pair with an int value for test_iteration().
+ */
+void count_pair(const void *key, const void *value)
+{
+        (void)key;
+        pairs_seen++;
+        pairs_sum += *(const int *)value;
+}
+
+/*  Tests table_foreach() and the table iterators on a table with five
+ *  keys, one of them overwritten and one removed. Each remaining pair
+ *  must be visited exactly once with its current value.
+ */
+void test_iteration()
+{
+        table *t = table_empty_with_hash(string_compare, hash_string,
+                                         free, free);
+        table_iter it;
+        void *key;
+        void *value;
+
+        table_iter_begin(t, &it);
+        if (table_iter_next(&it, &key, &value)) {
+                printf("Iterating over an empty table returned a pair.\n");
+                exit(EXIT_FAILURE);
+        }
+        char name[16];
+        for (int i = 0; i < 5; i++) {
+                sprintf(name, "key%d", i);
+                table_insert(t, copy_string(name), int_ptr_from_int(i));
+        }
+        table_insert(t, copy_string("key2"), int_ptr_from_int(20));
+        table_remove(t, "key4");
+
+        // Expected: key0-key3 with the values 0, 1, 20 and 3.
+        int seen[4] = { 0 };
+        int sum = 0;
+        table_iter_begin(t, &it);
+        while (table_iter_next(&it, &key, &value)) {
+                int i = ((char *)key)[3] - '0';
+                if (i < 0 || i > 3 || seen[i]++ > 0 ||
+                    table_lookup(t, key) != value) {
+                        printf("Iteration returned an unexpected pair "
+                               "for key %s.\n", (char *)key);
+                        exit(EXIT_FAILURE);
+                }
+                sum += *(int *)value;
+        }
+        for (int i = 0; i < 4; i++) {
+                if (seen[i] != 1 || sum != 24) {
+                        printf("Iteration did not visit each pair "
+                               "once.\n");
+                        exit(EXIT_FAILURE);
+                }
+        }
+
+        pairs_seen = 0;
+        pairs_sum = 0;
+        table_foreach(t, count_pair);
+        if (pairs_seen != 4 || pairs_sum != 24) {
+                printf("table_foreach() did not visit each pair once.\n");
+                exit(EXIT_FAILURE);
+        }
+        table_kill(t);
+        printf("Iterating over all pairs with foreach and iterator - OK\n");
+}
+
+// Arguments of a thread in test_shardtable().
+typedef struct shard_test_arg {
+        shardtable *t;
+        int first; // First key inserted by the thread.
+        int n; // Number of keys inserted by the thread.
+} shard_test_arg;
+
+/* Insert the keys [first, first+n-1] with the key as value.
+ */
+void *shard_test_thread(void *p)
+{
+        shard_test_arg *arg = p;
+        for (int i = arg->first; i < arg->first + arg->n; i++) {
+                shardtable_insert(arg->t, int_ptr_from_int(i),
+                                  int_ptr_from_int(i));
+        }
+        return NULL;
+}
+
+/*  Tests the sharded table. Pairs are inserted, overwritten, looked up
+ *  and removed from one thread. Then four threads insert 1000 keys each
+ *  at the same time, and it is checked that all keys are found.
+ */
+void test_shardtable()
+{
+        shardtable *t = shardtable_empty(4, string_compare, hash_string,
+                                         free, free);
+        shardtable_insert(t, copy_string("key1"), copy_string("value1"));
+        shardtable_insert(t, copy_string("key2"), copy_string("value2"));
+        shardtable_insert(t, copy_string("key1"), copy_string("value1b"));
+        char *v1 = shardtable_lookup(t, "key1");
+        char *v2 = shardtable_lookup(t, "key2");
+        if (v1 == NULL || strcmp(v1, "value1b") != 0 ||
+            v2 == NULL || strcmp(v2, "value2") != 0 ||
+            shardtable_lookup(t, "key3") != NULL) {
+                printf("Lookup in a sharded table gave the wrong value.\n");
+                exit(EXIT_FAILURE);
+        }
+        shardtable_remove(t, "key1");
+        shardtable_remove(t, "key2");
+        if (!shardtable_is_empty(t)) {
+                printf("Removing all keys does not result in an empty "
+                       "sharded table.\n");
+                exit(EXIT_FAILURE);
+        }
+        shardtable_kill(t);
+
+        t = shardtable_empty(8, int_compare, hash_int, free, free);
+        pthread_t threads[4];
+        shard_test_arg args[4];
+        for (int i = 0; i < 4; i++) {
+                args[i].t = t;
+                args[i].first = i*1000;
+                args[i].n = 1000;
+                pthread_create(&threads[i], NULL, shard_test_thread,
+                               &args[i]);
+        }
+        for (int i = 0; i < 4; i++) {
+                pthread_join(threads[i], NULL);
+        }
+        for (int i = 0; i < 4000; i++) {
+                int *v = shardtable_lookup(t, &i);
+                if (v == NULL || *v != i) {
+                        printf("Key %d inserted by a thread is missing "
+                               "from the sharded table.\n", i);
+                        exit(EXIT_FAILURE);
+                }
+        }
+        shardtable_kill(t);
+        printf("Inserting from one and from several threads in a sharded "
+               "table - OK\n");
+}
+
+// Number of keys and operations per thread in test_lftable().
+#define LF_TEST_KEYS 256
+#define LF_TEST_OPS 20000
+
+// Arguments of a thread in test_lftable().
+typedef struct lf_test_arg {
+        lftable *t;
+        int *keys;
+        unsigned seed;
+        int errors;
+} lf_test_arg;
+
+/* Insert, remove and look up random keys. Each value is a copy of its
+ * key, which is checked inside a critical section whenever a lookup
+ * finds the key.
+ */
+void *lf_test_thread(void *p)
+{
+        lf_test_arg *arg = p;
+        epoch_thread *th = lftable_attach(arg->t);
+        for (int i = 0; i < LF_TEST_OPS; i++) {
+                int r = rand_r(&arg->seed);
+                int *key = &arg->keys[r % LF_TEST_KEYS];
+                switch ((r / LF_TEST_KEYS) % 4) {
+                case 0:
+                        lftable_insert(arg->t, th, key,
+                                       int_ptr_from_int(*key));
+                        break;
+                case 1:
+                        lftable_remove(arg->t, th, key);
+                        break;
+                default:
+                        epoch_enter(th);
+                        int *v = lftable_lookup(arg->t, th, key);
+                        if (v != NULL && *v != *key) {
+                                arg->errors++;
+                        }
+                        epoch_exit(th);
+                }
+        }
+        lftable_detach(th);
+        return NULL;
+}
+
+/*  Tests the lock-free table. Pairs are inserted, overwritten, looked
+ *  up and removed from one thread. New keys are inserted and removed
+ *  until the table is full, which must not happen before max_keys
+ *  distinct keys. Then four threads work on the same keys at the same
+ *  time. With a memory checker, a value that is freed
+ *  while a reader can still see it is reported as an error.
+ */
+void test_lftable()
+{
+        lftable *t = lftable_empty(4, string_compare, hash_string,
+                                   free, free);
+        epoch_thread *th = lftable_attach(t);
+        lftable_insert(t, th, copy_string("key1"), copy_string("value1"));
+        lftable_insert(t, th, copy_string("key2"), copy_string("value2"));
+        lftable_insert(t, th, copy_string("key1"), copy_string("value1b"));
+        char *v1 = lftable_lookup(t, th, "key1");
+        char *v2 = lftable_lookup(t, th, "key2");
+        if (v1 == NULL || strcmp(v1, "value1b") != 0 ||
+            v2 == NULL || strcmp(v2, "value2") != 0 ||
+            lftable_lookup(t, th, "key3") != NULL) {
+                printf("Lookup in a lock-free table gave the wrong "
+                       "value.\n");
+                exit(EXIT_FAILURE);
+        }
+        lftable_remove(t, th, "key1");
+        lftable_remove(t, th, "key2");
+        if (!lftable_is_empty(t) || lftable_lookup(t, th, "key1") != NULL) {
+                printf("Removing all keys does not result in an empty "
+                       "lock-free table.\n");
+                exit(EXIT_FAILURE);
+        }
+        // Removed keys keep their slots, so every new key uses one up.
+        int inserted = 2;
+        char name[16];
+        for (;;) {
+                sprintf(name, "new%d", inserted);
+                char *key = copy_string(name);
+                char *value = copy_string(name);
+                if (!lftable_insert(t, th, key, value)) {
+                        free(key);
+                        free(value);
+                        break;
+                }
+                lftable_remove(t, th, name);
+                inserted++;
+        }
+        if (inserted < 4 ||
+            !lftable_insert(t, th, copy_string("key1"),
+                            copy_string("value1c"))) {
+                printf("A lock-free table for 4 keys was full after %d "
+                       "distinct keys.\n", inserted);
+                exit(EXIT_FAILURE);
+        }
+        lftable_detach(th);
+        lftable_kill(t);
+
+        int keys[LF_TEST_KEYS];
+        for (int i = 0; i < LF_TEST_KEYS; i++) {
+                keys[i] = i;
+        }
+        t = lftable_empty(LF_TEST_KEYS, int_compare, hash_int, NULL, free);
+        pthread_t threads[4];
+        lf_test_arg args[4];
+        for (int i = 0; i < 4; i++) {
+                args[i].t = t;
+                args[i].keys = keys;
+                args[i].seed = i+1;
+                args[i].errors = 0;
+                pthread_create(&threads[i], NULL, lf_test_thread, &args[i]);
+        }
+        for (int i = 0; i < 4; i++) {
+                pthread_join(threads[i], NULL);
+                if (args[i].errors > 0) {
+                        printf("A lookup in the lock-free table returned "
+                               "a wrong value.\n");
+                        exit(EXIT_FAILURE);
+                }
+        }
+        lftable_kill(t);
+        printf("Inserting, removing and looking up from several threads "
+               "in a lock-free table - OK\n");
+}
+
+// Arguments of a thread in test_rcutable().
+typedef struct rcu_test_arg {
+        rcutable *t;
+        int *keys;
+        unsigned seed;
+        atomic_bool *stop; // Set when the writer is done.
+        int errors;
+} rcu_test_arg;
+
+/* Replace and remove random keys, with each value a copy of its key.
+ */
+void *rcu_test_writer(void *p)
+{
+        rcu_test_arg *arg = p;
+        epoch_thread *th = rcutable_attach(arg->t);
+        for (int i = 0; i < LF_TEST_OPS; i++) {
+                int r = rand_r(&arg->seed);
+                int k = r % LF_TEST_KEYS;
+                if ((r / LF_TEST_KEYS) % 2 == 0) {
+                        rcutable_insert(arg->t, th, int_ptr_from_int(k),
+                                        int_ptr_from_int(k));
+                } else {
+                        rcutable_remove(arg->t, th, &arg->keys[k]);
+                }
+        }
+        rcutable_detach(th);
+        atomic_store(arg->stop, true);
+        return NULL;
+}
+
+/* Look up random keys until the writer is done, checking each value
+ * that is found inside a critical section.
+ */
+void *rcu_test_reader(void *p)
+{
+        rcu_test_arg *arg = p;
+        epoch_thread *th = rcutable_attach(arg->t);
+        while (!atomic_load(arg->stop)) {
+                int *key = &arg->keys[rand_r(&arg->seed) % LF_TEST_KEYS];
+                epoch_enter(th);
+                int *v = rcutable_lookup(arg->t, th, key);
+                if (v != NULL && *v != *key) {
+                        arg->errors++;
+                }
+                epoch_exit(th);
+        }
+        rcutable_detach(th);
+        return NULL;
+}
+
+/*  Tests the read-copy-update table. Pairs are inserted, overwritten,
+ *  looked up and removed from one thread, and enough keys are inserted
+ *  to grow the index. Then one writer changes the keys while three
+ *  readers look them up. With a memory checker, a pair that is freed
+ *  while a reader can still see it is reported as an error.
+ */
+void test_rcutable()
+{
+        rcutable *t = rcutable_empty(string_compare, hash_string,
+                                     free, free);
+        epoch_thread *th = rcutable_attach(t);
+        rcutable_insert(t, th, copy_string("key1"), copy_string("value1"));
+        rcutable_insert(t, th, copy_string("key2"), copy_string("value2"));
+        rcutable_insert(t, th, copy_string("key1"), copy_string("value1b"));
+        char *v1 = rcutable_lookup(t, th, "key1");
+        char *v2 = rcutable_lookup(t, th, "key2");
+        if (v1 == NULL || strcmp(v1, "value1b") != 0 ||
+            v2 == NULL || strcmp(v2, "value2") != 0 ||
+            rcutable_lookup(t, th, "key3") != NULL) {
+                printf("Lookup in a read-copy-update table gave the wrong "
+                       "value.\n");
+                exit(EXIT_FAILURE);
+        }
+        rcutable_remove(t, th, "key1");
+        rcutable_remove(t, th, "key2");
+        if (!rcutable_is_empty(t) || rcutable_lookup(t, th, "key1") != NULL) {
+                printf("Removing all keys does not result in an empty "
+                       "read-copy-update table.\n");
+                exit(EXIT_FAILURE);
+        }
+        rcutable_detach(th);
+        rcutable_kill(t);
+
+        int keys[LF_TEST_KEYS];
+        for (int i = 0; i < LF_TEST_KEYS; i++) {
+                keys[i] = i;
+        }
+        t = rcutable_empty(int_compare, hash_int, free, free);
+        th = rcutable_attach(t);
+        for (int i = 0; i < LF_TEST_KEYS; i++) {
+                rcutable_insert(t, th, int_ptr_from_int(i),
+                                int_ptr_from_int(i));
+        }
+        for (int i = 0; i < LF_TEST_KEYS; i++) {
+                int *v = rcutable_lookup(t, th, &keys[i]);
+                if (v == NULL || *v != i) {
+                        printf("Key %d is missing from a read-copy-update "
+                               "table.\n", i);
+                        exit(EXIT_FAILURE);
+                }
+        }
+        rcutable_detach(th);
+
+        atomic_bool stop = false;
+        pthread_t threads[4];
+        rcu_test_arg args[4];
+        for (int i = 0; i < 4; i++) {
+                args[i].t = t;
+                args[i].keys = keys;
+                args[i].seed = i+1;
+                args[i].stop = &stop;
+                args[i].errors = 0;
+                pthread_create(&threads[i], NULL,
+                               i == 0 ? rcu_test_writer : rcu_test_reader,
+                               &args[i]);
+        }
+        for (int i = 0; i < 4; i++) {
+                pthread_join(threads[i], NULL);
+                if (args[i].errors > 0) {
+                        printf("A lookup in the read-copy-update table "
+                               "returned a wrong value.\n");
+                        exit(EXIT_FAILURE);
+                }
+        }
+        rcutable_kill(t);
+        printf("Looking up from several threads while one thread writes "
+               "in a read-copy-update table - OK\n");
+}
+
+/*  Tests the parallel bulk operations against the serial ones. A table
+ *  is built with table_from_arrays_parallel() from arrays with
+ *  duplicate keys, and each key is looked up in it with
+ *  table_lookup_batch_parallel() and in a serially built table. The
+ *  lookups are repeated in sorted mode if the implementation supports
+ *  it. Both tables are killed with free functions, the parallel one
+ *  with table_kill_parallel().
+ */
+void test_parallel()
+{
+        int n = PARALLEL_TEST_PAIRS;
+        int distinct = n - n/4;
+        threadpool *pool = threadpool_empty(PARALLEL_TEST_THREADS);
+        if (pool == NULL || threadpool_size(pool) != PARALLEL_TEST_THREADS) {
+                printf("Failed to create a thread pool.\n");
+                exit(EXIT_FAILURE);
+        }
+        void **keys = malloc(n*sizeof(void *));
+        void **values = malloc(n*sizeof(void *));
+        void **serial_keys = malloc(n*sizeof(void *));
+        void **serial_values = malloc(n*sizeof(void *));
+        void **lookup = malloc(n*sizeof(void *));
+        void **found = malloc(n*sizeof(void *));
+        for (int i = 0; i < n; i++) {
+                int k = (int)((i * 7919LL) % distinct);
+                keys[i] = int_ptr_from_int(k);
+                values[i] = int_ptr_from_int(i);
+                serial_keys[i] = int_ptr_from_int(k);
+                serial_values[i] = int_ptr_from_int(i);
+                lookup[i] = int_ptr_from_int(i);
+        }
+        table *t = table_from_arrays_parallel(keys, values, n, int_compare,
+                                              hash_int, free, free, pool);
+        table *serial = table_from_arrays_with_hash(serial_keys,
+                                                    serial_values, n,
+                                                    int_compare, hash_int,
+                                                    free, free);
+        // The serial table is only used as a reference.
+        table_set_mode(serial, TABLE_MODE_SORTED);
+        for (int round = 0; round < 2; round++) {
+                table_lookup_batch_parallel(t, lookup, n, found, pool);
+                for (int i = 0; i < n; i++) {
+                        void *expected = table_lookup(serial, lookup[i]);
+                        if ((found[i] == NULL) != (expected == NULL) ||
+                            (found[i] != NULL &&
+                             *(int *)found[i] != *(int *)expected)) {
+                                printf("Parallel build and lookup of key "
+                                       "%d differs from serial.\n", i);
+                                exit(EXIT_FAILURE);
+                        }
+                }
+                if (!table_set_mode(t, TABLE_MODE_SORTED)) {
+                        break;
+                }
+        }
+        table_kill_parallel(t, pool);
+        table_kill(serial);
+
+        t = table_from_arrays_parallel(NULL, NULL, 0, int_compare, hash_int,
+                                       free, free, pool);
+        if (!table_is_empty(t)) {
+                printf("A table built in parallel from empty arrays is "
+                       "not empty.\n");
+                exit(EXIT_FAILURE);
+        }
+        table_kill_parallel(t, pool);
+        for (int i = 0; i < n; i++) {
+                free(lookup[i]);
+        }
+        free(keys);
+        free(values);
+        free(serial_keys);
+        free(serial_values);
+        free(lookup);
+        free(found);
+        threadpool_kill(pool);
+        printf("Parallel build, lookup and kill with %d threads - OK\n",
+               PARALLEL_TEST_THREADS);
+}
+
+/*  Runs every workload profile against a table whose values are its
+ *  keys, and checks each operation before it is applied: reads,
+ *  updates and removes must find their key, inserts must not. The
+ *  number of keys must stay at WORKLOAD_TEST_KEYS, plus one while an
+ *  insert waits for its remove. Also checks that two generators with
+ *  the same seed agree, and that the most frequent key of a Zipfian
+ *  profile is far more frequent than the average key, which it must
+ *  not be for a uniform profile.
+ */
+void test_workloads()
+{
+        int n = WORKLOAD_TEST_KEYS;
+        const workload_profile *p;
+        for (int i = 0; (p = workload_profile_get(i)) != NULL; i++) {
+                if (workload_profile_find(p->name) != p) {
+                        printf("workload_profile_find(\"%s\") does not "
+                               "find the profile.\n", p->name);
+                        exit(EXIT_FAILURE);
+                }
+                table *t = table_empty_with_hash(int_compare, hash_int,
+                                                 free, NULL);
+                for (int k = 0; k < n; k++) {
+                        int *key = int_ptr_from_int(k);
+                        table_insert(t, key, key);
+                }
+                workload *w = workload_empty(p, n, 1);
+                workload *same = workload_empty(p, n, 1);
+                int *hits = calloc(n + WORKLOAD_TEST_OPS, sizeof(int));
+                int size = n;
+                for (int j = 0; j < WORKLOAD_TEST_OPS; j++) {
+                        workload_op op = workload_next(w);
+                        workload_op op2 = workload_next(same);
+                        if (op.type != op2.type || op.key != op2.key) {
+                                printf("Workload generators with the same "
+                                       "seed differ.\n");
+                                exit(EXIT_FAILURE);
+                        }
+                        int *found = table_lookup(t, &op.key);
+                        bool should_exist = op.type != WORKLOAD_INSERT;
+                        if ((found != NULL) != should_exist ||
+                            (found != NULL && *found != op.key)) {
+                                printf("Workload %s: operation %d on key %d "
+                                       "does not match the table.\n",
+                                       p->name, op.type, op.key);
+                                exit(EXIT_FAILURE);
+                        }
+                        if (op.type == WORKLOAD_READ) {
+                                hits[op.key]++;
+                        } else if (op.type == WORKLOAD_REMOVE) {
+                                table_remove(t, &op.key);
+                                size--;
+                        } else {
+                                int *key = int_ptr_from_int(op.key);
+                                table_insert(t, key, key);
+                                size += op.type == WORKLOAD_INSERT;
+                        }
+                        if (size < n || size > n + 1) {
+                                printf("Workload %s changes the number of "
+                                       "keys to %d.\n", p->name, size);
+                                exit(EXIT_FAILURE);
+                        }
+                }
+                int reads = 0;
+                int top = 0;
+                for (int k = 0; k < n + WORKLOAD_TEST_OPS; k++) {
+                        reads += hits[k];
+                        top = hits[k] > top ? hits[k] : top;
+                }
+                // The top key of a Zipfian profile gets over 10% of the
+                // reads, about a hundred times the average.
+                if (reads > 0 && (top > 10*reads/n) != p->zipfian) {
+                        printf("Workload %s: the most read key has %d of "
+                               "%d reads.\n", p->name, top, reads);
+                        exit(EXIT_FAILURE);
+                }
+                free(hits);
+                workload_kill(w);
+                workload_kill(same);
+                table_kill(t);
+        }
+        printf("Running every workload profile against a table - OK\n");
+}
+
+/*  Checks that table_memory_usage() agrees with
+ *  table_memory_breakdown() without size functions, and that the
+ *  breakdown has the expected number of pairs. Exits on failure.
+ *    t - the table
+ *    pairs - the expected number of pairs
+ *    mapped - true if t was loaded by table_load_mmap() and not changed
+ *    mem - set to the breakdown with int_size() for keys and values
+ */
+void check_memory_usage(const table *t, size_t pairs, bool mapped,
+                        table_memory *mem)
+{
+        table_memory own;
+        table_memory_breakdown(t, NULL, NULL, &own);
+        table_memory_breakdown(t, int_size, int_size, mem);
+        size_t parts = mem->table + mem->entries + mem->index + mem->slack +
+                mem->arena + mem->mapped + mem->keys + mem->values;
+        if (own.total != table_memory_usage(t) || own.keys != 0 ||
+            own.values != 0 || mem->total != parts ||
+            mem->total != own.total + mem->keys + mem->values) {
+                printf("The memory breakdown does not add up.\n");
+                exit(EXIT_FAILURE);
+        }
+        if (mem->pairs != pairs ||
+            (mapped && mem->mapped < pairs*2*sizeof(int))) {
+                printf("The memory breakdown counts %zu pairs, expected "
+                       "%zu.\n", mem->pairs, pairs);
+                exit(EXIT_FAILURE);
+        }
+#ifndef TABLE_BACKEND_HASH
+        // A mapped arraytable has no entry buffer, and its keys and
+        // values are in the mapping.
+        if (mapped) {
+                if (mem->entries != 0 || mem->index != 0 ||
+                    mem->slack != 0 || mem->keys != 0 || mem->values != 0) {
+                        printf("The memory breakdown counts the pairs of a "
+                               "mapped table outside the mapping.\n");
+                        exit(EXIT_FAILURE);
+                }
+                return;
+        }
+#endif
+        if (mem->keys != pairs*sizeof(int) ||
+            mem->values != pairs*sizeof(int) ||
+            mem->entries < pairs*2*sizeof(void *)) {
+                printf("The memory breakdown counts %zu bytes of keys, "
+                       "expected %zu.\n", mem->keys, pairs*sizeof(int));
+                exit(EXIT_FAILURE);
+        }
+}
+
+/*  Tests the memory accounting by inserting MEMORY_TEST_KEYS keys,
+ *  overwriting them, allocating from the table arena and removing the
+ *  keys, checking the breakdown after each step.
+ */
+void test_memory_usage()
+{
+        int n = MEMORY_TEST_KEYS;
+        table_memory mem;
+        table *t = table_empty_with_hash(int_compare, hash_int, free, free);
+        check_memory_usage(t, 0, false, &mem);
+        for (int i = 0; i < n; i++) {
+                table_insert(t, int_ptr_from_int(i), int_ptr_from_int(i));
+        }
+        check_memory_usage(t, n, false, &mem);
+        for (int i = 0; i < n; i++) {
+                table_insert(t, int_ptr_from_int(i), int_ptr_from_int(-i));
+        }
+        check_memory_usage(t, n, false, &mem);
+        size_t before = mem.arena;
+        arena *a = table_arena(t);
+        if (a != NULL) {
+                arena_alloc(a, 1000);
+                check_memory_usage(t, n, false, &mem);
+                if (mem.arena < before + 1000 ||
+                    mem.arena != arena_memory_usage(a)) {
+                        printf("The memory breakdown does not count the "
+                               "table arena.\n");
+                        exit(EXIT_FAILURE);
+                }
+        }
+        for (int i = 0; i < n; i++) {
+                table_remove(t, &i);
+        }
+        check_memory_usage(t, 0, false, &mem);
         table_kill(t);
+        printf("Memory accounting while inserting, overwriting and "
+               "removing keys - OK\n");
+}
+
+/*  Create an empty file with a unique name, to be replaced by a
+ *  snapshot. Exits on failure.
+ *    path - set to the name of the file, must hold
+ *           SNAPSHOT_PATH_TEMPLATE
+ */
+void make_snapshot_path(char *path)
+{
+        strcpy(path, SNAPSHOT_PATH_TEMPLATE);
+        int fd = mkstemp(path);
+        if (fd < 0) {
+                printf("Failed to create a snapshot file: %s\n",
+                       strerror(errno));
+                exit(EXIT_FAILURE);
+        }
+        close(fd);
+}
+
+/*  Checks that a table holds the keys [0, n-1] with the value -key,
+ *  except for the keys changed by test_snapshot(), and no other keys.
+ *  Exits on failure.
+ *    t - the table
+ *    n - the number of keys
+ *    changed - true if test_snapshot() has changed the table
+ */
+void check_snapshot_pairs(const table *t, int n, bool changed)
+{
+        for (int k = -1; k <= n + 1; k++) {
+                int *v = table_lookup(t, &k);
+                int expected = -k;
+                bool exists = k >= 0 && k < n;
+                if (changed && k == 0) {
+                        expected = 1;
+                } else if (changed && k == 1) {
+                        exists = false;
+                } else if (changed && k == n) {
+                        expected = n;
+                        exists = true;
+                }
+                if ((v != NULL) != exists || (v != NULL && *v != expected)) {
+                        printf("Snapshot table has the wrong value for "
+                               "key %d.\n", k);
+                        exit(EXIT_FAILURE);
+                }
+        }
+        int count = 0;
+        table_iter it;
+        void *key;
+        void *value;
+        table_iter_begin(t, &it);
+        while (table_iter_next(&it, &key, &value)) {
+                if (table_lookup(t, key) != value) {
+                        printf("Snapshot table iterates over a pair it "
+                               "does not find.\n");
+                        exit(EXIT_FAILURE);
+                }
+                count++;
+        }
+        if (count != n) {
+                printf("Snapshot table has %d pairs, expected %d.\n",
+                       count, n);
+                exit(EXIT_FAILURE);
+        }
+}
+
+// Arguments of a thread in test_snapshot() that saves a table.
+typedef struct snapshot_test_arg {
+        const table *t;
+        const char *path;
+        bool ok;
+} snapshot_test_arg;
+
+/* Save a table SNAPSHOT_TEST_SAVES times to a file that another thread
+ * saves to at the same time.
+ */
+void *snapshot_test_thread(void *p)
+{
+        snapshot_test_arg *arg = p;
+        arg->ok = true;
+        for (int i = 0; i < SNAPSHOT_TEST_SAVES; i++) {
+                if (!table_save(arg->t, arg->path, int_size, int_size)) {
+                        arg->ok = false;
+                }
+        }
+        return NULL;
+}
+
+/*  Tests table_save() and table_load_mmap(). A table with the keys
+ *  [0, SNAPSHOT_TEST_KEYS-1], inserted out of order, is saved and
+ *  loaded. The loaded table is then changed, with the new key and
+ *  values allocated from its arena, saved over the file it was loaded
+ *  from, and loaded again. Two threads then save the changed table to
+ *  the same file at the same time, which must still load. A file with a
+ *  flipped byte and a missing file must not load.
+ */
+void test_snapshot()
+{
+        int n = SNAPSHOT_TEST_KEYS;
+        char path[sizeof(SNAPSHOT_PATH_TEMPLATE)];
+        make_snapshot_path(path);
+        table *t = table_empty_with_hash(int_compare, hash_int, free, free);
+        for (int i = 0; i < n; i++) {
+                int k = (int)((i * 7919LL) % n);
+                table_insert(t, int_ptr_from_int(k), int_ptr_from_int(-k));
+        }
+        if (!table_save(t, path, int_size, int_size)) {
+                printf("Failed to save a snapshot: %s\n", strerror(errno));
+                exit(EXIT_FAILURE);
+        }
+        table_kill(t);
+        t = table_load_mmap(path, int_compare, hash_int);
+        if (t == NULL) {
+                printf("Failed to load a snapshot: %s\n", strerror(errno));
+                exit(EXIT_FAILURE);
+        }
+        check_snapshot_pairs(t, n, false);
+        table_memory mem;
+        check_memory_usage(t, n, true, &mem);
+
+        arena *a = table_arena(t);
+        int zero = 0;
+        int one = 1;
+        table_insert(t, arena_copy(a, &n, sizeof(n)),
+                     arena_copy(a, &n, sizeof(n)));
+        table_insert(t, arena_copy(a, &zero, sizeof(zero)),
+                     arena_copy(a, &one, sizeof(one)));
+        table_remove(t, &one);
+        check_snapshot_pairs(t, n, true);
+        if (!table_save(t, path, int_size, int_size)) {
+                printf("Failed to save a changed snapshot: %s\n",
+                       strerror(errno));
+                exit(EXIT_FAILURE);
+        }
+        table *loaded = table_load_mmap(path, int_compare, hash_int);
+        if (loaded == NULL) {
+                printf("Failed to load a changed snapshot: %s\n",
+                       strerror(errno));
+                exit(EXIT_FAILURE);
+        }
+        check_snapshot_pairs(loaded, n, true);
+
+        pthread_t threads[2];
+        snapshot_test_arg args[2] = { { t, path, false },
+                                      { loaded, path, false } };
+        for (int i = 0; i < 2; i++) {
+                pthread_create(&threads[i], NULL, snapshot_test_thread,
+                               &args[i]);
+        }
+        for (int i = 0; i < 2; i++) {
+                pthread_join(threads[i], NULL);
+                if (!args[i].ok) {
+                        printf("Failed to save a snapshot while another "
+                               "thread saved to the same file.\n");
+                        exit(EXIT_FAILURE);
+                }
+        }
+        table_kill(loaded);
+        loaded = table_load_mmap(path, int_compare, hash_int);
+        if (loaded == NULL) {
+                printf("Failed to load a snapshot saved by two threads at "
+                       "once: %s\n", strerror(errno));
+                exit(EXIT_FAILURE);
+        }
+        check_snapshot_pairs(loaded, n, true);
+        table_kill(loaded);
+        table_kill(t);
+
+        FILE *f = fopen(path, "r+b");
+        fseek(f, 0, SEEK_END);
+        fseek(f, ftell(f)/2, SEEK_SET);
+        int c = fgetc(f);
+        fseek(f, -1, SEEK_CUR);
+        fputc(c ^ 0x10, f);
+        fclose(f);
+        if (table_load_mmap(path, int_compare, hash_int) != NULL ||
+            errno != EINVAL) {
+                printf("A corrupt snapshot was loaded.\n");
+                exit(EXIT_FAILURE);
+        }
+        remove(path);
+        if (table_load_mmap(path, int_compare, hash_int) != NULL) {
+                printf("A missing snapshot was loaded.\n");
+                exit(EXIT_FAILURE);
+        }
+        printf("Saving and loading snapshots of a table - OK\n");
+}
+
+/*  Remove the snapshot and the log of a durable table.
+ *    path - the name of the snapshot
+ */
+void remove_wal_files(const char *path)
+{
+        char log_path[sizeof(SNAPSHOT_PATH_TEMPLATE) + sizeof(".wal")];
+        sprintf(log_path, "%s.wal", path);
+        remove(path);
+        remove(log_path);
+}
+
+/*  Return the size of the log of a durable table, or -1 if it does
+ *  not exist.
+ *    path - the name of the snapshot
+ */
+long wal_log_size(const char *path)
+{
+        char log_path[sizeof(SNAPSHOT_PATH_TEMPLATE) + sizeof(".wal")];
+        sprintf(log_path, "%s.wal", path);
+        FILE *f = fopen(log_path, "rb");
+        if (f == NULL) {
+                return -1;
+        }
+        fseek(f, 0, SEEK_END);
+        long size = ftell(f);
+        fclose(f);
+        return size;
+}
+
+/*  Open a durable table with int keys and values. Exits on failure.
+ *    path - the name of the snapshot
+ *    checkpoint_bytes - the log size at which syncs make checkpoints
+ */
+waltable *open_int_waltable(const char *path, size_t checkpoint_bytes)
+{
+        waltable *w = waltable_open(path, int_compare, hash_int, int_size,
+                                    int_size, checkpoint_bytes);
+        if (w == NULL) {
+                printf("Failed to open a durable table: %s\n",
+                       strerror(errno));
+                exit(EXIT_FAILURE);
+        }
+        return w;
+}
+
+/*  Checks that a durable table holds the keys [0, n-1] that are not
+ *  multiples of 3, with the value -key for keys below n/2 and key for
+ *  the others, and none of the keys [n, n+extra-1] where extra > 0.
+ *  Exits on failure.
+ *    w - the table
+ *    n - the number of keys
+ *    extra - the number of keys after n that must be missing
+ */
+void check_wal_pairs(waltable *w, int n, int extra)
+{
+        for (int k = -1; k < n + extra; k++) {
+                int v;
+                ssize_t size = waltable_lookup(w, &k, &v, sizeof(v));
+                bool exists = k >= 0 && k < n && k % 3 != 0;
+                int expected = k < n/2 ? -k : k;
+                if ((size >= 0) != exists || (size >= 0 && v != expected)) {
+                        printf("Durable table has the wrong value for "
+                               "key %d.\n", k);
+                        exit(EXIT_FAILURE);
+                }
+        }
+}
+
+// Arguments of a thread in the test of the durable table.
+typedef struct wal_test_arg {
+        waltable *w;
+        int first; // The thread inserts the keys from first,
+        int step;  // stepping by step, up to WAL_TEST_KEYS.
+        bool ok;
+} wal_test_arg;
+
+/* Insert keys into a durable table, syncing each insert, and look
+ * each key up again, while the syncs of other threads may make
+ * checkpoints.
+ */
+void *wal_test_thread(void *p)
+{
+        wal_test_arg *arg = p;
+        arg->ok = true;
+        for (int k = arg->first; k < WAL_TEST_KEYS; k += arg->step) {
+                uint64_t lsn = waltable_insert(arg->w, &k, &k);
+                int v;
+                if (lsn == 0 || !waltable_sync(arg->w, lsn) ||
+                    waltable_lookup(arg->w, &k, &v, sizeof(v)) !=
+                    sizeof(v) || v != k) {
+                        arg->ok = false;
+                }
+        }
+        return NULL;
+}
+
+/*  Tests the durable table in waltable.h. Keys are inserted,
+ *  overwritten and removed, synced, and the table is closed and
+ *  reopened, before and after a checkpoint. Then a torn record is
+ *  appended to the log, which must be dropped when the table is
+ *  reopened. Then the table is reopened from a checkpoint and the log
+ *  as it was before the checkpoint, as after a crash. Finally several threads insert and sync keys at the same
+ *  time, with checkpoints made by their syncs.
+ */
+void test_waltable()
+{
+        int n = WAL_TEST_KEYS;
+        char path[sizeof(SNAPSHOT_PATH_TEMPLATE)];
+        make_snapshot_path(path);
+        remove(path);
+        waltable *w = open_int_waltable(path, 0);
+        uint64_t lsn = 0;
+        for (int k = 0; k < n; k++) {
+                lsn = waltable_insert(w, &k, &k);
+        }
+        for (int k = 0; k < n/2; k++) {
+                int v = -k;
+                lsn = waltable_insert(w, &k, &v);
+        }
+        for (int k = 0; k < n; k += 3) {
+                lsn = waltable_remove(w, &k);
+        }
+        if (lsn != (uint64_t)(n + n/2 + (n + 2)/3) ||
+            !waltable_sync(w, lsn) || !waltable_close(w)) {
+                printf("Failed to sync a durable table: %s\n",
+                       strerror(errno));
+                exit(EXIT_FAILURE);
+        }
+        w = open_int_waltable(path, 0);
+        check_wal_pairs(w, n, 1);
+
+        if (!waltable_checkpoint(w) || wal_log_size(path) != 0) {
+                printf("Failed to make a checkpoint: %s\n", strerror(errno));
+                exit(EXIT_FAILURE);
+        }
+        check_wal_pairs(w, n, 1);
+        waltable_close(w);
+        w = open_int_waltable(path, 0);
+        check_wal_pairs(w, n, 1);
+
+        // A torn record, as if the process died while writing it.
+        int k = n + 1;
+        waltable_sync(w, waltable_insert(w, &n, &n));
+        waltable_close(w);
+        long size = wal_log_size(path);
+        char log_path[sizeof(SNAPSHOT_PATH_TEMPLATE) + sizeof(".wal")];
+        sprintf(log_path, "%s.wal", path);
+        FILE *f = fopen(log_path, "ab");
+        fwrite("torn record", 1, 11, f);
+        fclose(f);
+        w = open_int_waltable(path, 0);
+        if (wal_log_size(path) != size) {
+                printf("The torn record was not dropped from the log.\n");
+                exit(EXIT_FAILURE);
+        }
+        waltable_insert(w, &k, &k);
+        waltable_close(w);
+        w = open_int_waltable(path, 0);
+        check_wal_pairs(w, n, 0);
+        int v;
+        int u;
+        if (waltable_lookup(w, &n, &v, sizeof(v)) < 0 || v != n ||
+            waltable_lookup(w, &k, &u, sizeof(u)) < 0 || u != k) {
+                printf("Durable table lost the keys around a torn "
+                       "record.\n");
+                exit(EXIT_FAILURE);
+        }
+
+        // Changes that are only buffered when a checkpoint is made must
+        // be logged before the snapshot is saved, so that a crash before
+        // the log is replaced recovers them from the old log.
+        int a = -n;
+        int b = n + 2;
+        waltable_insert(w, &n, &a);
+        waltable_insert(w, &b, &b);
+        char old_path[sizeof(log_path) + sizeof(".old")];
+        sprintf(old_path, "%s.old", log_path);
+        remove(old_path);
+        if (link(log_path, old_path) != 0) {
+                printf("Failed to link the log: %s\n", strerror(errno));
+                exit(EXIT_FAILURE);
+        }
+        if (!waltable_checkpoint(w) || wal_log_size(path) != 0) {
+                printf("A checkpoint did not log the buffered changes "
+                       "first.\n");
+                exit(EXIT_FAILURE);
+        }
+        waltable_close(w);
+        rename(old_path, log_path);
+        w = open_int_waltable(path, 0);
+        check_wal_pairs(w, n, 0);
+        if (waltable_lookup(w, &n, &v, sizeof(v)) < 0 || v != a ||
+            waltable_lookup(w, &b, &u, sizeof(u)) < 0 || u != b ||
+            waltable_lookup(w, &k, &u, sizeof(u)) < 0 || u != k) {
+                printf("Durable table reopened from a checkpoint and the "
+                       "old log has the wrong pairs.\n");
+                exit(EXIT_FAILURE);
+        }
+        waltable_close(w);
+        remove_wal_files(path);
+
+        w = open_int_waltable(path, WAL_TEST_CHECKPOINT);
+        pthread_t threads[WAL_TEST_THREADS];
+        wal_test_arg args[WAL_TEST_THREADS];
+        for (int i = 0; i < WAL_TEST_THREADS; i++) {
+                args[i].w = w;
+                args[i].first = i;
+                args[i].step = WAL_TEST_THREADS;
+                pthread_create(&threads[i], NULL, wal_test_thread, &args[i]);
+        }
+        for (int i = 0; i < WAL_TEST_THREADS; i++) {
+                pthread_join(threads[i], NULL);
+                if (!args[i].ok) {
+                        printf("Failed to sync or look up a durable table "
+                               "from a thread.\n");
+                        exit(EXIT_FAILURE);
+                }
+        }
+        waltable_close(w);
+        if (wal_log_size(path) >= 2*WAL_TEST_CHECKPOINT) {
+                printf("The syncs made no checkpoint.\n");
+                exit(EXIT_FAILURE);
+        }
+        w = open_int_waltable(path, 0);
+        for (k = 0; k < n; k++) {
+                if (waltable_lookup(w, &k, &v, sizeof(v)) < 0 || v != k) {
+                        printf("Durable table lost key %d inserted by a "
+                               "thread.\n", k);
+                        exit(EXIT_FAILURE);
+                }
+        }
+        waltable_close(w);
+        remove_wal_files(path);
+        printf("Durable table with a write-ahead log - OK\n");
+}
+
+/*  Tests a table by performing a set of tests. Program exits if any
+ *  error is found.
+ */
+void correctnessTest()
+{
+		test_isempty();
+        test_insert_single_element();
+        test_lookup_single_element();
+        test_insert_lookup_different_keys();
+        test_insert_lookup_same_keys();
+        test_remove_single_element();
+        test_remove_elements_different_keys();
+        test_remove_elements_same_keys();
+        printf("Tests 2-8 on tables with a key hash function:\n");
+        basic_tests_hashed = true;
+        test_insert_single_element();
+        test_lookup_single_element();
+        test_insert_lookup_different_keys();
+        test_insert_lookup_same_keys();
+        test_remove_single_element();
+        test_remove_elements_different_keys();
+        test_remove_elements_same_keys();
+        basic_tests_hashed = false;
+        test_int_table();
+        test_insert_batch(TABLE_MODE_UNORDERED);
+        test_insert_batch(TABLE_MODE_SORTED);
+        test_insert_batch(TABLE_MODE_MOVE_TO_FRONT);
+        test_insert_batch(TABLE_MODE_TRANSPOSE);
+        test_insert_batch(TABLE_MODE_COUNT);
+        test_from_arrays();
+        test_arena_table();
+        test_iteration();
+        test_shardtable();
+        test_lftable();
+        test_rcutable();
+        test_parallel();
+        test_workloads();
+        test_memory_usage();
+        test_snapshot();
+        test_waltable();
+        test_str_table();
+        test_hash();
+}
+
+/* Tests the speed of a table using random numbers. First a number of
+ * elements are inserted. Second a random lookup among the elements are
+ * done followed by a skewed lookup (where a subset of the keys are
+ * looked up more frequently). Finally all elements are removed. Each
+ * benchmark starts from a table of its own, built before the timing
+ * starts.
+ *    n - the number of elements
+ *    mode - the storage mode of the tested tables
+ */
+void speedTest(int n, table_mode mode)
+{
+        int randomsize = 2*n; // To make it easier testing
+                              // non-existing keys later
+        int *keys = malloc(randomsize*sizeof(int));
+        int *values = malloc(randomsize*sizeof(int));
+        const char *variant = mode_name(mode);
+        create_random_sample(keys, randomsize);
+        create_random_sample(values, n);
+
+        run_phase("insert", variant, get_insert_speed, mode,
+                  keys, values, n);
+        run_phase("insert_batch", variant, get_batch_insert_speed, mode,
+                  keys, values, n);
+        if (mode == TABLE_MODE_UNORDERED) {
+                run_phase("build_from_arrays", variant, get_build_speed,
+                          mode, keys, values, n);
+                run_phase("insert_kill_malloc", variant,
+                          get_malloc_insert_speed, mode, keys, values, n);
+                run_phase("insert_kill_arena", variant,
+                          get_arena_insert_speed, mode, keys, values, n);
+        }
+        run_phase("remove", variant, get_remove_speed, mode,
+                  keys, values, n);
+        run_phase("iterate", variant, get_iteration_speed, mode,
+                  keys, values, n);
+        run_phase("lookup_missing", variant,
+                  get_random_non_existing_lookup_speed, mode,
+                  keys, values, n);
+        run_phase("lookup_random", variant, get_random_existing_lookup_speed,
+                  mode, keys, values, n);
+        run_phase("lookup_random_batch", variant,
+                  get_random_existing_lookup_batch_speed, mode,
+                  keys, values, n);
+        run_phase("lookup_skewed", variant, get_skewed_lookup_speed, mode,
+                  keys, values, n);
+
+        free(keys);
+        free(values);
+}
+
+/* Tests the speed of skewed lookups in each supported table mode, to
+ * show the effect of the self-organizing modes. The tables are filled
+ * in unordered mode and then switched to the tested mode.
+ */
+void skewedSpeedTest(int n)
+{
+        table_mode modes[] = { TABLE_MODE_UNORDERED, TABLE_MODE_SORTED,
+                               TABLE_MODE_MOVE_TO_FRONT, TABLE_MODE_TRANSPOSE,
+                               TABLE_MODE_COUNT };
+        int *keys = malloc(2*n*sizeof(int));
+        int *values = malloc(2*n*sizeof(int));
+        create_random_sample(keys, 2*n);
+        create_random_sample(values, n);
+        for (int m=0; m<(int)(sizeof(modes)/sizeof(modes[0])); m++) {
+                table *t = create_int_table(TABLE_MODE_UNORDERED);
+                bool supported = table_set_mode(t, modes[m]);
+                table_kill(t);
+                if (supported) {
+                        run_phase("lookup_skewed_mode", mode_name(modes[m]),
+                                  get_skewed_lookup_speed_after_fill,
+                                  modes[m], keys, values, n);
+                }
+        }
+        free(keys);
+        free(values);
+}
+
+/* Fill an int-keyed table with values.
+ *    t - the table to fill
+ *    keys - a list of keys to use
+ *    values - a list of values to use
+ */
+void insert_int_values(table_int *t, int *keys, int *values, int n)
+{
+        for(int i=0;i<n;i++) {
+                table_int_insert(t, keys[i], int_ptr_from_int(values[i]));
+        }
+}
+
+/* Create an int table filled with n pairs.
+ */
+table_int *create_filled_table_int(int *keys, int *values, int n)
+{
+        table_int *t = table_int_empty(free);
+        insert_int_values(t,keys,values,n);
+        return t;
+}
+
+/* Measures time taken to fill an int table with values.
+ *    mode - not used
+ *    keys - a list of keys to use
+ *    values - a list of values to use
+ *    n - the number of pairs
+ * Returns: The elapsed time in nanoseconds.
+ */
+uint64_t get_int_insert_speed(table_mode mode, int *keys, int *values, int n)
+{
+        (void)mode;
+        table_int *t = table_int_empty(free);
+        uint64_t start = bench_start();
+        insert_int_values(t,keys,values,n);
+        uint64_t end = bench_stop();
+        table_int_kill(t);
+        return end-start;
+}
+
+/* Measures time taken to remove all keys from an int table.
+ *    mode - not used
+ *    keys - a list of keys to use
+ *    values - a list of values to use
+ *    n - the number of pairs
+ * Returns: The elapsed time in nanoseconds.
+ */
+uint64_t get_int_remove_speed(table_mode mode, int *keys, int *values, int n)
+{
+        (void)mode;
+        table_int *t = create_filled_table_int(keys, values, n);
+        random_shuffle(keys, n);
+        uint64_t start = bench_start();
+        for(int i=0;i<n;i++) {
+                table_int_remove(t,keys[i]);
+        }
+        uint64_t end = bench_stop();
+        table_int_kill(t);
+        return end-start;
+}
+
+/* Measures time taken to do n lookups of non-existing keys in an int
+ * table.
+ *    mode - not used
+ *    keys - a list of 2n keys to use
+ *    values - a list of values to use
+ *    n - the number of lookups to perform
+ * Returns: The elapsed time in nanoseconds.
+ */
+uint64_t get_int_non_existing_lookup_speed(table_mode mode, int *keys,
+                                           int *values, int n)
+{
+        (void)mode;
+        table_int *t = create_filled_table_int(keys, values, n);
+        uint64_t start = bench_start();
+        for(int i=0;i<n;i++) {
+                table_int_lookup(t,keys[n+i]);
+        }
+        uint64_t end = bench_stop();
+        table_int_kill(t);
+        return end-start;
+}
+
+/* Measures time taken to do n lookups of existing keys in an int table.
+ *    mode - not used
+ *    keys - a list of keys to use
+ *    values - a list of values to use
+ *    n - the number of lookups to perform
+ * Returns: The elapsed time in nanoseconds.
+ */
+uint64_t get_int_random_lookup_speed(table_mode mode, int *keys,
+                                     int *values, int n)
+{
+        (void)mode;
+        table_int *t = create_filled_table_int(keys, values, n);
+        uint64_t start = bench_start();
+        for(int i=0;i<n;i++) {
+                table_int_lookup(t,keys[rand()%n]);
+        }
+        uint64_t end = bench_stop();
+        table_int_kill(t);
+        return end-start;
+}
+
+/* Tests the speed of the int-keyed table with the same operations as
+ * speedTest, so the two can be compared directly.
+ */
+void speedTestInt(int n)
+{
+        int randomsize = 2*n;
+        int *keys = malloc(randomsize*sizeof(int));
+        int *values = malloc(randomsize*sizeof(int));
+        create_random_sample(keys, randomsize);
+        create_random_sample(values, n);
+
+        run_phase("insert", "table_int", get_int_insert_speed,
+                  TABLE_MODE_UNORDERED, keys, values, n);
+        run_phase("remove", "table_int", get_int_remove_speed,
+                  TABLE_MODE_UNORDERED, keys, values, n);
+        run_phase("lookup_missing", "table_int",
+                  get_int_non_existing_lookup_speed, TABLE_MODE_UNORDERED,
+                  keys, values, n);
+        run_phase("lookup_random", "table_int", get_int_random_lookup_speed,
+                  TABLE_MODE_UNORDERED, keys, values, n);
+
+        free(keys);
+        free(values);
+}
+
+// String keys of the string benchmarks: the keys [0, n-1] are inserted
+// and the keys [n, 2n-1] are missing.
+static char **bench_strings;
+
+/* Fill a generic table with copies of the string keys [0, n-1].
+ *    t - the table to fill
+ *    values - a list of values to use
+ *    n - the number of pairs
+ */
+void insert_string_values(table *t, int *values, int n)
+{
+        for(int i=0;i<n;i++) {
+                table_insert(t, copy_string(bench_strings[i]),
+                             int_ptr_from_int(values[i]));
+        }
+}
+
+/* Create an empty generic table with string keys in the given mode.
+ */
+table *create_string_table(table_mode mode)
+{
+        table *t = table_empty_with_hash(string_compare, hash_string, free,
+                                         free);
+        table_set_mode(t, mode);
+        return t;
+}
+
+/* Fill a string table with the string keys [0, n-1].
+ */
+void insert_str_values(table_str *t, int *values, int n)
+{
+        for(int i=0;i<n;i++) {
+                table_str_insert(t, bench_strings[i],
+                                 int_ptr_from_int(values[i]));
+        }
+}
+
+/* Measures time taken to fill a generic table with string keys
+ *    mode - the storage mode of the table
+ *    keys - not used, the keys are bench_strings
+ *    values - a list of values to use
+ *    n - the number of pairs
+ * Returns: The elapsed time in nanoseconds.
+ */
+uint64_t get_string_insert_speed(table_mode mode, int *keys, int *values,
+                                 int n)
+{
+        (void)keys;
+        table *t = create_string_table(mode);
+        uint64_t start = bench_start();
+        insert_string_values(t,values,n);
+        uint64_t end = bench_stop();
+        bench_kill(t);
+        return end-start;
+}
+
+/* Measures time taken to do n lookups of missing string keys in a
+ * generic table
+ *    mode - the storage mode of the table
+ *    keys - not used, the keys are bench_strings
+ *    values - a list of values to use
+ *    n - the number of lookups to perform
+ * Returns: The elapsed time in nanoseconds.
+ */
+uint64_t get_string_missing_speed(table_mode mode, int *keys, int *values,
+                                  int n)
+{
+        (void)keys;
+        table *t = create_string_table(mode);
+        insert_string_values(t,values,n);
+        uint64_t start = bench_start();
+        for(int i=0;i<n;i++) {
+                table_lookup(t,bench_strings[n+i]);
+        }
+        uint64_t end = bench_stop();
+        bench_kill(t);
+        return end-start;
+}
+
+/* Measures time taken to do n lookups of random existing string keys in
+ * a generic table
+ *    mode - the storage mode of the table
+ *    keys - not used, the keys are bench_strings
+ *    values - a list of values to use
+ *    n - the number of lookups to perform
+ * Returns: The elapsed time in nanoseconds.
+ */
+uint64_t get_string_random_speed(table_mode mode, int *keys, int *values,
+                                 int n)
+{
+        (void)keys;
+        table *t = create_string_table(mode);
+        insert_string_values(t,values,n);
+        uint64_t start = bench_start();
+        for(int i=0;i<n;i++) {
+                table_lookup(t,bench_strings[rand()%n]);
+        }
+        uint64_t end = bench_stop();
+        bench_kill(t);
+        return end-start;
+}
+
+/* Measures time taken to fill a string table
+ *    mode - not used
+ *    keys - not used, the keys are bench_strings
+ *    values - a list of values to use
+ *    n - the number of pairs
+ * Returns: The elapsed time in nanoseconds.
+ */
+uint64_t get_str_insert_speed(table_mode mode, int *keys, int *values,
+                              int n)
+{
+        (void)mode;
+        (void)keys;
+        table_str *t = table_str_empty(free);
+        uint64_t start = bench_start();
+        insert_str_values(t,values,n);
+        uint64_t end = bench_stop();
+        table_str_kill(t);
+        return end-start;
+}
+
+/* Measures time taken to do n lookups of missing keys in a string table
+ *    mode - not used
+ *    keys - not used, the keys are bench_strings
+ *    values - a list of values to use
+ *    n - the number of lookups to perform
+ * Returns: The elapsed time in nanoseconds.
+ */
+uint64_t get_str_missing_speed(table_mode mode, int *keys, int *values,
+                               int n)
+{
+        (void)mode;
+        (void)keys;
+        table_str *t = table_str_empty(free);
+        insert_str_values(t,values,n);
+        uint64_t start = bench_start();
+        for(int i=0;i<n;i++) {
+                table_str_lookup(t,bench_strings[n+i]);
+        }
+        uint64_t end = bench_stop();
+        table_str_kill(t);
+        return end-start;
+}
+
+/* Measures time taken to do n lookups of random existing keys in a
+ * string table
+ *    mode - not used
+ *    keys - not used, the keys are bench_strings
+ *    values - a list of values to use
+ *    n - the number of lookups to perform
+ * Returns: The elapsed time in nanoseconds.
+ */
+uint64_t get_str_random_speed(table_mode mode, int *keys, int *values,
+                              int n)
+{
+        (void)mode;
+        (void)keys;
+        table_str *t = table_str_empty(free);
+        insert_str_values(t,values,n);
+        uint64_t start = bench_start();
+        for(int i=0;i<n;i++) {
+                table_str_lookup(t,bench_strings[rand()%n]);
+        }
+        uint64_t end = bench_stop();
+        table_str_kill(t);
+        return end-start;
+}
+
+/* Tests the speed of string keys like "user:12345", in a generic table
+ * with copy_string() keys and string_compare(), and in the string table
+ * with its inline keys.
+ */
+void speedTestStr(int n)
+{
+        int randomsize = 2*n;
+        int *keys = malloc(randomsize*sizeof(int));
+        int *values = malloc(n*sizeof(int));
+        create_random_sample(keys, randomsize);
+        create_random_sample(values, n);
+        bench_strings = malloc(randomsize*sizeof(char *));
+        for (int i = 0; i < randomsize; i++) {
+                char key[32];
+                sprintf(key, "user:%d", keys[i]);
+                bench_strings[i] = copy_string(key);
+        }
+
+        run_phase("insert", "strings", get_string_insert_speed,
+                  TABLE_MODE_UNORDERED, keys, values, n);
+        run_phase("lookup_missing", "strings", get_string_missing_speed,
+                  TABLE_MODE_UNORDERED, keys, values, n);
+        run_phase("lookup_random", "strings", get_string_random_speed,
+                  TABLE_MODE_UNORDERED, keys, values, n);
+        run_phase("insert", "table_str", get_str_insert_speed,
+                  TABLE_MODE_UNORDERED, keys, values, n);
+        run_phase("lookup_missing", "table_str", get_str_missing_speed,
+                  TABLE_MODE_UNORDERED, keys, values, n);
+        run_phase("lookup_random", "table_str", get_str_random_speed,
+                  TABLE_MODE_UNORDERED, keys, values, n);
+
+        for (int i = 0; i < randomsize; i++) {
+                free(bench_strings[i]);
+        }
+        free(bench_strings);
+        free(keys);
+        free(values);
+}
+
+// Keys of the hash benchmarks: pointers to ints, or strings.
+static void **bench_hash_keys;
+
+/* Measures time taken to hash the first n of bench_hash_keys one at a
+ * time
+ *    n - the number of keys
+ *    f - the hash function
+ * Returns: The elapsed time in nanoseconds.
+ */
+uint64_t time_hash(int n, hash_function *f)
+{
+        uint64_t *hashes = malloc(n*sizeof(uint64_t));
+        uint64_t start = bench_start();
+        for(int i=0;i<n;i++) {
+                hashes[i] = f(bench_hash_keys[i]);
+        }
+        uint64_t end = bench_stop();
+        free(hashes);
+        return end-start;
+}
+
+/* Measures time taken to hash the first n of bench_hash_keys with a
+ * batch hash function
+ *    n - the number of keys
+ *    f - the batch hash function
+ * Returns: The elapsed time in nanoseconds.
+ */
+uint64_t time_hash_batch(int n, hash_batch_function *f)
+{
+        uint64_t *hashes = malloc(n*sizeof(uint64_t));
+        uint64_t start = bench_start();
+        f(bench_hash_keys, n, hashes);
+        uint64_t end = bench_stop();
+        free(hashes);
+        return end-start;
+}
+
+/* Measures time taken to hash n ints with hash_int()
+ *    mode - not used
+ *    keys, values - not used, the keys are bench_hash_keys
+ *    n - the number of keys
+ * Returns: The elapsed time in nanoseconds.
+ */
+uint64_t get_hash_int_speed(table_mode mode, int *keys, int *values, int n)
+{
+        (void)mode;
+        (void)keys;
+        (void)values;
+        return time_hash(n, hash_int);
+}
+
+/* Measures time taken to hash n ints with hash_int_batch(), see get_hash_int_speed()
+ */
+uint64_t get_hash_int_batch_speed(table_mode mode, int *keys, int *values,
+                                  int n)
+{
+        (void)mode;
+        (void)keys;
+        (void)values;
+        return time_hash_batch(n, hash_int_batch);
+}
+
+/* Measures time taken to hash n strings with hash_string(), see get_hash_int_speed()
+ */
+uint64_t get_hash_string_speed(table_mode mode, int *keys, int *values,
+                               int n)
+{
+        (void)mode;
+        (void)keys;
+        (void)values;
+        return time_hash(n, hash_string);
+}
+
+/* Measures time taken to hash n strings with hash_string_batch(), see get_hash_int_speed()
+ */
+uint64_t get_hash_string_batch_speed(table_mode mode, int *keys,
+                                     int *values, int n)
+{
+        (void)mode;
+        (void)keys;
+        (void)values;
+        return time_hash_batch(n, hash_string_batch);
+}
+
+/* Measures time taken to hash n strings with fnv1a_hash(), see get_hash_int_speed()
+ */
+uint64_t get_fnv1a_speed(table_mode mode, int *keys, int *values, int n)
+{
+        (void)mode;
+        (void)keys;
+        (void)values;
+        return time_hash(n, fnv1a_hash);
+}
 
-        t = table_empty(int_compare, free, free);
-        insert_values(t,keys,values,n);
-        get_random_existing_lookup_speed(t, keys, n);
-        table_kill(t);
+/* Tests the speed of the built-in hash functions, one key at a time and
+ * in batches, on ints and on "user:N" strings, with FNV-1a as a
+ * baseline for the strings.
+ */
+void hashSpeedTest(int n)
+{
+        int *keys = malloc(n*sizeof(int));
+        char **strings = malloc(n*sizeof(char *));
+        bench_hash_keys = malloc(n*sizeof(void *));
+        create_random_sample(keys, n);
+        for (int i = 0; i < n; i++) {
+                char key[32];
+                sprintf(key, "user:%d", keys[i]);
+                strings[i] = copy_string(key);
+                bench_hash_keys[i] = &keys[i];
+        }
 
-        t = table_empty(int_compare, free, free);
-        insert_values(t,keys,values,n);
-        get_skewed_lookup_speed(t, keys, n);
-        table_kill(t);
+        run_phase("hash_int", "single", get_hash_int_speed,
+                  TABLE_MODE_UNORDERED, keys, NULL, n);
+        run_phase("hash_int", "batch", get_hash_int_batch_speed,
+                  TABLE_MODE_UNORDERED, keys, NULL, n);
+        for (int i = 0; i < n; i++) {
+                bench_hash_keys[i] = strings[i];
+        }
+        run_phase("hash_string", "fnv1a", get_fnv1a_speed,
+                  TABLE_MODE_UNORDERED, keys, NULL, n);
+        run_phase("hash_string", "single", get_hash_string_speed,
+                  TABLE_MODE_UNORDERED, keys, NULL, n);
+        run_phase("hash_string", "batch", get_hash_string_batch_speed,
+                  TABLE_MODE_UNORDERED, keys, NULL, n);
+
+        for (int i = 0; i < n; i++) {
+                free(strings[i]);
+        }
+        free(strings);
+        free(bench_hash_keys);
+        free(keys);
+}
+
+// Snapshot file of the snapshot benchmarks.
+static char bench_snapshot_path[sizeof(SNAPSHOT_PATH_TEMPLATE)];
+
+/* Load the snapshot of the snapshot benchmarks. Exits on failure.
+ */
+table *load_bench_snapshot()
+{
+        table *t = table_load_mmap(bench_snapshot_path, int_compare,
+                                   hash_int);
+        if (t == NULL) {
+                printf("Failed to load a snapshot: %s\n", strerror(errno));
+                exit(EXIT_FAILURE);
+        }
+        return t;
+}
+
+/* Measures time taken to save a filled table to bench_snapshot_path
+ *    mode - the storage mode of the table
+ *    keys - a list of keys to use
+ *    values - a list of values to use
+ *    n - the number of pairs
+ * Returns: The elapsed time in nanoseconds.
+ */
+uint64_t get_save_speed(table_mode mode, int *keys, int *values, int n)
+{
+        table *t = create_filled_int_table(mode, keys, values, n);
+        uint64_t start = bench_start();
+        bool saved = table_save(t, bench_snapshot_path, int_size, int_size);
+        uint64_t end = bench_stop();
+        bench_kill(t);
+        if (!saved) {
+                printf("Failed to save a snapshot: %s\n", strerror(errno));
+                exit(EXIT_FAILURE);
+        }
+        return end-start;
+}
+
+/* Measures time taken to load the table saved by get_save_speed()
+ *    mode, keys, values, n - not used, the table is loaded from
+ *                            bench_snapshot_path
+ * Returns: The elapsed time in nanoseconds.
+ */
+uint64_t get_load_speed(table_mode mode, int *keys, int *values, int n)
+{
+        (void)mode;
+        (void)keys;
+        (void)values;
+        (void)n;
+        uint64_t start = bench_start();
+        table *t = load_bench_snapshot();
+        uint64_t end = bench_stop();
+        bench_kill(t);
+        return end-start;
+}
+
+/* Measures time taken to do n lookups of existing keys in the table
+ * saved by get_save_speed(), right after it is loaded
+ *    mode - not used, the table is loaded from bench_snapshot_path
+ *    keys - the list of keys that was saved
+ *    values - not used
+ *    n - the number of lookups to perform
+ * Returns: The elapsed time in nanoseconds.
+ */
+uint64_t get_mapped_lookup_speed(table_mode mode, int *keys, int *values,
+                                 int n)
+{
+        (void)mode;
+        (void)values;
+        table *t = load_bench_snapshot();
+        uint64_t start = bench_start();
+        for(int i=0;i<n;i++) {
+                int pos = rand()%n;
+                table_lookup(t,&keys[pos]);
+        }
+        uint64_t end = bench_stop();
+        bench_kill(t);
+        return end-start;
+}
 
+/* Tests the speed of saving a table to a snapshot, loading it, and
+ * looking up keys in the loaded table. Compare load_mmap with insert
+ * and build_from_arrays to see the cost of a warm start.
+ */
+void snapshotSpeedTest(int n)
+{
+        int *keys = malloc(n*sizeof(int));
+        int *values = malloc(n*sizeof(int));
+        create_random_sample(keys, n);
+        create_random_sample(values, n);
+        make_snapshot_path(bench_snapshot_path);
+
+        run_phase("save", "snapshot", get_save_speed, TABLE_MODE_UNORDERED,
+                  keys, values, n);
+        run_phase("load_mmap", "snapshot", get_load_speed,
+                  TABLE_MODE_UNORDERED, keys, values, n);
+        run_phase("lookup_random", "snapshot", get_mapped_lookup_speed,
+                  TABLE_MODE_UNORDERED, keys, values, n);
+
+        remove(bench_snapshot_path);
         free(keys);
         free(values);
 }
 
-#define NAME "tabletest"
+// Snapshot of the durable table benchmarks, and the number of inserts
+// per sync of get_wal_insert_speed().
+static char bench_wal_path[sizeof(SNAPSHOT_PATH_TEMPLATE)];
+static int bench_sync_every;
+
+/* Measures time taken to insert n pairs into a new durable table,
+ * syncing after every bench_sync_every inserts and after the last
+ *    mode - not used, the table is opened from bench_wal_path
+ *    keys - a list of keys to use
+ *    values - a list of values to use
+ *    n - the number of pairs
+ * Returns: The elapsed time in nanoseconds.
+ */
+uint64_t get_wal_insert_speed(table_mode mode, int *keys, int *values,
+                              int n)
+{
+        (void)mode;
+        remove_wal_files(bench_wal_path);
+        waltable *w = open_int_waltable(bench_wal_path, 0);
+        uint64_t start = bench_start();
+        for(int i=0;i<n;i++) {
+                uint64_t lsn = waltable_insert(w,&keys[i],&values[i]);
+                if ((i+1)%bench_sync_every==0 || i==n-1) {
+                        waltable_sync(w,lsn);
+                }
+        }
+        uint64_t end = bench_stop();
+        waltable_close(w);
+        return end-start;
+}
+
+/* Measures time taken to open a durable table whose log holds n inserts
+ *    mode - not used, the table is opened from bench_wal_path
+ *    keys - a list of keys to use
+ *    values - a list of values to use
+ *    n - the number of pairs
+ * Returns: The elapsed time in nanoseconds.
+ */
+uint64_t get_replay_speed(table_mode mode, int *keys, int *values, int n)
+{
+        (void)mode;
+        remove_wal_files(bench_wal_path);
+        waltable *w = open_int_waltable(bench_wal_path, 0);
+        for(int i=0;i<n;i++) {
+                waltable_insert(w,&keys[i],&values[i]);
+        }
+        waltable_close(w);
+        uint64_t start = bench_start();
+        w = open_int_waltable(bench_wal_path, 0);
+        uint64_t end = bench_stop();
+        waltable_close(w);
+        return end-start;
+}
+
+/* Tests the speed of the durable table: inserts synced one by one,
+ * inserts synced in groups of WAL_SYNC_BATCH, and replaying the log
+ * when the table is opened. Compare replay with insert and load_mmap to
+ * see the cost of a start without a checkpoint.
+ */
+void walSpeedTest(int n)
+{
+        int *keys = malloc(n*sizeof(int));
+        int *values = malloc(n*sizeof(int));
+        create_random_sample(keys, n);
+        create_random_sample(values, n);
+        make_snapshot_path(bench_wal_path);
+        int synced = n < WAL_SYNC_OPS ? n : WAL_SYNC_OPS;
+
+        bench_sync_every = 1;
+        run_phase("wal_insert", "sync-1", get_wal_insert_speed,
+                  TABLE_MODE_UNORDERED, keys, values, synced);
+        char variant[32];
+        sprintf(variant, "sync-%d", WAL_SYNC_BATCH);
+        bench_sync_every = WAL_SYNC_BATCH;
+        run_phase("wal_insert", variant, get_wal_insert_speed,
+                  TABLE_MODE_UNORDERED, keys, values, n);
+        run_phase("replay", "wal", get_replay_speed, TABLE_MODE_UNORDERED,
+                  keys, values, n);
+
+        remove_wal_files(bench_wal_path);
+        free(keys);
+        free(values);
+}
+
+// Arguments of a thread in the multi-threaded benchmark. Either
+// shards or lf is set, or t and lock are.
+typedef struct thread_bench_arg {
+        shardtable *shards;
+        lftable *lf;
+        table *t;
+        pthread_mutex_t *lock;
+        int *keys; // The keys [0, n-1], also used as values.
+        int n;
+        unsigned seed;
+} thread_bench_arg;
+
+/* Do THREAD_OPS random operations: 80% lookups, 10% inserts and 10%
+ * removes of keys in [0, n-1].
+ */
+void *thread_bench(void *p)
+{
+        thread_bench_arg *arg = p;
+        epoch_thread *th = arg->lf != NULL ? lftable_attach(arg->lf) : NULL;
+        for (int i = 0; i < THREAD_OPS; i++) {
+                int r = rand_r(&arg->seed);
+                int *key = &arg->keys[r % arg->n];
+                int op = (r / arg->n) % 10;
+                if (arg->lf != NULL) {
+                        if (op == 0) {
+                                lftable_insert(arg->lf, th, key, key);
+                        } else if (op == 1) {
+                                lftable_remove(arg->lf, th, key);
+                        } else {
+                                lftable_lookup(arg->lf, th, key);
+                        }
+                } else if (arg->shards != NULL) {
+                        if (op == 0) {
+                                shardtable_insert(arg->shards, key, key);
+                        } else if (op == 1) {
+                                shardtable_remove(arg->shards, key);
+                        } else {
+                                shardtable_lookup(arg->shards, key);
+                        }
+                } else {
+                        pthread_mutex_lock(arg->lock);
+                        if (op == 0) {
+                                table_insert(arg->t, key, key);
+                        } else if (op == 1) {
+                                table_remove(arg->t, key);
+                        } else {
+                                table_lookup(arg->t, key);
+                        }
+                        pthread_mutex_unlock(arg->lock);
+                }
+        }
+        if (th != NULL) {
+                lftable_detach(th);
+        }
+        return NULL;
+}
+
+/* Run the mixed workload with a number of threads, on the sharded
+ * table if shards is non-NULL, on the lock-free table if lf is
+ * non-NULL, otherwise on t guarded by one mutex.
+ * Returns: The number of operations per second.
+ */
+double run_thread_bench(shardtable *shards, lftable *lf, table *t,
+                        int *keys, int n, int threads)
+{
+        pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+        pthread_t *ids = malloc(threads*sizeof(pthread_t));
+        thread_bench_arg *args = malloc(threads*sizeof(thread_bench_arg));
+        uint64_t start = get_nanoseconds();
+        for (int i = 0; i < threads; i++) {
+                args[i].shards = shards;
+                args[i].lf = lf;
+                args[i].t = t;
+                args[i].lock = &lock;
+                args[i].keys = keys;
+                args[i].n = n;
+                args[i].seed = i+1;
+                pthread_create(&ids[i], NULL, thread_bench, &args[i]);
+        }
+        for (int i = 0; i < threads; i++) {
+                pthread_join(ids[i], NULL);
+        }
+        uint64_t end = get_nanoseconds();
+        free(ids);
+        free(args);
+        return (double)THREAD_OPS*threads*1e9/(end-start);
+}
+
+/* Measures the throughput of a mixed workload (80% lookups, 10%
+ * inserts, 10% removes) on n keys, with 1, 2, 4, ... up to max_threads
+ * threads. Each thread count is run on a table guarded by one mutex,
+ * on a sharded table with THREAD_SHARDS shards and on a lock-free
+ * table. The keys are always the same n keys, which is all the lock-free
+ * table created for n keys can take.
+ *    n - the number of keys
+ *    max_threads - the largest number of threads
+ */
+void threadSpeedTest(int n, int max_threads)
+{
+        int *keys = malloc(n*sizeof(int));
+        for (int i = 0; i < n; i++) {
+                keys[i] = i;
+        }
+        printf("Mixed workload on %d keys, %d operations per thread:\n",
+               n, THREAD_OPS);
+        for (int threads = 1; ; threads *= 2) {
+                if (threads > max_threads) {
+                        threads = max_threads;
+                }
+                table *t = table_empty_with_hash(int_compare, hash_int,
+                                                 NULL, NULL);
+                shardtable *s = shardtable_empty(THREAD_SHARDS, int_compare,
+                                                 hash_int, NULL, NULL);
+                lftable *lf = lftable_empty(n, int_compare, hash_int,
+                                            NULL, NULL);
+                epoch_thread *th = lftable_attach(lf);
+                for (int i = 0; i < n; i++) {
+                        table_insert(t, &keys[i], &keys[i]);
+                        shardtable_insert(s, &keys[i], &keys[i]);
+                        lftable_insert(lf, th, &keys[i], &keys[i]);
+                }
+                lftable_detach(th);
+                double locked = run_thread_bench(NULL, NULL, t, keys, n,
+                                                 threads);
+                double sharded = run_thread_bench(s, NULL, NULL, keys, n,
+                                                  threads);
+                double lockfree = run_thread_bench(NULL, lf, NULL, keys, n,
+                                                   threads);
+                printf("%3d threads, one mutex : %12.0f ops/s\n",
+                       threads, locked);
+                printf("%3d threads, sharded   : %12.0f ops/s\n",
+                       threads, sharded);
+                printf("%3d threads, lock-free : %12.0f ops/s\n",
+                       threads, lockfree);
+                table_kill(t);
+                shardtable_kill(s);
+                lftable_kill(lf);
+                if (threads == max_threads) {
+                        break;
+                }
+        }
+        free(keys);
+}
+
+// Arguments of a thread in the read-mostly benchmark. Either rcu is
+// set, or t and lock are.
+typedef struct read_bench_arg {
+        rcutable *rcu;
+        table *t;
+        pthread_rwlock_t *lock;
+        int *keys; // The keys [0, n-1], also used as values.
+        int n;
+        unsigned seed;
+        atomic_bool *stop; // Set when the readers are done.
+} read_bench_arg;
+
+/* Insert and remove random keys until the readers are done.
+ */
+void *read_bench_writer(void *p)
+{
+        read_bench_arg *arg = p;
+        epoch_thread *th = arg->rcu != NULL ? rcutable_attach(arg->rcu) : NULL;
+        while (!atomic_load_explicit(arg->stop, memory_order_relaxed)) {
+                int r = rand_r(&arg->seed);
+                int *key = &arg->keys[r % arg->n];
+                bool insert = (r / arg->n) % 2 == 0;
+                if (arg->rcu != NULL) {
+                        if (insert) {
+                                rcutable_insert(arg->rcu, th, key, key);
+                        } else {
+                                rcutable_remove(arg->rcu, th, key);
+                        }
+                } else {
+                        pthread_rwlock_wrlock(arg->lock);
+                        if (insert) {
+                                table_insert(arg->t, key, key);
+                        } else {
+                                table_remove(arg->t, key);
+                        }
+                        pthread_rwlock_unlock(arg->lock);
+                }
+        }
+        if (th != NULL) {
+                rcutable_detach(th);
+        }
+        return NULL;
+}
+
+/* Do THREAD_OPS lookups of random keys.
+ */
+void *read_bench_reader(void *p)
+{
+        read_bench_arg *arg = p;
+        epoch_thread *th = arg->rcu != NULL ? rcutable_attach(arg->rcu) : NULL;
+        for (int i = 0; i < THREAD_OPS; i++) {
+                int *key = &arg->keys[rand_r(&arg->seed) % arg->n];
+                if (arg->rcu != NULL) {
+                        rcutable_lookup(arg->rcu, th, key);
+                } else {
+                        pthread_rwlock_rdlock(arg->lock);
+                        table_lookup(arg->t, key);
+                        pthread_rwlock_unlock(arg->lock);
+                }
+        }
+        if (th != NULL) {
+                rcutable_detach(th);
+        }
+        return NULL;
+}
+
+/* Run a number of reader threads next to one writer thread, on the
+ * read-copy-update table if rcu is non-NULL, otherwise on t guarded by
+ * a read-write lock.
+ * Returns: The number of lookups per second.
+ */
+double run_read_bench(rcutable *rcu, table *t, int *keys, int n,
+                      int readers)
+{
+        pthread_rwlock_t lock = PTHREAD_RWLOCK_INITIALIZER;
+        atomic_bool stop = false;
+        pthread_t *ids = malloc((readers+1)*sizeof(pthread_t));
+        read_bench_arg *args = malloc((readers+1)*sizeof(read_bench_arg));
+        uint64_t start = get_nanoseconds();
+        for (int i = 0; i <= readers; i++) {
+                args[i].rcu = rcu;
+                args[i].t = t;
+                args[i].lock = &lock;
+                args[i].keys = keys;
+                args[i].n = n;
+                args[i].seed = i+1;
+                args[i].stop = &stop;
+                pthread_create(&ids[i], NULL, i == readers ?
+                               read_bench_writer : read_bench_reader,
+                               &args[i]);
+        }
+        for (int i = 0; i < readers; i++) {
+                pthread_join(ids[i], NULL);
+        }
+        uint64_t end = get_nanoseconds();
+        atomic_store(&stop, true);
+        pthread_join(ids[readers], NULL);
+        free(ids);
+        free(args);
+        return (double)THREAD_OPS*readers*1e9/(end-start);
+}
+
+/* Measures the lookup throughput of 1, 2, 4, ... up to max_threads
+ * reader threads while one writer thread inserts and removes keys, on
+ * a table guarded by a read-write lock and on a read-copy-update
+ * table.
+ *    n - the number of keys
+ *    max_threads - the largest number of reader threads
+ */
+void readSpeedTest(int n, int max_threads)
+{
+        int *keys = malloc(n*sizeof(int));
+        for (int i = 0; i < n; i++) {
+                keys[i] = i;
+        }
+        printf("Lookups on %d keys next to one writer, %d per reader:\n",
+               n, THREAD_OPS);
+        for (int readers = 1; ; readers *= 2) {
+                if (readers > max_threads) {
+                        readers = max_threads;
+                }
+                table *t = table_empty_with_hash(int_compare, hash_int,
+                                                 NULL, NULL);
+                rcutable *rcu = rcutable_empty(int_compare, hash_int,
+                                               NULL, NULL);
+                epoch_thread *th = rcutable_attach(rcu);
+                for (int i = 0; i < n; i++) {
+                        table_insert(t, &keys[i], &keys[i]);
+                        rcutable_insert(rcu, th, &keys[i], &keys[i]);
+                }
+                rcutable_detach(th);
+                double locked = run_read_bench(NULL, t, keys, n, readers);
+                double rcu_rate = run_read_bench(rcu, NULL, keys, n, readers);
+                printf("%3d readers, rwlock    : %12.0f lookups/s\n",
+                       readers, locked);
+                printf("%3d readers, rcu       : %12.0f lookups/s\n",
+                       readers, rcu_rate);
+                table_kill(t);
+                rcutable_kill(rcu);
+                if (readers == max_threads) {
+                        break;
+                }
+        }
+        free(keys);
+}
+
+// Thread pool used by the parallel bulk operations in the benchmarks,
+// or NULL to run them in the calling thread.
+static threadpool *bench_pool;
+
+/* Build an int-keyed table with free functions from n pairs with
+ * table_from_arrays_parallel() on bench_pool.
+ *    keys - a list of keys to use
+ *    n - the number of pairs
+ */
+table *create_parallel_int_table(int *keys, int n)
+{
+        void **key_ptrs = malloc(n*sizeof(void *));
+        void **value_ptrs = malloc(n*sizeof(void *));
+        for (int i = 0; i < n; i++) {
+                key_ptrs[i] = int_ptr_from_int(keys[i]);
+                value_ptrs[i] = int_ptr_from_int(i);
+        }
+        table *t = table_from_arrays_parallel(key_ptrs, value_ptrs, n,
+                                              int_compare, hash_int,
+                                              free, free, bench_pool);
+        free(key_ptrs);
+        free(value_ptrs);
+        return t;
+}
+
+/* Measures time taken to build a table from arrays with
+ * table_from_arrays_parallel() on bench_pool.
+ *    mode - not used
+ *    keys - a list of keys to use
+ *    values - not used, the values are the indexes of the keys
+ *    n - the number of pairs
+ * Returns: The elapsed time in nanoseconds.
+ */
+uint64_t get_parallel_build_speed(table_mode mode, int *keys, int *values,
+                                  int n)
+{
+        (void)mode;
+        (void)values;
+        void **key_ptrs = malloc(n*sizeof(void *));
+        void **value_ptrs = malloc(n*sizeof(void *));
+        for (int i = 0; i < n; i++) {
+                key_ptrs[i] = int_ptr_from_int(keys[i]);
+                value_ptrs[i] = int_ptr_from_int(i);
+        }
+        uint64_t start = bench_start();
+        table *t = table_from_arrays_parallel(key_ptrs, value_ptrs, n,
+                                              int_compare, hash_int,
+                                              free, free, bench_pool);
+        uint64_t end = bench_stop();
+        bench_kill(t);
+        free(key_ptrs);
+        free(value_ptrs);
+        return end-start;
+}
+
+/* Measures time taken to look up n random existing keys with
+ * table_lookup_batch_parallel() on bench_pool. The table is switched
+ * to the given mode first, if the implementation supports it.
+ *    mode - the storage mode to switch to
+ *    keys - a list of keys to use
+ *    values - not used, the values are the indexes of the keys
+ *    n - the number of lookups to perform
+ * Returns: The elapsed time in nanoseconds.
+ */
+uint64_t get_parallel_lookup_speed(table_mode mode, int *keys, int *values,
+                                   int n)
+{
+        (void)values;
+        table *t = create_parallel_int_table(keys, n);
+        table_set_mode(t, mode);
+        void **key_ptrs = malloc(n*sizeof(void *));
+        void **found = malloc(n*sizeof(void *));
+        for (int i = 0; i < n; i++) {
+                key_ptrs[i] = &keys[rand()%n];
+        }
+        uint64_t start = bench_start();
+        table_lookup_batch_parallel(t, key_ptrs, n, found, bench_pool);
+        uint64_t end = bench_stop();
+        bench_kill(t);
+        free(key_ptrs);
+        free(found);
+        return end-start;
+}
+
+/* Measures time taken to kill a table of n pairs with free functions
+ * with table_kill_parallel() on bench_pool.
+ *    mode - not used
+ *    keys - a list of keys to use
+ *    values - not used, the values are the indexes of the keys
+ *    n - the number of pairs
+ * Returns: The elapsed time in nanoseconds.
+ */
+uint64_t get_parallel_kill_speed(table_mode mode, int *keys, int *values,
+                                 int n)
+{
+        (void)mode;
+        (void)values;
+        table *t = create_parallel_int_table(keys, n);
+        bench_collect(t);
+        uint64_t start = bench_start();
+        table_kill_parallel(t, bench_pool);
+        uint64_t end = bench_stop();
+        return end-start;
+}
+
+/* Measures the serial and the parallel bulk operations on n int keys
+ * with free functions: building a table from arrays, looking up random
+ * keys, and killing the table. The serial versions are the parallel
+ * functions without a pool. The lookups are done in sorted mode if the
+ * implementation supports it.
+ *    n - the number of pairs
+ *    threads - the number of threads of the pool
+ */
+void parallelSpeedTest(int n, int threads)
+{
+        int *keys = malloc(n*sizeof(int));
+        create_random_sample(keys, n);
+        threadpool *pool = threadpool_empty(threads);
+        printf("Bulk operations on %d pairs, serial and with %d threads:\n",
+               n, threadpool_size(pool));
+        for (int parallel = 0; parallel < 2; parallel++) {
+                const char *variant = parallel ? "parallel" : "serial";
+                bench_pool = parallel ? pool : NULL;
+                run_phase("build_from_arrays", variant,
+                          get_parallel_build_speed, TABLE_MODE_UNORDERED,
+                          keys, NULL, n);
+                run_phase("lookup_batch", variant, get_parallel_lookup_speed,
+                          TABLE_MODE_SORTED, keys, NULL, n);
+                run_phase("kill", variant, get_parallel_kill_speed,
+                          TABLE_MODE_UNORDERED, keys, NULL, n);
+        }
+        bench_pool = NULL;
+        threadpool_kill(pool);
+        free(keys);
+}
+
+// Table measured by the lookups of the size sweep.
+static table *bench_table;
+
+/* Build a table in the given mode whose keys and values point into the
+ * key and value arrays, so that the table owns no memory but its own.
+ *    mode - the storage mode to switch to, if supported
+ *    keys - a list of keys to use
+ *    values - a list of values to use
+ *    n - the number of pairs
+ */
+table *create_unowned_int_table(table_mode mode, int *keys, int *values,
+                                int n)
+{
+        void **key_ptrs = malloc(n*sizeof(void *));
+        void **value_ptrs = malloc(n*sizeof(void *));
+        for (int i = 0; i < n; i++) {
+                key_ptrs[i] = &keys[i];
+                value_ptrs[i] = &values[i];
+        }
+        table *t = table_from_arrays_with_hash(key_ptrs, value_ptrs, n,
+                                               int_compare, hash_int,
+                                               NULL, NULL);
+        table_set_mode(t, mode);
+        free(key_ptrs);
+        free(value_ptrs);
+        return t;
+}
+
+/* Return the number of lookups timed at size n in the size sweep.
+ */
+int sweep_ops(int n)
+{
+        return n < SWEEP_OPS ? n : SWEEP_OPS;
+}
+
+/* Measures time taken to build a table of n pairs from arrays, in the
+ * given mode, with keys and values that the table does not own.
+ *    mode - the storage mode to switch to, if supported
+ *    keys - a list of keys to use
+ *    values - a list of values to use
+ *    n - the number of pairs
+ * Returns: The elapsed time in nanoseconds.
+ */
+uint64_t get_sweep_build_speed(table_mode mode, int *keys, int *values,
+                               int n)
+{
+        void **key_ptrs = malloc(n*sizeof(void *));
+        void **value_ptrs = malloc(n*sizeof(void *));
+        for (int i = 0; i < n; i++) {
+                key_ptrs[i] = &keys[i];
+                value_ptrs[i] = &values[i];
+        }
+        uint64_t start = bench_start();
+        table *t = table_from_arrays_with_hash(key_ptrs, value_ptrs, n,
+                                               int_compare, hash_int,
+                                               NULL, NULL);
+        table_set_mode(t, mode);
+        uint64_t end = bench_stop();
+        bench_kill(t);
+        free(key_ptrs);
+        free(value_ptrs);
+        return end-start;
+}
+
+/* Measures time taken to look up random keys in bench_table, which
+ * holds keys [0, n-1] of the key array. If missing is true, the keys
+ * are taken from [n, 2n-1] instead, which are not in the table. If
+ * batch is true, table_lookup_batch() is used. The operation counts of
+ * the lookups are added to bench_table_stats.
+ * Returns: The elapsed time in nanoseconds.
+ */
+uint64_t sweep_lookups(int *keys, int n, bool missing, bool batch)
+{
+        int ops = sweep_ops(n);
+        void **key_ptrs = malloc(ops*sizeof(void *));
+        void **found = malloc(ops*sizeof(void *));
+        for (int i = 0; i < ops; i++) {
+                key_ptrs[i] = &keys[(missing ? n : 0) + rand()%n];
+        }
+        table_reset_stats(bench_table);
+        uint64_t start = bench_start();
+        if (batch) {
+                table_lookup_batch(bench_table, key_ptrs, ops, found);
+        } else {
+                for (int i = 0; i < ops; i++) {
+                        found[i] = table_lookup(bench_table, key_ptrs[i]);
+                }
+        }
+        uint64_t end = bench_stop();
+        bench_collect(bench_table);
+        free(key_ptrs);
+        free(found);
+        return end-start;
+}
+
+/* Measures time taken to look up random existing keys in bench_table.
+ *    mode - not used, the table is already built
+ *    keys - the key array the table was built from
+ *    values - not used
+ *    n - the number of keys in the table
+ * Returns: The elapsed time in nanoseconds.
+ */
+uint64_t get_sweep_hit_speed(table_mode mode, int *keys, int *values, int n)
+{
+        (void)mode;
+        (void)values;
+        return sweep_lookups(keys, n, false, false);
+}
+
+/* Measures time taken to look up random missing keys in bench_table.
+ *    mode - not used, the table is already built
+ *    keys - the key array the table was built from, with 2n keys
+ *    values - not used
+ *    n - the number of keys in the table
+ * Returns: The elapsed time in nanoseconds.
+ */
+uint64_t get_sweep_miss_speed(table_mode mode, int *keys, int *values,
+                              int n)
+{
+        (void)mode;
+        (void)values;
+        return sweep_lookups(keys, n, true, false);
+}
+
+/* Measures time taken to look up random existing keys in bench_table
+ * with table_lookup_batch().
+ *    mode - not used, the table is already built
+ *    keys - the key array the table was built from
+ *    values - not used
+ *    n - the number of keys in the table
+ * Returns: The elapsed time in nanoseconds.
+ */
+uint64_t get_sweep_batch_speed(table_mode mode, int *keys, int *values,
+                               int n)
+{
+        (void)mode;
+        (void)values;
+        return sweep_lookups(keys, n, false, true);
+}
+
+/* Measures build and lookup times at sizes SWEEP_MIN, 2*SWEEP_MIN, ...
+ * up to max_n, so that the sizes cross the cache levels and end in main
+ * memory. The tables are in sorted mode if the implementation supports
+ * it, so that lookups are sub-linear, and own neither keys nor values.
+ * Each size reports ns/op, with at most SWEEP_OPS lookups per trial,
+ * and the bytes per entry of the table itself, see table_memory_usage().
+ *    max_n - the largest size
+ */
+void sweepSpeedTest(int max_n)
+{
+        int *keys = malloc(2*(size_t)max_n*sizeof(int));
+        int *values = malloc((size_t)max_n*sizeof(int));
+        create_random_sample(keys, 2*max_n);
+        for (int i = 0; i < max_n; i++) {
+                values[i] = i;
+        }
+        table *t = create_int_table(TABLE_MODE_UNORDERED);
+        table_mode mode = table_set_mode(t, TABLE_MODE_SORTED) ?
+                TABLE_MODE_SORTED : TABLE_MODE_UNORDERED;
+        table_kill(t);
+        for (int n = max_n < SWEEP_MIN ? max_n : SWEEP_MIN; ;
+             n = n < max_n/2 ? 2*n : max_n) {
+                bench_table = create_unowned_int_table(mode, keys, values, n);
+                bench_bytes = (double)table_memory_usage(bench_table)/n;
+                run_phase("sweep_build", mode_name(mode),
+                          get_sweep_build_speed, mode, keys, values, n);
+                run_phase_ops("sweep_lookup_hit", mode_name(mode),
+                              get_sweep_hit_speed, mode, keys, values, n,
+                              sweep_ops(n));
+                run_phase_ops("sweep_lookup_miss", mode_name(mode),
+                              get_sweep_miss_speed, mode, keys, values, n,
+                              sweep_ops(n));
+                run_phase_ops("sweep_lookup_batch", mode_name(mode),
+                              get_sweep_batch_speed, mode, keys, values, n,
+                              sweep_ops(n));
+                table_kill(bench_table);
+                bench_table = NULL;
+                if (n >= max_n) {
+                        break;
+                }
+        }
+        bench_bytes = -1;
+        free(keys);
+        free(values);
+}
+
+// Workload profile measured by get_workload_speed().
+static const workload_profile *bench_profile;
+
+/* Measures time taken to run n operations of the workload bench_profile
+ * on a table that holds the keys [0, n-1]. The operations are generated
+ * and the keys and values of inserts and updates are allocated before
+ * the timing starts.
+ *    mode - the storage mode of the table
+ *    keys - not used, the keys are [0, n-1]
+ *    values - not used, the values are the keys
+ *    n - the number of keys and of operations
+ * Returns: The elapsed time in nanoseconds.
+ */
+uint64_t get_workload_speed(table_mode mode, int *keys, int *values, int n)
+{
+        (void)keys;
+        (void)values;
+        table *t = create_int_table(mode);
+        for (int i = 0; i < n; i++) {
+                table_insert(t, int_ptr_from_int(i), int_ptr_from_int(i));
+        }
+        workload *w = workload_empty(bench_profile, n, 1);
+        workload_op *ops = malloc(n*sizeof(workload_op));
+        void **key_ptrs = malloc(n*sizeof(void *));
+        void **value_ptrs = malloc(n*sizeof(void *));
+        for (int i = 0; i < n; i++) {
+                ops[i] = workload_next(w);
+                if (ops[i].type == WORKLOAD_UPDATE ||
+                    ops[i].type == WORKLOAD_INSERT) {
+                        key_ptrs[i] = int_ptr_from_int(ops[i].key);
+                        value_ptrs[i] = int_ptr_from_int(ops[i].key);
+                }
+        }
+        workload_kill(w);
+
+        uint64_t start = bench_start();
+        for (int i = 0; i < n; i++) {
+                switch (ops[i].type) {
+                case WORKLOAD_READ:
+                        table_lookup(t, &ops[i].key);
+                        break;
+                case WORKLOAD_UPDATE:
+                case WORKLOAD_INSERT:
+                        table_insert(t, key_ptrs[i], value_ptrs[i]);
+                        break;
+                case WORKLOAD_REMOVE:
+                        table_remove(t, &ops[i].key);
+                        break;
+                }
+        }
+        uint64_t end = bench_stop();
+        bench_kill(t);
+        free(ops);
+        free(key_ptrs);
+        free(value_ptrs);
+        return end-start;
+}
+
+/* Check if a name is one of the names in a comma-separated list.
+ */
+bool name_in_list(const char *name, const char *list)
+{
+        size_t len = strlen(name);
+        while (*list != '\0') {
+                size_t item = strcspn(list, ",");
+                if (item == len && strncmp(list, name, len) == 0) {
+                        return true;
+                }
+                list += item;
+                if (*list == ',') {
+                        list++;
+                }
+        }
+        return false;
+}
+
+/* Measures the throughput of workload profiles on a table in
+ * unordered mode holding n keys, n operations per trial. The lock-free
+ * table is left out, since the churn profile keeps inserting new keys
+ * and every new key uses up one of its slots for good.
+ *    n - the number of keys
+ *    names - comma-separated names of the profiles to run, or NULL
+ *            or "all" to run all profiles
+ */
+void workloadSpeedTest(int n, const char *names)
+{
+        const workload_profile *p;
+        for (int i = 0; (p = workload_profile_get(i)) != NULL; i++) {
+                if (names != NULL && strcmp(names, "all") != 0 &&
+                    !name_in_list(p->name, names)) {
+                        continue;
+                }
+                bench_profile = p;
+                run_phase(p->name, mode_name(TABLE_MODE_UNORDERED),
+                          get_workload_speed, TABLE_MODE_UNORDERED,
+                          NULL, NULL, n);
+        }
+        bench_profile = NULL;
+}
+
+/* Check that every name in a comma-separated list is a workload
+ * profile, or that the list is "all".
+ */
+bool valid_profile_list(const char *list)
+{
+        if (strcmp(list, "all") == 0) {
+                return true;
+        }
+        char name[64];
+        while (*list != '\0') {
+                size_t len = strcspn(list, ",");
+                if (len >= sizeof(name)) {
+                        return false;
+                }
+                memcpy(name, list, len);
+                name[len] = '\0';
+                if (workload_profile_find(name) == NULL) {
+                        return false;
+                }
+                list += len;
+                if (*list == ',') {
+                        list++;
+                }
+        }
+        return true;
+}
 
 int main(int argc,char **argv)
 {
         int n=0;
-        fprintf(stderr,NAME " " VERSION "\n");
-        if (argc<2) {
-                fprintf(stderr,"Usage:\n\t%s n\n\twhere n is an integer from "
-                        "1 to %d.\n",argv[0],TABLESIZE);
+        int threads=0;
+        char *profiles=NULL;
+        bool sweep=false;
+        int opt;
+        fprintf(stderr,NAME " " VERSION " (" BACKEND ")\n");
+        while ((opt=getopt(argc,argv,"st:p:w:r:f:"))!=-1) {
+                if (opt=='s') {
+                        sweep=true;
+                        continue;
+                }
+                if (opt=='t' && sscanf(optarg,"%d",&threads)==1 &&
+                    threads>=1) {
+                        continue;
+                }
+                if (opt=='p' && valid_profile_list(optarg)) {
+                        profiles=optarg;
+                        continue;
+                }
+                if (opt=='w' && sscanf(optarg,"%d",&bench_warmup)==1 &&
+                    bench_warmup>=0) {
+                        continue;
+                }
+                if (opt=='r' && sscanf(optarg,"%d",&bench_trials)==1 &&
+                    bench_trials>=1) {
+                        continue;
+                }
+                if (opt=='f' && strcmp(optarg,"text")==0) {
+                        bench_output=FORMAT_TEXT;
+                        continue;
+                }
+                if (opt=='f' && strcmp(optarg,"json")==0) {
+                        bench_output=FORMAT_JSON;
+                        continue;
+                }
+                if (opt=='f' && strcmp(optarg,"csv")==0) {
+                        bench_output=FORMAT_CSV;
+                        continue;
+                }
+                fprintf(stderr,"Usage:\n\t%s " USAGE " [n]\n",argv[0]);
+                exit(EXIT_FAILURE);
+        }
+        if (optind>=argc) {
+                fprintf(stderr,"Usage:\n\t%s " USAGE " n\n\twhere n is "
+                        "an integer from 1 to %d.\n",argv[0],MAX_TABLESIZE);
                 n=TABLESIZE;
                 fprintf(stderr,"No n supplied, using %d.\n",n);
         } else {
-                sscanf(argv[1],"%d",&n);
+                sscanf(argv[optind],"%d",&n);
         }
-        if (n<1 || n>TABLESIZE) {
+        if (n<1 || n>MAX_TABLESIZE) {
                 fprintf(stderr,"Error: supplied value of n (%d) is outside "
-                        "allowed range 1-%d.\n",n,TABLESIZE);
+                        "allowed range 1-%d.\n",n,MAX_TABLESIZE);
                 exit(EXIT_FAILURE);
         }
+        bench_file=stdout;
+        if (bench_output!=FORMAT_TEXT) {
+                // Keep stdout for the results, send the rest to stderr.
+                fflush(stdout);
+                bench_file=fdopen(dup(STDOUT_FILENO),"w");
+                dup2(STDERR_FILENO,STDOUT_FILENO);
+        }
         correctnessTest();
         printf("All correctness tests succeeded!\n\n");
+        bench_counters=perfcount_empty();
+        if (bench_counters!=NULL && perfcount_error(bench_counters)!=0) {
+                printf("Some hardware counters are unavailable (%s), "
+                       "their events are not reported.\n\n",
+                       strerror(perfcount_error(bench_counters)));
+        }
+        bench_begin(n);
         /*getchar();*/
-        speedTest(n);
+        if (sweep) {
+                printf("Size sweep up to %d keys, B/entry is the memory "
+                       "of the table itself:\n", n);
+                sweepSpeedTest(n);
+        } else if (threads>0) {
+                threadSpeedTest(n, threads);
+                printf("\n");
+                readSpeedTest(n, threads);
+                printf("\n");
+                parallelSpeedTest(n, threads);
+        } else if (profiles==NULL) {
+                speedTest(n, TABLE_MODE_UNORDERED);
+                printf("\n");
+                table *t = create_int_table(TABLE_MODE_UNORDERED);
+                if (table_set_mode(t, TABLE_MODE_SORTED)) {
+                        printf("Sorted mode:\n");
+                        speedTest(n, TABLE_MODE_SORTED);
+                        printf("\n");
+                }
+                table_kill(t);
+                printf("Skewed lookups by table mode:\n");
+                skewedSpeedTest(n);
+                printf("\n");
+                printf("Int table:\n");
+                speedTestInt(n);
+                printf("\n");
+                printf("String keys:\n");
+                speedTestStr(n);
+                printf("\n");
+                printf("Hash functions:\n");
+                hashSpeedTest(n);
+                printf("\n");
+                printf("Snapshots:\n");
+                snapshotSpeedTest(n);
+                printf("\n");
+                printf("Durable table:\n");
+                walSpeedTest(n);
+        }
+        if ((!sweep && threads==0) || profiles!=NULL) {
+                printf("\nWorkloads on %d keys:\n", n);
+                workloadSpeedTest(n, profiles);
+        }
+        bench_end();
+        if (bench_counters!=NULL) {
+                perfcount_kill(bench_counters);
+        }
         printf("Test completed.\n");
         return 0;
 }
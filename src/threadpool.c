@@ -0,0 +1,214 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "threadpool.h"
+
+/*
+ * Implementation of a thread pool for parallel loops.
+ *
+ * The workers sleep on a condition variable until a loop is posted.
+ * Every thread, the caller included, then takes chunks of the range by
+ * atomically advancing a shared index. The range is cut into about
+ * CHUNKS_PER_THREAD chunks per thread, so a thread that is slowed down
+ * delays the loop by at most one chunk. The caller waits until every
+ * worker has left the loop before returning.
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first version.
+ */
+
+// Number of chunks per thread a loop is split into, at least.
+#define CHUNKS_PER_THREAD 4
+
+// ===========INTERNAL DATA TYPES============
+
+struct threadpool {
+	pthread_t *workers;
+	int size; // Number of threads, the caller included.
+	pthread_mutex_t run_lock; // Serializes threadpool_run calls.
+	pthread_mutex_t lock; // Guards the fields below.
+	pthread_cond_t start; // Signalled when a loop is posted.
+	pthread_cond_t done; // Signalled when the last worker finishes.
+	unsigned long generation; // Incremented for each loop.
+	int busy; // Number of workers in the current loop.
+	bool stop; // Set by threadpool_kill.
+	// The current loop.
+	threadpool_task *task;
+	void *arg;
+	int n;
+	int chunk;
+	atomic_int next; // Start of the next range to take.
+};
+
+// ===========INTERNAL FUNCTION IMPLEMENTATIONS============
+
+/*
+ * Take and run chunks of the current loop until none are left.
+ */
+static void run_chunks(threadpool *p)
+{
+	for (;;) {
+		int begin = atomic_fetch_add(&p->next, p->chunk);
+		if (begin >= p->n) {
+			return;
+		}
+		int end = p->n - begin < p->chunk ? p->n : begin + p->chunk;
+		p->task(p->arg, begin, end);
+	}
+}
+
+/*
+ * Main function of a worker thread.
+ */
+static void *worker(void *arg)
+{
+	threadpool *p = arg;
+	unsigned long seen = 0;
+	pthread_mutex_lock(&p->lock);
+	for (;;) {
+		while (!p->stop && p->generation == seen) {
+			pthread_cond_wait(&p->start, &p->lock);
+		}
+		if (p->stop) {
+			break;
+		}
+		seen = p->generation;
+		pthread_mutex_unlock(&p->lock);
+		run_chunks(p);
+		pthread_mutex_lock(&p->lock);
+		if (--p->busy == 0) {
+			pthread_cond_signal(&p->done);
+		}
+	}
+	pthread_mutex_unlock(&p->lock);
+	return NULL;
+}
+
+// ===========DATA STRUCTURE INTERFACE IMPLEMENTATION============
+
+/**
+ * threadpool_empty() - Create a thread pool.
+ * @threads: Number of threads that run a loop, including the calling
+ *	     thread, or 0 for one per online CPU.
+ *
+ * Return: Pointer to a new pool, or NULL if the threads could not be
+ * created.
+ * Simplified asymptotic complexity analysis : O(threads)
+ */
+threadpool *threadpool_empty(int threads)
+{
+	if (threads <= 0) {
+		long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		threads = cpus > 0 ? (int)cpus : 1;
+	}
+	threadpool *p = calloc(1, sizeof(*p));
+	if (p == NULL) {
+		return NULL;
+	}
+	p->workers = malloc((threads - 1 > 0 ? threads - 1 : 1) *
+			    sizeof(pthread_t));
+	if (p->workers == NULL) {
+		free(p);
+		return NULL;
+	}
+	pthread_mutex_init(&p->run_lock, NULL);
+	pthread_mutex_init(&p->lock, NULL);
+	pthread_cond_init(&p->start, NULL);
+	pthread_cond_init(&p->done, NULL);
+	atomic_init(&p->next, 0);
+	p->size = 1;
+	for (int i = 0; i < threads - 1; i++) {
+		if (pthread_create(&p->workers[i], NULL, worker, p) != 0) {
+			threadpool_kill(p);
+			return NULL;
+		}
+		p->size++;
+	}
+	return p;
+}
+
+/**
+ * threadpool_size() - Get the number of threads of a pool.
+ * @p: Pool to inspect.
+ *
+ * Return: The number of threads that run a loop, including the calling
+ * thread.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+int threadpool_size(const threadpool *p)
+{
+	return p->size;
+}
+
+/**
+ * threadpool_run() - Run a parallel loop.
+ * @p: Pool to run the loop on, or NULL to run it in the calling thread.
+ * @task: Body of the loop.
+ * @arg: Argument passed to task.
+ * @n: Number of iterations.
+ * @chunk: Smallest number of iterations given to a thread at a time.
+ *
+ * Returns: Nothing, when all ranges are done.
+ * Simplified asymptotic complexity analysis : O(n / threads) for a
+ * task that is O(end - begin)
+ */
+void threadpool_run(threadpool *p, threadpool_task *task, void *arg,
+		    int n, int chunk)
+{
+	if (n <= 0) {
+		return;
+	}
+	if (p == NULL || p->size == 1 || n <= chunk) {
+		task(arg, 0, n);
+		return;
+	}
+	int even = (n + p->size * CHUNKS_PER_THREAD - 1) /
+		   (p->size * CHUNKS_PER_THREAD);
+	pthread_mutex_lock(&p->run_lock);
+	pthread_mutex_lock(&p->lock);
+	p->task = task;
+	p->arg = arg;
+	p->n = n;
+	p->chunk = even > chunk ? even : (chunk > 0 ? chunk : 1);
+	atomic_store(&p->next, 0);
+	p->busy = p->size - 1;
+	p->generation++;
+	pthread_cond_broadcast(&p->start);
+	pthread_mutex_unlock(&p->lock);
+
+	run_chunks(p);
+
+	pthread_mutex_lock(&p->lock);
+	while (p->busy > 0) {
+		pthread_cond_wait(&p->done, &p->lock);
+	}
+	pthread_mutex_unlock(&p->lock);
+	pthread_mutex_unlock(&p->run_lock);
+}
+
+/**
+ * threadpool_kill() - Destroy a thread pool.
+ * @p: Pool to destroy.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(threads)
+ */
+void threadpool_kill(threadpool *p)
+{
+	pthread_mutex_lock(&p->lock);
+	p->stop = true;
+	pthread_cond_broadcast(&p->start);
+	pthread_mutex_unlock(&p->lock);
+	for (int i = 0; i < p->size - 1; i++) {
+		pthread_join(p->workers[i], NULL);
+	}
+	pthread_mutex_destroy(&p->run_lock);
+	pthread_mutex_destroy(&p->lock);
+	pthread_cond_destroy(&p->start);
+	pthread_cond_destroy(&p->done);
+	free(p->workers);
+	free(p);
+}
@@ -0,0 +1,769 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "waltable.h"
+#include "table.h"
+#include "snapshot.h"
+
+/*
+ * Implementation of a durable table with a write-ahead log.
+ *
+ * A log record is a log_header followed by the key bytes and the value
+ * bytes, without padding. The checksum covers the rest of the header
+ * and the bytes, so a record that was cut short or only partly written
+ * by a crash is detected, and replay stops there.
+ *
+ * The keys and values are copied into the table arena, which never
+ * frees anything, so replaced and removed pairs stay in memory until
+ * the next checkpoint reloads the table from its snapshot.
+ *
+ * New records are appended to an in-memory buffer. A thread that syncs
+ * while no other thread does becomes the leader: it swaps the buffer
+ * with a spare one, and writes and syncs the full buffer with the lock
+ * released, so other threads can keep changing the table meanwhile.
+ * Threads that sync while the leader is busy wait for it, and one of
+ * them leads the next sync if their changes were not covered.
+ *
+ * Replaying a log on top of a snapshot that already holds its changes
+ * gives the same table, since each key ends up with the pair of its
+ * last change. So a crash between saving a checkpoint and replacing the
+ * log is harmless.
+ *
+ * A checkpoint flushes the buffered records, then collects pointers to
+ * the pairs with the lock held and notes the size of the log. The snapshot is then saved and loaded with
+ * the lock released, while other threads keep changing the old table.
+ * The pairs stay valid meanwhile, since the old table is only killed at
+ * the end. Finally, with the lock held again, the records that were
+ * logged after the noted size are replayed into the loaded table and
+ * copied to a new log, which replaces the old one.
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first version.
+ *   2026-10-16: v1.1, checkpoints are saved with the lock released, and
+ *               lookups copy the value.
+ *   2026-10-16: v1.2, checkpoints flush the log before collecting the
+ *               pairs, so the snapshot matches a prefix of the log.
+ */
+
+// Types of log records.
+#define LOG_INSERT 1
+#define LOG_REMOVE 2
+
+// Value size of a record whose value is NULL, or of a remove record.
+#define LOG_NULL UINT32_MAX
+
+// Initial size of a record buffer, and of the pair arrays of a replay.
+#define INITIAL_BUFFER 4096
+#define INITIAL_BATCH 256
+
+// ===========INTERNAL DATA TYPES============
+
+// Header of a log record.
+typedef struct log_header {
+	uint32_t checksum;	// Checksum of the rest of the record.
+	uint32_t type;		// LOG_INSERT or LOG_REMOVE.
+	uint32_t key_size;	// Bytes of the key.
+	uint32_t value_size;	// Bytes of the value, or LOG_NULL.
+} log_header;
+
+// Records that are not written to the log yet.
+typedef struct log_buffer {
+	unsigned char *data;
+	size_t len;
+	size_t cap;
+} log_buffer;
+
+struct waltable {
+	table *t;
+	char *path;		// Snapshot file.
+	char *log_path;		// Log file.
+	int fd;			// Log file, opened for appending.
+	compare_function *key_cmp_func;
+	hash_function *key_hash_func;
+	size_function *key_size_func;
+	size_function *value_size_func;
+	size_t checkpoint_bytes; // Log size that triggers a checkpoint.
+	pthread_mutex_t lock;	// Guards the fields below and the table.
+	pthread_cond_t synced;	// Signalled when a leader finishes.
+	log_buffer buf;		// Records of the changes after written_lsn.
+	log_buffer spare;	// Buffer being written by the leader.
+	bool syncing;		// True while a leader writes and syncs.
+	bool checkpointing;	// True while a checkpoint is made.
+	uint64_t next_lsn;	// LSN of the next change.
+	uint64_t durable_lsn;	// Changes up to this LSN are durable.
+	size_t log_bytes;	// Size of the log file.
+	int error;		// errno of a failed write or sync, or 0.
+};
+
+// ===========INTERNAL FUNCTION IMPLEMENTATIONS============
+
+/*
+ * Return the 32-bit FNV-1a hash of n bytes.
+ */
+static uint32_t checksum(const unsigned char *p, size_t n)
+{
+	uint32_t h = 2166136261u;
+	for (size_t i = 0; i < n; i++) {
+		h = (h ^ p[i]) * 16777619u;
+	}
+	return h;
+}
+
+/*
+ * Append a record to the buffer of a table. Returns false with errno
+ * set if the sizes are too large or not enough memory was available.
+ */
+static bool append_record(waltable *w, uint32_t type,
+			  const void *key, size_t key_size,
+			  const void *value, size_t value_size)
+{
+	if (key_size >= LOG_NULL || (value != NULL && value_size >= LOG_NULL)) {
+		errno = EOVERFLOW;
+		return false;
+	}
+	size_t size = sizeof(log_header) + key_size +
+		      (value != NULL ? value_size : 0);
+	log_buffer *b = &w->buf;
+	if (b->len + size > b->cap) {
+		size_t cap = b->cap > 0 ? b->cap : INITIAL_BUFFER;
+		while (cap < b->len + size) {
+			cap *= 2;
+		}
+		unsigned char *data = realloc(b->data, cap);
+		if (data == NULL) {
+			return false;
+		}
+		b->data = data;
+		b->cap = cap;
+	}
+	unsigned char *p = b->data + b->len;
+	log_header h = { 0, type, key_size,
+			 value != NULL ? value_size : LOG_NULL };
+	memcpy(p, &h, sizeof(h));
+	memcpy(p + sizeof(h), key, key_size);
+	if (value != NULL) {
+		memcpy(p + sizeof(h) + key_size, value, value_size);
+	}
+	h.checksum = checksum(p + sizeof(h.checksum),
+			      size - sizeof(h.checksum));
+	memcpy(p, &h.checksum, sizeof(h.checksum));
+	b->len += size;
+	return true;
+}
+
+/*
+ * Write n bytes to the log and sync them. Returns 0, or the errno of
+ * the failed call.
+ */
+static int write_log(int fd, const unsigned char *p, size_t n)
+{
+	while (n > 0) {
+		ssize_t written = write(fd, p, n);
+		if (written < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return errno;
+		}
+		p += written;
+		n -= written;
+	}
+	return fdatasync(fd) == 0 ? 0 : errno;
+}
+
+/*
+ * Write and sync the buffered records with the lock held. No leader
+ * may be syncing. Returns false with errno set on failure.
+ */
+static bool flush_locked(waltable *w)
+{
+	if (w->error == 0 && w->buf.len > 0) {
+		w->error = write_log(w->fd, w->buf.data, w->buf.len);
+		if (w->error == 0) {
+			w->log_bytes += w->buf.len;
+			w->buf.len = 0;
+			w->durable_lsn = w->next_lsn - 1;
+		}
+	}
+	if (w->error != 0) {
+		errno = w->error;
+		return false;
+	}
+	return true;
+}
+
+/*
+ * Flush the directory that holds path, so that a rename to path is
+ * durable. Returns false with errno set if the directory could not be
+ * synced.
+ */
+static bool sync_dir(const char *path)
+{
+	const char *slash = strrchr(path, '/');
+	size_t len = slash == NULL ? 0 : slash == path ? 1 : slash - path;
+	char *dir = malloc(len + sizeof("."));
+	if (dir == NULL) {
+		return false;
+	}
+	if (len == 0) {
+		strcpy(dir, ".");
+	} else {
+		memcpy(dir, path, len);
+		dir[len] = '\0';
+	}
+	int fd = open(dir, O_RDONLY | O_DIRECTORY);
+	free(dir);
+	if (fd < 0) {
+		return false;
+	}
+	bool ok = fsync(fd) == 0;
+	int error = errno;
+	close(fd);
+	errno = error;
+	return ok;
+}
+
+/*
+ * Read n bytes at offset of a file. Returns false with errno set if
+ * they could not be read.
+ */
+static bool read_at(int fd, unsigned char *p, size_t n, off_t offset)
+{
+	while (n > 0) {
+		ssize_t r = pread(fd, p, n, offset);
+		if (r < 0 && errno == EINTR) {
+			continue;
+		}
+		if (r <= 0) {
+			if (r == 0) {
+				errno = EIO;
+			}
+			return false;
+		}
+		p += r;
+		n -= r;
+		offset += r;
+	}
+	return true;
+}
+
+/*
+ * Replay the records of the n bytes of a log at p into t. Sets valid to
+ * the length of the valid records. Returns false if not enough memory
+ * was available.
+ */
+static bool replay_records(table *t, const unsigned char *p, size_t n,
+			   size_t *valid)
+{
+	arena *a = table_arena(t);
+	int cap = INITIAL_BATCH;
+	void **keys = malloc(cap * sizeof(void *));
+	void **values = malloc(cap * sizeof(void *));
+	int batch = 0;
+	size_t pos = 0;
+	bool ok = a != NULL && keys != NULL && values != NULL;
+	while (ok && n - pos >= sizeof(log_header)) {
+		log_header h;
+		memcpy(&h, p + pos, sizeof(h));
+		size_t left = n - pos - sizeof(h);
+		size_t value_size = h.value_size == LOG_NULL ? 0 : h.value_size;
+		if ((h.type != LOG_INSERT && h.type != LOG_REMOVE) ||
+		    h.key_size > left || value_size > left - h.key_size) {
+			break;
+		}
+		size_t size = sizeof(h) + h.key_size + value_size;
+		if (checksum(p + pos + sizeof(h.checksum),
+			     size - sizeof(h.checksum)) != h.checksum) {
+			break;
+		}
+		const unsigned char *key = p + pos + sizeof(h);
+		if (h.type == LOG_REMOVE) {
+			if (!table_insert_batch(t, keys, values, batch)) {
+				ok = false;
+				break;
+			}
+			batch = 0;
+			table_remove(t, key);
+		} else {
+			if (batch == cap) {
+				cap *= 2;
+				void **k = realloc(keys, cap * sizeof(void *));
+				keys = k != NULL ? k : keys;
+				void **v = realloc(values, cap * sizeof(void *));
+				values = v != NULL ? v : values;
+				if (k == NULL || v == NULL) {
+					ok = false;
+					break;
+				}
+			}
+			keys[batch] = arena_copy(a, key, h.key_size);
+			values[batch] = h.value_size == LOG_NULL ? NULL :
+				arena_copy(a, key + h.key_size, value_size);
+			if (keys[batch] == NULL ||
+			    (h.value_size != LOG_NULL && values[batch] == NULL)) {
+				ok = false;
+				break;
+			}
+			batch++;
+		}
+		pos += size;
+	}
+	ok = ok && table_insert_batch(t, keys, values, batch);
+	if (!ok) {
+		errno = ENOMEM;
+	}
+	free(keys);
+	free(values);
+	*valid = pos;
+	return ok;
+}
+
+/*
+ * Collect pointers to the pairs of a table into two new arrays. Returns
+ * the number of pairs, or -1 if not enough memory was available.
+ */
+static int collect_pairs(const table *t, void ***keys, void ***values)
+{
+	int cap = INITIAL_BATCH;
+	int n = 0;
+	void **k = malloc(cap * sizeof(void *));
+	void **v = malloc(cap * sizeof(void *));
+	table_iter it;
+	table_iter_begin(t, &it);
+	bool ok = k != NULL && v != NULL;
+	while (ok && table_iter_next(&it, &k[n], &v[n])) {
+		if (++n == cap) {
+			cap *= 2;
+			void **nk = realloc(k, cap * sizeof(void *));
+			k = nk != NULL ? nk : k;
+			void **nv = realloc(v, cap * sizeof(void *));
+			v = nv != NULL ? nv : v;
+			ok = nk != NULL && nv != NULL;
+		}
+	}
+	if (!ok) {
+		free(k);
+		free(v);
+		errno = ENOMEM;
+		return -1;
+	}
+	*keys = k;
+	*values = v;
+	return n;
+}
+
+/*
+ * Replay the records logged after offset cut into t, and replace the
+ * log with one that holds only those records. Called with the lock held
+ * and no leader syncing. Returns false with errno set on failure, the
+ * log is unchanged in that case.
+ */
+static bool switch_log(waltable *w, table *t, size_t cut)
+{
+	if (!flush_locked(w)) {
+		return false;
+	}
+	size_t n = w->log_bytes - cut;
+	unsigned char *p = malloc(n > 0 ? n : 1);
+	char *tmp_path = malloc(strlen(w->log_path) + sizeof(".tmp"));
+	int in = open(w->log_path, O_RDONLY);
+	int out = -1;
+	size_t valid = 0;
+	bool ok = p != NULL && tmp_path != NULL && in >= 0 &&
+		  read_at(in, p, n, cut) && replay_records(t, p, n, &valid);
+	if (ok && valid != n) {
+		// Records written by this table must all be valid.
+		errno = EIO;
+		ok = false;
+	}
+	if (ok) {
+		sprintf(tmp_path, "%s.tmp", w->log_path);
+		out = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND,
+			   0644);
+		int error = out >= 0 ? write_log(out, p, n) : errno;
+		errno = error;
+		ok = error == 0 && rename(tmp_path, w->log_path) == 0 &&
+		     sync_dir(w->log_path);
+	}
+	int error = errno;
+	if (ok) {
+		close(w->fd);
+		w->fd = out;
+		w->log_bytes = n;
+	} else if (out >= 0) {
+		close(out);
+		remove(tmp_path);
+	}
+	if (in >= 0) {
+		close(in);
+	}
+	free(p);
+	free(tmp_path);
+	errno = error;
+	return ok;
+}
+
+/*
+ * Make a checkpoint. Called and returns with the lock held, which is
+ * released while the snapshot is saved and loaded. Returns false with
+ * errno set on failure.
+ */
+static bool checkpoint(waltable *w)
+{
+	while (w->checkpointing || w->syncing) {
+		pthread_cond_wait(&w->synced, &w->lock);
+	}
+	// The snapshot must hold exactly the changes logged before cut, or
+	// a crash before the log is replaced could recover a table that
+	// never existed.
+	if (!flush_locked(w)) {
+		return false;
+	}
+	void **keys;
+	void **values;
+	int n = collect_pairs(w->t, &keys, &values);
+	if (n < 0) {
+		return false;
+	}
+	size_t cut = w->log_bytes;
+	w->checkpointing = true;
+	pthread_mutex_unlock(&w->lock);
+
+	bool ok = snapshot_save(w->path, keys, values, n, w->key_cmp_func,
+				w->key_size_func, w->value_size_func);
+	free(keys);
+	free(values);
+	table *t = ok ? table_load_mmap(w->path, w->key_cmp_func,
+					w->key_hash_func) : NULL;
+	int error = errno;
+
+	pthread_mutex_lock(&w->lock);
+	while (t != NULL && w->syncing) {
+		pthread_cond_wait(&w->synced, &w->lock);
+	}
+	if (t != NULL && !switch_log(w, t, cut)) {
+		error = errno;
+		table_kill(t);
+		t = NULL;
+	}
+	if (t != NULL) {
+		table_kill(w->t);
+		w->t = t;
+	}
+	w->checkpointing = false;
+	pthread_cond_broadcast(&w->synced);
+	errno = error;
+	return t != NULL;
+}
+
+/*
+ * Replay the log of a table, if it exists. Returns false with errno
+ * set if it could not be read.
+ */
+static bool replay(waltable *w)
+{
+	int fd = open(w->log_path, O_RDONLY);
+	if (fd < 0) {
+		return errno == ENOENT;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		int error = errno;
+		close(fd);
+		errno = error;
+		return false;
+	}
+	size_t n = st.st_size;
+	if (n == 0) {
+		close(fd);
+		return true;
+	}
+	void *p = mmap(NULL, n, PROT_READ, MAP_PRIVATE, fd, 0);
+	int error = errno;
+	close(fd);
+	if (p == MAP_FAILED) {
+		errno = error;
+		return false;
+	}
+	bool ok = replay_records(w->t, p, n, &w->log_bytes);
+	error = errno;
+	munmap(p, n);
+	errno = error;
+	return ok;
+}
+
+/*
+ * Free a table and everything it owns, keeping errno.
+ */
+static void free_waltable(waltable *w)
+{
+	int error = errno;
+	if (w->fd >= 0) {
+		close(w->fd);
+	}
+	if (w->t != NULL) {
+		table_kill(w->t);
+	}
+	free(w->buf.data);
+	free(w->spare.data);
+	free(w->path);
+	free(w->log_path);
+	free(w);
+	errno = error;
+}
+
+// ===========DATA STRUCTURE INTERFACE IMPLEMENTATION============
+
+/**
+ * waltable_open() - Open a durable table, creating it if needed.
+ * @path: Name of the snapshot file.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: A pointer to a function (or NULL) to be used to hash
+ *		   keys.
+ * @key_size_func: A pointer to a function that returns the number of
+ *		   bytes of a key.
+ * @value_size_func: A pointer to a function that returns the number of
+ *		     bytes of a value.
+ * @checkpoint_bytes: Size of the log at which waltable_sync() makes a
+ *		      checkpoint, or 0.
+ *
+ * A new table is put in sorted mode if the implementation supports it,
+ * as a loaded array table is, so that the batches of a replay are
+ * merged into the table instead of inserted one by one.
+ *
+ * Return: Pointer to the table, or NULL with errno set on failure.
+ * Simplified asymptotic complexity analysis : O(snapshot + cost of
+ * replaying the log)
+ */
+waltable *waltable_open(const char *path, compare_function key_cmp_func,
+			hash_function key_hash_func,
+			size_function key_size_func,
+			size_function value_size_func,
+			size_t checkpoint_bytes)
+{
+	waltable *w = calloc(1, sizeof(*w));
+	if (w == NULL) {
+		return NULL;
+	}
+	w->fd = -1;
+	w->key_cmp_func = key_cmp_func;
+	w->key_hash_func = key_hash_func;
+	w->key_size_func = key_size_func;
+	w->value_size_func = value_size_func;
+	w->checkpoint_bytes = checkpoint_bytes;
+	w->path = malloc(strlen(path) + 1);
+	w->log_path = malloc(strlen(path) + sizeof(".wal"));
+	if (w->path == NULL || w->log_path == NULL) {
+		free_waltable(w);
+		return NULL;
+	}
+	strcpy(w->path, path);
+	sprintf(w->log_path, "%s.wal", path);
+
+	w->t = table_load_mmap(path, key_cmp_func, key_hash_func);
+	if (w->t == NULL && errno == ENOENT) {
+		w->t = table_empty_with_hash(key_cmp_func, key_hash_func,
+					     NULL, NULL);
+		if (w->t == NULL) {
+			free_waltable(w);
+			errno = ENOMEM;
+			return NULL;
+		}
+		table_set_mode(w->t, TABLE_MODE_SORTED);
+	}
+	if (w->t == NULL || !replay(w)) {
+		free_waltable(w);
+		return NULL;
+	}
+	// Drop a partly written record at the end of the log.
+	w->fd = open(w->log_path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+	if (w->fd < 0 || ftruncate(w->fd, w->log_bytes) != 0) {
+		free_waltable(w);
+		return NULL;
+	}
+	pthread_mutex_init(&w->lock, NULL);
+	pthread_cond_init(&w->synced, NULL);
+	w->next_lsn = 1;
+	return w;
+}
+
+/**
+ * waltable_insert() - Add a key/value pair to a durable table.
+ * @w: Table to manipulate.
+ * @key: A pointer to the key value, which is copied.
+ * @value: A pointer to the value value (or NULL), which is copied.
+ *
+ * Return: The LSN of the change, or 0 if not enough memory was
+ * available.
+ * Simplified asymptotic complexity analysis : O(table_insert)
+ */
+uint64_t waltable_insert(waltable *w, const void *key, const void *value)
+{
+	size_t key_size = w->key_size_func(key);
+	size_t value_size = value != NULL ? w->value_size_func(value) : 0;
+	uint64_t lsn = 0;
+	pthread_mutex_lock(&w->lock);
+	arena *a = table_arena(w->t);
+	void *k = a != NULL ? arena_copy(a, key, key_size) : NULL;
+	void *v = value != NULL && k != NULL ?
+		arena_copy(a, value, value_size) : NULL;
+	size_t buffered = w->buf.len;
+	if (k != NULL && (value == NULL || v != NULL) &&
+	    append_record(w, LOG_INSERT, key, key_size, value, value_size)) {
+		if (table_insert(w->t, k, v)) {
+			lsn = w->next_lsn++;
+		} else {
+			// Take the record back, the change was not made.
+			w->buf.len = buffered;
+		}
+	}
+	pthread_mutex_unlock(&w->lock);
+	return lsn;
+}
+
+/**
+ * waltable_remove() - Remove a key/value pair from a durable table.
+ * @w: Table to manipulate.
+ * @key: Key for which to remove pair.
+ *
+ * Return: The LSN of the change, or 0 if not enough memory was
+ * available.
+ * Simplified asymptotic complexity analysis : O(table_remove)
+ */
+uint64_t waltable_remove(waltable *w, const void *key)
+{
+	size_t key_size = w->key_size_func(key);
+	uint64_t lsn = 0;
+	pthread_mutex_lock(&w->lock);
+	if (append_record(w, LOG_REMOVE, key, key_size, NULL, 0)) {
+		table_remove(w->t, key);
+		lsn = w->next_lsn++;
+	}
+	pthread_mutex_unlock(&w->lock);
+	return lsn;
+}
+
+/**
+ * waltable_lookup() - Look up a given key in a durable table.
+ * @w: Table to inspect.
+ * @key: Key to look up.
+ * @value: Buffer that the value is copied to.
+ * @size: Size of the buffer.
+ *
+ * The value is copied with the lock held, since a checkpoint made by
+ * another thread frees the memory of the old table.
+ *
+ * Return: The number of bytes of the value, or -1 if the key is not
+ * found in the table or its value is NULL.
+ * Simplified asymptotic complexity analysis : O(table_lookup + bytes)
+ */
+ssize_t waltable_lookup(waltable *w, const void *key, void *value,
+			size_t size)
+{
+	ssize_t value_size = -1;
+	pthread_mutex_lock(&w->lock);
+	void *v = table_lookup(w->t, key);
+	if (v != NULL) {
+		value_size = w->value_size_func(v);
+		memcpy(value, v, (size_t)value_size < size ? (size_t)value_size
+							   : size);
+	}
+	pthread_mutex_unlock(&w->lock);
+	return value_size;
+}
+
+/**
+ * waltable_sync() - Make changes durable.
+ * @w: Table to sync.
+ * @lsn: LSN of the last change that must be durable.
+ *
+ * Return: True if all changes up to lsn are durable, false with errno
+ * set otherwise.
+ * Simplified asymptotic complexity analysis : O(bytes buffered)
+ */
+bool waltable_sync(waltable *w, uint64_t lsn)
+{
+	pthread_mutex_lock(&w->lock);
+	if (lsn >= w->next_lsn) {
+		lsn = w->next_lsn - 1;
+	}
+	while (w->durable_lsn < lsn && w->error == 0) {
+		if (w->syncing) {
+			pthread_cond_wait(&w->synced, &w->lock);
+			continue;
+		}
+		// Lead a sync of everything buffered so far.
+		log_buffer b = w->buf;
+		w->buf = w->spare;
+		w->buf.len = 0;
+		uint64_t last = w->next_lsn - 1;
+		int fd = w->fd;
+		w->syncing = true;
+		pthread_mutex_unlock(&w->lock);
+		int error = write_log(fd, b.data, b.len);
+		pthread_mutex_lock(&w->lock);
+		w->spare = b;
+		w->syncing = false;
+		if (error == 0) {
+			w->durable_lsn = last;
+			w->log_bytes += b.len;
+		} else {
+			w->error = error;
+		}
+		pthread_cond_broadcast(&w->synced);
+		// A failed checkpoint leaves the log to be replayed.
+		if (error == 0 && w->checkpoint_bytes > 0 &&
+		    w->log_bytes >= w->checkpoint_bytes && !w->checkpointing) {
+			checkpoint(w);
+		}
+	}
+	bool ok = w->durable_lsn >= lsn;
+	int error = w->error;
+	pthread_mutex_unlock(&w->lock);
+	if (!ok) {
+		errno = error;
+	}
+	return ok;
+}
+
+/**
+ * waltable_checkpoint() - Save a durable table and empty its log.
+ * @w: Table to save.
+ *
+ * Return: True if the checkpoint was made, false with errno set
+ * otherwise.
+ * Simplified asymptotic complexity analysis : O(n log n + bytes)
+ */
+bool waltable_checkpoint(waltable *w)
+{
+	pthread_mutex_lock(&w->lock);
+	bool ok = checkpoint(w);
+	int error = errno;
+	pthread_mutex_unlock(&w->lock);
+	errno = error;
+	return ok;
+}
+
+/**
+ * waltable_close() - Sync and close a durable table.
+ * @w: Table to close.
+ *
+ * Return: True if all changes were synced, false with errno set
+ * otherwise.
+ * Simplified asymptotic complexity analysis : O(n + bytes buffered)
+ */
+bool waltable_close(waltable *w)
+{
+	bool ok = flush_locked(w);
+	pthread_mutex_destroy(&w->lock);
+	pthread_cond_destroy(&w->synced);
+	free_waltable(w);
+	return ok;
+}
@@ -0,0 +1,242 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "workload.h"
+
+/*
+ * Implementation of a YCSB-style workload generator.
+ *
+ * Zipf-distributed ranks are drawn with the method of Gray et al.,
+ * "Quickly generating billion-record synthetic databases" (SIGMOD
+ * 1994), as in the YCSB ZipfianGenerator. The constant zeta(n) is
+ * computed once when the generator is created, after which each draw
+ * takes O(1). Rank r is mapped to the key index mix(r) mod n, so the
+ * popular keys are scattered over the key range like in the YCSB
+ * ScrambledZipfianGenerator, instead of being the lowest keys, which
+ * would favour tables that keep their entries in key order.
+ *
+ * The live keys are always an interval [first, next-1] that holds n or
+ * n+1 keys. Key index i is mapped to the live key that is congruent to
+ * i modulo n, so a popular index keeps naming the same key until churn
+ * removes that key, and then names the key that replaced it.
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first version.
+ */
+
+// Skew of the Zipf distribution, the YCSB default.
+#define ZIPF_THETA 0.99
+
+// ===========INTERNAL DATA TYPES============
+
+struct workload {
+	const workload_profile *profile;
+	int keys; // Number of live keys, when no insert is pending.
+	int first; // Oldest live key.
+	int next; // Key of the next insert.
+	bool remove_next; // True if the next churn operation is a remove.
+	uint64_t state; // State of the random number generator.
+	// Constants of the Zipf distribution.
+	double zetan;
+	double alpha;
+	double eta;
+	double half_pow_theta;
+};
+
+static const workload_profile profiles[] = {
+	{ "read-only", 100, 0, 0, true },
+	{ "read-mostly", 95, 5, 0, true },
+	{ "update-heavy", 50, 50, 0, true },
+	{ "churn", 50, 0, 50, true },
+	{ "uniform", 95, 5, 0, false },
+};
+
+// ===========INTERNAL FUNCTION IMPLEMENTATIONS============
+
+/*
+ * Mix the bits of a 64-bit value with the splitmix64 finalizer.
+ */
+static uint64_t mix64(uint64_t x)
+{
+	x ^= x >> 30;
+	x *= 0xBF58476D1CE4E5B9ULL;
+	x ^= x >> 27;
+	x *= 0x94D049BB133111EBULL;
+	x ^= x >> 31;
+	return x;
+}
+
+/*
+ * Return the next 64 random bits, using splitmix64.
+ */
+static uint64_t next_random(workload *w)
+{
+	w->state += 0x9E3779B97F4A7C15ULL;
+	return mix64(w->state);
+}
+
+/*
+ * Return a random double in [0, 1).
+ */
+static double next_double(workload *w)
+{
+	return (double)(next_random(w) >> 11) * 0x1p-53;
+}
+
+/*
+ * Return zeta(n) = 1/1^theta + 1/2^theta + ... + 1/n^theta.
+ */
+static double zeta(int n, double theta)
+{
+	double sum = 0;
+	for (int i = 1; i <= n; i++) {
+		sum += 1 / pow(i, theta);
+	}
+	return sum;
+}
+
+/*
+ * Return a Zipf-distributed rank in [0, keys-1], rank 0 being the most
+ * popular.
+ */
+static int next_zipf_rank(workload *w)
+{
+	double u = next_double(w);
+	double uz = u * w->zetan;
+	if (uz < 1) {
+		return 0;
+	}
+	if (uz < 1 + w->half_pow_theta) {
+		return 1;
+	}
+	int rank = (int)(w->keys * pow(w->eta * u - w->eta + 1, w->alpha));
+	return rank < w->keys ? rank : w->keys - 1;
+}
+
+/*
+ * Return a live key drawn from the distribution of the profile.
+ */
+static int next_live_key(workload *w)
+{
+	int index;
+	if (w->profile->zipfian) {
+		index = (int)(mix64(next_zipf_rank(w)) % w->keys);
+	} else {
+		index = (int)(next_random(w) % w->keys);
+	}
+	// The live key in [first, first+keys-1] congruent to index.
+	int offset = (index - w->first % w->keys + w->keys) % w->keys;
+	return w->first + offset;
+}
+
+// ===========DATA STRUCTURE INTERFACE IMPLEMENTATION============
+
+/**
+ * workload_profile_get() - Get a built-in workload profile.
+ * @i: Index of the profile, from 0.
+ *
+ * Return: The profile, or NULL if i is not less than the number of
+ * profiles.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+const workload_profile *workload_profile_get(int i)
+{
+	if (i < 0 || i >= (int)(sizeof(profiles) / sizeof(profiles[0]))) {
+		return NULL;
+	}
+	return &profiles[i];
+}
+
+/**
+ * workload_profile_find() - Find a built-in workload profile by name.
+ * @name: Name of the profile.
+ *
+ * Return: The profile, or NULL if there is no profile with that name.
+ * Simplified asymptotic complexity analysis : O(profiles)
+ */
+const workload_profile *workload_profile_find(const char *name)
+{
+	const workload_profile *p;
+	for (int i = 0; (p = workload_profile_get(i)) != NULL; i++) {
+		if (strcmp(p->name, name) == 0) {
+			return p;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * workload_empty() - Create a workload generator.
+ * @profile: Profile of the workload.
+ * @keys: Number of keys in the table when the workload starts.
+ * @seed: Seed of the random number generator.
+ *
+ * Return: Pointer to a new generator, or NULL if not enough memory was
+ * available.
+ * Simplified asymptotic complexity analysis : O(keys) for a Zipfian
+ * profile, O(1) otherwise
+ */
+workload *workload_empty(const workload_profile *profile, int keys,
+			 uint64_t seed)
+{
+	workload *w = calloc(1, sizeof(*w));
+	if (w == NULL) {
+		return NULL;
+	}
+	w->profile = profile;
+	w->keys = keys;
+	w->first = 0;
+	w->next = keys;
+	w->state = seed;
+	if (profile->zipfian) {
+		double zeta2 = zeta(2, ZIPF_THETA);
+		w->zetan = zeta(keys, ZIPF_THETA);
+		w->alpha = 1 / (1 - ZIPF_THETA);
+		w->eta = (1 - pow(2.0 / keys, 1 - ZIPF_THETA)) /
+			 (1 - zeta2 / w->zetan);
+		w->half_pow_theta = pow(0.5, ZIPF_THETA);
+	}
+	return w;
+}
+
+/**
+ * workload_next() - Get the next operation of a workload.
+ * @w: Generator to use.
+ *
+ * Return: The next operation.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+workload_op workload_next(workload *w)
+{
+	workload_op op;
+	int r = (int)(next_random(w) % 100);
+	if (r < w->profile->read_percent) {
+		op.type = WORKLOAD_READ;
+		op.key = next_live_key(w);
+	} else if (r < w->profile->read_percent + w->profile->update_percent) {
+		op.type = WORKLOAD_UPDATE;
+		op.key = next_live_key(w);
+	} else if (w->remove_next) {
+		op.type = WORKLOAD_REMOVE;
+		op.key = w->first++;
+		w->remove_next = false;
+	} else {
+		op.type = WORKLOAD_INSERT;
+		op.key = w->next++;
+		w->remove_next = true;
+	}
+	return op;
+}
+
+/**
+ * workload_kill() - Destroy a workload generator.
+ * @w: Generator to destroy.
+ *
+ * Returns: Nothing.
+ * Simplified asymptotic complexity analysis : O(1)
+ */
+void workload_kill(workload *w)
+{
+	free(w);
+}